@@ -0,0 +1,112 @@
+/**
+ * @file async_build_test.cpp
+ * @brief Regression test for paths edited with VG_TESSELLATION_ASYNC_MNK on.
+ *
+ * Drawing only one paint mode of an edited path must leave the other one
+ * dirty, so its next draw or vgPathBounds rebuilds it.
+ */
+
+// MonkVG OpenVG interface
+#include <MonkVG/openvg.h>
+#include <MonkVG/vgext.h>
+
+// headless OpenGL
+#include "headless.h"
+
+// System
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#define SURFACE_WIDTH  256
+#define SURFACE_HEIGHT 256
+
+void appendSquare(VGPath path, VGfloat size) {
+    const VGubyte segments[] = {VG_MOVE_TO_ABS, VG_LINE_TO_ABS, VG_LINE_TO_ABS,
+                                VG_LINE_TO_ABS, VG_CLOSE_PATH};
+    const VGfloat coords[]   = {0, 0, size, 0, size, size, 0, size};
+    vgAppendPathData(path, 5, segments, coords);
+}
+
+VGPath createSquare(VGfloat size) {
+    VGPath path = vgCreatePath(VG_PATH_FORMAT_STANDARD, VG_PATH_DATATYPE_F, 1,
+                               0, 0, 0, VG_PATH_CAPABILITY_ALL);
+    appendSquare(path, size);
+    vgDrawPath(path, VG_FILL_PATH | VG_STROKE_PATH);
+    return path;
+}
+
+bool hasBounds(VGPath path, VGfloat size) {
+    VGfloat x, y, width, height;
+    vgPathBounds(path, &x, &y, &width, &height);
+    return x == 0 && y == 0 && width == size && height == size;
+}
+
+uint32_t readPixel(int x, int y) {
+    uint32_t pixel;
+    glFinish();
+    glReadPixels(x, y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, &pixel);
+    return pixel;
+}
+
+/// draws the path with paint_modes until the pixel changes from the clear
+/// color, giving the background build two seconds.
+bool drawsPixel(VGPath path, VGbitfield paint_modes, int x, int y) {
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start <
+           std::chrono::seconds(2)) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        vgDrawPath(path, paint_modes);
+        if (readPixel(x, y) != 0) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+int main(int argc, char **argv) {
+    if (!initHeadlessGL(SURFACE_WIDTH, SURFACE_HEIGHT))
+        return 1;
+    vgCreateContextMNK(SURFACE_WIDTH, SURFACE_HEIGHT,
+                       VG_RENDERING_BACKEND_TYPE_OPENGL33);
+    vgSeti(VG_TESSELLATION_ASYNC_MNK, VG_TRUE);
+    vgSetf(VG_STROKE_LINE_WIDTH, 4);
+    glClearColor(0, 0, 0, 0);
+
+    VGPaint paint    = vgCreatePaint();
+    VGfloat color[4] = {1, 0, 0, 1};
+    vgSetParameterfv(paint, VG_PAINT_COLOR, 4, color);
+    vgSetPaint(paint, VG_FILL_PATH | VG_STROKE_PATH);
+    vgSeti(VG_MATRIX_MODE, VG_MATRIX_PATH_USER_TO_SURFACE);
+    vgLoadIdentity();
+
+    // the fill stays dirty through a stroke draw
+    VGPath path = createSquare(10);
+    expect(hasBounds(path, 10), "fill built at 10x10");
+    appendSquare(path, 200);
+    vgDrawPath(path, VG_STROKE_PATH);
+    expect(hasBounds(path, 200),
+           "vgPathBounds rebuilds the fill after a stroke only draw");
+    vgDestroyPath(path);
+
+    path = createSquare(10);
+    appendSquare(path, 200);
+    vgDrawPath(path, VG_STROKE_PATH);
+    expect(drawsPixel(path, VG_FILL_PATH, 100, 100),
+           "fill draws 200x200 after a stroke only draw");
+    vgDestroyPath(path);
+
+    // and the stroke through a fill draw
+    path = createSquare(10);
+    appendSquare(path, 200);
+    vgDrawPath(path, VG_FILL_PATH);
+    expect(drawsPixel(path, VG_STROKE_PATH, 100, 200),
+           "stroke draws 200x200 after a fill only draw");
+    vgDestroyPath(path);
+
+    expect(vgGetError() == VG_NO_ERROR, "no VG error");
+    vgDestroyPaint(paint);
+    vgDestroyContextMNK();
+    return testResult();
+}
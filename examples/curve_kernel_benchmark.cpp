@@ -0,0 +1,271 @@
+/**
+ * @file curve_kernel_benchmark.cpp
+ * @brief Checks the batched curve and point transform kernels against plain
+ * scalar code and times both.
+ *
+ * evalQuadBezier, evalCubicBezier and evalEllipse evaluate several points
+ * at once with SSE2 or NEON where available, as does affineTransformPoints.
+ * Each is compared with a scalar evaluation of the same points: the per t
+ * calcQuadBezier1d and calcCubicBezier1d the flattener used before, cos and
+ * sin per angle, and a per point matrix multiply. Any point further apart
+ * than the tolerance fails the run. Then both are timed in million points
+ * per second on random curves, 1M transformed points and the tiger's
+ * flattening. Pass the curve steps, 64 by default. Uses the library
+ * internals, so it builds against the private headers.
+ */
+
+// MonkVG internals
+#include "mkCurves.h"
+#include "mkMath.h"
+#include "sweep-tessellator/sweepTessellator.h"
+#include "mkPath.h"
+
+// System
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Tiger Paths
+#include "tiger_paths.h"
+
+using namespace MonkVG;
+
+constexpr size_t  kCurves       = 10000;
+constexpr size_t  kPoints       = 1000000;
+constexpr int     kRuns         = 20;
+constexpr VGfloat kCoordRange   = 1000;
+constexpr VGfloat kMaxCurveDiff = 1e-5f; // relative to kCoordRange
+
+struct curve_t {
+    vertex_2d_t p[4];
+};
+
+std::vector<curve_t> randomCurves(std::mt19937 &rng) {
+    std::uniform_real_distribution<VGfloat> coord(-kCoordRange, kCoordRange);
+    std::vector<curve_t>                    curves(kCurves);
+    for (curve_t &curve : curves) {
+        for (vertex_2d_t &p : curve.p) {
+            p = {coord(rng), coord(rng)};
+        }
+    }
+    return curves;
+}
+
+/// median million points per second of run, which produces points points
+template <typename Run>
+double mpointsPerSecond(size_t points, Run run) {
+    std::vector<double> rates;
+    for (int i = 0; i < kRuns; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        const double seconds = std::chrono::duration<double>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count();
+        rates.push_back(points / seconds * 1e-6);
+    }
+    std::sort(rates.begin(), rates.end());
+    return rates[rates.size() / 2];
+}
+
+/// largest coordinate difference of two point arrays, infinite for a NaN
+double maxDifference(const VGfloat *a, const VGfloat *b, size_t count) {
+    double difference = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const double d = fabsf(a[i] - b[i]);
+        difference     = std::max(difference, d == d ? d : HUGE_VAL);
+    }
+    return difference;
+}
+
+void quadScalar(const curve_t &c, uint32_t steps, vertex_2d_t *out) {
+    for (uint32_t i = 1; i <= steps; ++i) {
+        const VGfloat t = VGfloat(i) / VGfloat(steps);
+        out[i - 1]      = {calcQuadBezier1d(c.p[0].x, c.p[1].x, c.p[2].x, t),
+                           calcQuadBezier1d(c.p[0].y, c.p[1].y, c.p[2].y, t)};
+    }
+}
+
+void cubicScalar(const curve_t &c, uint32_t steps, vertex_2d_t *out) {
+    for (uint32_t i = 1; i <= steps; ++i) {
+        const VGfloat t = VGfloat(i) / VGfloat(steps);
+        out[i - 1] = {
+            calcCubicBezier1d(c.p[0].x, c.p[1].x, c.p[2].x, c.p[3].x, t),
+            calcCubicBezier1d(c.p[0].y, c.p[1].y, c.p[2].y, c.p[3].y, t)};
+    }
+}
+
+/// the ellipse of a curve: center p0, axes p1 and p2, start and sweep from
+/// p3
+void ellipseScalar(const curve_t &c, uint32_t steps, vertex_2d_t *out) {
+    for (uint32_t i = 1; i <= steps; ++i) {
+        const double a = c.p[3].x + (double)c.p[3].y * i / steps;
+        out[i - 1]     = {(VGfloat)(c.p[0].x + c.p[1].x * cos(a) +
+                                    c.p[2].x * sin(a)),
+                          (VGfloat)(c.p[0].y + c.p[1].y * cos(a) +
+                                    c.p[2].y * sin(a))};
+    }
+}
+
+void ellipseKernel(const curve_t &c, uint32_t steps, vertex_2d_t *out) {
+    evalEllipse(c.p[0], c.p[1], c.p[2], c.p[3].x, c.p[3].y, steps, out);
+}
+
+void quadKernel(const curve_t &c, uint32_t steps, vertex_2d_t *out) {
+    evalQuadBezier(c.p[0], c.p[1], c.p[2], steps, out);
+}
+
+void cubicKernel(const curve_t &c, uint32_t steps, vertex_2d_t *out) {
+    evalCubicBezier(c.p[0], c.p[1], c.p[2], c.p[3], steps, out);
+}
+
+using eval_t = void (*)(const curve_t &, uint32_t, vertex_2d_t *);
+
+/// checks kernel against scalar on every curve and step counts around the
+/// SIMD width, then times both at steps. Returns false on a mismatch.
+bool compareCurves(const char *name, const std::vector<curve_t> &curves,
+                   eval_t scalar, eval_t kernel, uint32_t steps) {
+    std::vector<vertex_2d_t> a(std::max(steps, 9u)), b(a.size());
+    double                   difference = 0;
+    for (const curve_t &curve : curves) {
+        for (uint32_t n : {1u, 2u, 3u, 4u, 5u, 7u, 8u, 9u, steps}) {
+            scalar(curve, n, a.data());
+            kernel(curve, n, b.data());
+            difference = std::max(
+                difference, maxDifference(a[0].v, b[0].v, (size_t)n * 2));
+        }
+    }
+
+    const size_t points = curves.size() * steps;
+    std::vector<vertex_2d_t> out(points);
+    const double             before = mpointsPerSecond(points, [&] {
+        for (size_t i = 0; i < curves.size(); ++i)
+            scalar(curves[i], steps, &out[i * steps]);
+    });
+    const double             after  = mpointsPerSecond(points, [&] {
+        for (size_t i = 0; i < curves.size(); ++i)
+            kernel(curves[i], steps, &out[i * steps]);
+    });
+
+    const bool ok = difference <= kMaxCurveDiff * kCoordRange;
+    printf("%-10s scalar %7.1f Mpts/s, batched %7.1f Mpts/s, %.2fx, max "
+           "difference %.2g %s\n",
+           name, before, after, after / before, difference,
+           ok ? "ok" : "FAIL");
+    return ok;
+}
+
+/// affineTransformPoints against a per point multiply, including in place
+/// and odd counts. Then both are timed on kPoints points.
+bool compareTransform(std::mt19937 &rng) {
+    std::uniform_real_distribution<VGfloat> coord(-kCoordRange, kCoordRange);
+    std::vector<VGfloat>                    in(kPoints * 2);
+    for (VGfloat &c : in) {
+        c = coord(rng);
+    }
+    // rotated, sheared and translated
+    Matrix33 m;
+    m.setRotation(0.3f);
+    m.c += 0.4f;
+    m.setTranslate(12.5f, -3.25f);
+
+    std::vector<VGfloat> scalar(in.size()), batched(in.size());
+    auto                 transformScalar = [&](bool translate) {
+        const VGfloat e = translate ? m.e : 0, f = translate ? m.f : 0;
+        for (size_t i = 0; i < kPoints; ++i) {
+            const VGfloat x = in[i * 2], y = in[i * 2 + 1];
+            scalar[i * 2]     = m.a * x + m.c * y + e;
+            scalar[i * 2 + 1] = m.b * x + m.d * y + f;
+        }
+    };
+
+    const size_t counts[] = {1, 3, 5, 7, kPoints};
+    double       difference = 0;
+    for (bool translate : {true, false}) {
+        transformScalar(translate);
+        for (size_t count : counts) {
+            affineTransformPoints(m, translate, in.data(), count,
+                                  batched.data());
+            difference = std::max(difference,
+                                  maxDifference(scalar.data(), batched.data(),
+                                                count * 2));
+        }
+        batched = in;
+        affineTransformPoints(m, translate, batched.data(), kPoints - 1,
+                              batched.data());
+        difference = std::max(difference,
+                              maxDifference(scalar.data(), batched.data(),
+                                            (kPoints - 1) * 2));
+    }
+
+    const double before =
+        mpointsPerSecond(kPoints, [&] { transformScalar(true); });
+    const double after = mpointsPerSecond(kPoints, [&] {
+        affineTransformPoints(m, true, in.data(), kPoints, batched.data());
+    });
+
+    // the same operations in the same order, up to fused multiply adds
+    const bool ok = difference <= 1e-6 * kCoordRange * 4;
+    printf("%-10s scalar %7.1f Mpts/s, batched %7.1f Mpts/s, %.2fx, max "
+           "difference %.2g %s\n",
+           "transform", before, after, after / before, difference,
+           ok ? "ok" : "FAIL");
+    return ok;
+}
+
+/// million points per second flattening all tiger paths
+double flattenTiger(uint32_t steps) {
+    std::vector<std::vector<VGubyte>> segments(pathCount);
+    std::vector<path_coords_t>        coords(pathCount);
+    for (int i = 0; i < pathCount; ++i) {
+        size_t num_coords = 0;
+        for (int s = 0; s < commandCounts[i]; ++s) {
+            segments[i].push_back(commandArrays[i][s]);
+            num_coords += IPath::segmentToNumCoordinates(
+                (VGPathSegment)(commandArrays[i][s] & 0x1e));
+        }
+        coords[i].append(dataArrays[i], num_coords);
+    }
+
+    SweepTessellator tessellator;
+    flattened_path_t flattened;
+    size_t           points = 0;
+    for (int i = 0; i < pathCount; ++i) {
+        tessellator.flatten(segments[i], coords[i], steps, flattened);
+        points += flattened.points.size();
+    }
+    return mpointsPerSecond(points, [&] {
+        for (int i = 0; i < pathCount; ++i)
+            tessellator.flatten(segments[i], coords[i], steps, flattened);
+    });
+}
+
+int main(int argc, char **argv) {
+    const uint32_t steps =
+        argc > 1 ? (uint32_t)std::max(1, atoi(argv[1])) : 64;
+    std::mt19937         rng(11);
+    std::vector<curve_t> curves = randomCurves(rng);
+
+    // ellipses: center, two axes and a start angle and sweep in radians
+    std::vector<curve_t> ellipses = curves;
+    std::uniform_real_distribution<VGfloat> angle(-6.3f, 6.3f);
+    for (curve_t &ellipse : ellipses) {
+        ellipse.p[3] = {angle(rng), angle(rng)};
+    }
+
+    printf("%zu random curves of %u steps, %zu transformed points\n", kCurves,
+           steps, kPoints);
+    bool ok = true;
+    ok &= compareCurves("quad", curves, quadScalar, quadKernel, steps);
+    ok &= compareCurves("cubic", curves, cubicScalar, cubicKernel, steps);
+    ok &= compareCurves("ellipse", ellipses, ellipseScalar, ellipseKernel,
+                        steps);
+    ok &= compareTransform(rng);
+    printf("%-10s %7.1f Mpts/s flattened\n", "tiger", flattenTiger(steps));
+
+    printf("%s\n", ok ? "PASSED" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+/**
+ * @file fill_compare.cpp
+ * @brief Test that the sweep-line fill tessellator covers the same area as
+ * GLU.
+ *
+ * Renders every tiger path and random self intersecting polygons with both
+ * fill rules offscreen, once tessellated by VG_TESSELLATOR_GLU_MNK and once
+ * by VG_TESSELLATOR_SWEEP_MNK, and compares the covered pixels. A fill fails
+ * when the areas differ by more than 0.5%, or more than 0.02% of its pixels
+ * differ without a 1 pixel shift of an edge explaining them. Runs headless
+ * on an EGL surfaceless display.
+ */
+
+// MonkVG OpenVG interface
+#include <MonkVG/openvg.h>
+#include <MonkVG/vgext.h>
+
+// headless OpenGL
+#include "headless.h"
+
+// System
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Tiger Paths
+#include "tiger_paths.h"
+
+#define IMAGE_WIDTH  600
+#define IMAGE_HEIGHT 600
+
+/// path data for vgAppendPathData
+struct shape_t {
+    std::vector<VGubyte> segments;
+    std::vector<VGfloat> coords;
+};
+
+/// random polygons with up to 3 contours, mostly self intersecting. Every
+/// third one has its vertices on a coarse grid, so edges overlap and
+/// vertices coincide.
+std::vector<shape_t> createPolygons(int count) {
+    std::mt19937                          rng(7);
+    std::uniform_real_distribution<float> coord(20, IMAGE_WIDTH - 20);
+    std::vector<shape_t>                  shapes(count);
+    for (int i = 0; i < count; ++i) {
+        const bool grid     = i % 3 == 0;
+        const int  contours = 1 + rng() % 3;
+        for (int c = 0; c < contours; ++c) {
+            const int vertices = 3 + rng() % 30;
+            for (int v = 0; v < vertices; ++v) {
+                shapes[i].segments.push_back(v ? VG_LINE_TO_ABS
+                                               : VG_MOVE_TO_ABS);
+                for (int k = 0; k < 2; ++k) {
+                    shapes[i].coords.push_back(
+                        grid ? 20 + VGfloat(rng() % 8) * 70 : coord(rng));
+                }
+            }
+            shapes[i].segments.push_back(VG_CLOSE_PATH);
+        }
+    }
+    return shapes;
+}
+
+/// the fill of the path data in white on black
+std::vector<uint32_t> renderFill(VGTessellatorTypeMNK type,
+                                 const VGubyte *segments, int num_segments,
+                                 const VGfloat *coords) {
+    vgSeti(VG_TESSELLATOR_TYPE_MNK, type);
+    VGPath path = vgCreatePath(VG_PATH_FORMAT_STANDARD, VG_PATH_DATATYPE_F, 1,
+                               0, 0, 0, VG_PATH_CAPABILITY_ALL);
+    vgAppendPathData(path, num_segments, segments, coords);
+    glClear(GL_COLOR_BUFFER_BIT);
+    vgDrawPath(path, VG_FILL_PATH);
+    vgDestroyPath(path);
+
+    std::vector<uint32_t> image(IMAGE_WIDTH * IMAGE_HEIGHT);
+    glFinish();
+    glReadPixels(0, 0, IMAGE_WIDTH, IMAGE_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE,
+                 image.data());
+    return image;
+}
+
+/// true if the pixel value occurs within 1 pixel of (x, y) in image.
+bool hasNeighbor(const std::vector<uint32_t> &image, int x, int y,
+                 uint32_t value) {
+    for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, IMAGE_HEIGHT - 1);
+         ++ny) {
+        for (int nx = std::max(x - 1, 0);
+             nx <= std::min(x + 1, IMAGE_WIDTH - 1); ++nx) {
+            if (image[ny * IMAGE_WIDTH + nx] == value)
+                return true;
+        }
+    }
+    return false;
+}
+
+/// renders the fill with both tessellators and expects the same coverage.
+void compareFill(const char *name, int index, const VGubyte *segments,
+                 int num_segments, const VGfloat *coords) {
+    std::vector<uint32_t> glu = renderFill(VG_TESSELLATOR_GLU_MNK, segments,
+                                           num_segments, coords);
+    std::vector<uint32_t> sweep = renderFill(VG_TESSELLATOR_SWEEP_MNK,
+                                             segments, num_segments, coords);
+
+    int glu_area = 0, sweep_area = 0, unexplained = 0;
+    for (int y = 0; y < IMAGE_HEIGHT; ++y) {
+        for (int x = 0; x < IMAGE_WIDTH; ++x) {
+            uint32_t a = glu[y * IMAGE_WIDTH + x];
+            uint32_t b = sweep[y * IMAGE_WIDTH + x];
+            glu_area += a != 0;
+            sweep_area += b != 0;
+            if (a != b &&
+                (!hasNeighbor(sweep, x, y, a) || !hasNeighbor(glu, x, y, b)))
+                ++unexplained;
+        }
+    }
+
+    // a pixel center exactly on an edge may land on either side, or in the
+    // hairline gap where the sweep splits a long edge at a slab boundary a
+    // float rounding off its line. grid polygons hit a few of those.
+    const bool ok = std::abs(glu_area - sweep_area) <= glu_area / 200 &&
+                    unexplained <= glu_area / 5000;
+    // only report the failures, the tiger alone has 240 paths
+    if (!ok) {
+        expect(false,
+               "%s %d: GLU covers %d pixels, sweep %d, %d not explained by "
+               "a 1px edge shift",
+               name, index, glu_area, sweep_area, unexplained);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (!initHeadlessGL(IMAGE_WIDTH, IMAGE_HEIGHT))
+        return 1;
+    vgCreateContextMNK(IMAGE_WIDTH, IMAGE_HEIGHT,
+                       VG_RENDERING_BACKEND_TYPE_OPENGL33);
+    vgSeti(VG_TESSELLATION_CACHE_BUDGET_MNK, 0);
+
+    VGPaint fill     = vgCreatePaint();
+    VGfloat white[4] = {1, 1, 1, 1};
+    vgSetParameterfv(fill, VG_PAINT_COLOR, 4, white);
+    vgSetPaint(fill, VG_FILL_PATH);
+    glClearColor(0, 0, 0, 0);
+    vgSeti(VG_MATRIX_MODE, VG_MATRIX_PATH_USER_TO_SURFACE);
+
+    // the tiger is non zero, and fills the surface at this transform
+    vgSeti(VG_FILL_RULE, VG_NON_ZERO);
+    vgLoadIdentity();
+    vgScale(1.0f, -1.0f);
+    vgTranslate(240, -420);
+    int failures = test_failures;
+    for (int i = 0; i < pathCount; ++i) {
+        compareFill("tiger path", i, commandArrays[i], commandCounts[i],
+                    dataArrays[i]);
+    }
+    expect(test_failures == failures, "%d tiger paths cover the same area",
+           pathCount);
+
+    vgLoadIdentity();
+    std::vector<shape_t> polygons = createPolygons(200);
+    for (VGFillRule rule : {VG_EVEN_ODD, VG_NON_ZERO}) {
+        vgSeti(VG_FILL_RULE, rule);
+        failures = test_failures;
+        for (size_t i = 0; i < polygons.size(); ++i) {
+            compareFill(rule == VG_EVEN_ODD ? "even odd polygon"
+                                            : "non zero polygon",
+                        (int)i, polygons[i].segments.data(),
+                        (int)polygons[i].segments.size(),
+                        polygons[i].coords.data());
+        }
+        expect(test_failures == failures,
+               "%zu random polygons cover the same area with %s",
+               polygons.size(),
+               rule == VG_EVEN_ODD ? "VG_EVEN_ODD" : "VG_NON_ZERO");
+    }
+
+    expect(vgGetError() == VG_NO_ERROR, "no VG error");
+    vgDestroyPaint(fill);
+    vgDestroyContextMNK();
+    return testResult();
+}
@@ -0,0 +1,164 @@
+/**
+ * @file flatten_zoom_benchmark.cpp
+ * @brief Counts the vertices the tiger is flattened and filled into at
+ * several zoom levels, with fixed iterations and with
+ * VG_TESSELLATION_TOLERANCE_MNK.
+ *
+ * For every zoom the tiger's paths are flattened once with the default 16
+ * iterations per curve and once with a 0.25 pixel tolerance converted to
+ * user space like a drawn path does. Prints the outline points, the fill
+ * mesh vertices, and the largest distance in pixels from a 512 iteration
+ * reference outline to the flattened one. Uses the library internals, so
+ * it builds against the private headers.
+ */
+
+// MonkVG OpenVG interface
+#include <MonkVG/openvg.h>
+#include <MonkVG/vgext.h>
+
+// MonkVG internals
+#include "mkContext.h"
+
+// headless OpenGL
+#include "headless.h"
+
+// System
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Tiger Paths
+#include "tiger_paths.h"
+
+#define SURFACE_WIDTH  600
+#define SURFACE_HEIGHT 600
+
+using namespace MonkVG;
+
+/// distance from p to the line segment a b
+double segmentDistance(const vertex_2d_t &p, const vertex_2d_t &a,
+                       const vertex_2d_t &b) {
+    const double dx = b.x - a.x, dy = b.y - a.y;
+    const double length2 = dx * dx + dy * dy;
+    const double along = (p.x - a.x) * dx + (p.y - a.y) * dy;
+    const double t = length2 > 0 ? std::clamp(along / length2, 0.0, 1.0) : 0;
+    return std::hypot(a.x + t * dx - p.x, a.y + t * dy - p.y);
+}
+
+/// largest distance from a reference point to the flattened outline of its
+/// contour, in user space. Both outlines run the same way, so the segment
+/// closest to a reference point is searched near the one closest to the
+/// point before, which keeps this linear.
+double maxError(const flattened_path_t &path,
+                const flattened_path_t &reference) {
+    const uint32_t kWindow = 16;
+
+    double error = 0;
+    if (path.contours.size() != reference.contours.size()) {
+        return error;
+    }
+    for (size_t c = 0; c < path.contours.size(); ++c) {
+        const contour_t &contour = path.contours[c];
+        const contour_t &ref     = reference.contours[c];
+        if (contour.count < 2) {
+            continue;
+        }
+        uint32_t closest = 0;
+        for (uint32_t k = 0; k < ref.count; ++k) {
+            const vertex_2d_t &p = reference.points[ref.first + k];
+            const uint32_t     first =
+                closest > kWindow ? closest - kWindow : 0;
+            const uint32_t last =
+                std::min(closest + kWindow, contour.count - 2);
+            double best = HUGE_VAL;
+            for (uint32_t j = first; j <= last; ++j) {
+                const double distance =
+                    segmentDistance(p, path.points[contour.first + j],
+                                    path.points[contour.first + j + 1]);
+                if (distance < best) {
+                    best    = distance;
+                    closest = j;
+                }
+            }
+            error = std::max(error, best);
+        }
+    }
+    return error;
+}
+
+struct tiger_path_t {
+    std::vector<VGubyte> segments;
+    path_coords_t        coords;
+};
+
+std::vector<tiger_path_t> loadTiger() {
+    std::vector<tiger_path_t> tiger(pathCount);
+    for (int i = 0; i < pathCount; ++i) {
+        size_t num_coords = 0;
+        for (int s = 0; s < commandCounts[i]; ++s) {
+            const VGubyte segment = commandArrays[i][s];
+            tiger[i].segments.push_back(segment);
+            num_coords += IPath::segmentToNumCoordinates(
+                (VGPathSegment)(segment & 0x1e));
+        }
+        tiger[i].coords.append(dataArrays[i], num_coords);
+    }
+    return tiger;
+}
+
+int main(int argc, char **argv) {
+    if (!initHeadlessGL(SURFACE_WIDTH, SURFACE_HEIGHT))
+        return 1;
+    vgCreateContextMNK(SURFACE_WIDTH, SURFACE_HEIGHT,
+                       VG_RENDERING_BACKEND_TYPE_OPENGL33);
+    vgSeti(VG_MATRIX_MODE, VG_MATRIX_PATH_USER_TO_SURFACE);
+    vgSetf(VG_TESSELLATION_TOLERANCE_MNK, 0.25f);
+
+    IContext                 &context     = IContext::instance();
+    ITessellator             &tessellator = context.getTessellator();
+    std::vector<tiger_path_t> tiger       = loadTiger();
+    flattened_path_t          flattened, reference;
+    indexed_mesh_t            mesh;
+
+    printf("tiger, %d paths\n", pathCount);
+    printf("zoom   flattening        points  fill vertices  max error\n");
+    for (VGfloat zoom : {0.25f, 1.0f, 4.0f, 16.0f, 64.0f}) {
+        vgLoadIdentity();
+        vgScale(zoom, zoom);
+        const VGfloat tolerance = context.getPathTessellationTolerance(0);
+
+        for (int mode = 0; mode < 2; ++mode) {
+            size_t points = 0, vertices = 0;
+            double error  = 0;
+            for (const tiger_path_t &path : tiger) {
+                tessellator.setTolerance(0);
+                tessellator.flatten(path.segments, path.coords, 512,
+                                    reference);
+
+                tessellator.setTolerance(mode ? tolerance : 0);
+                tessellator.flatten(path.segments, path.coords, 16,
+                                    flattened);
+                bounding_box_t bounds;
+                tessellator.tessellateIndexed(flattened, VG_NON_ZERO, mesh,
+                                              bounds);
+                points += flattened.points.size();
+                vertices += mesh.vertexCount();
+                error = std::max(error, maxError(flattened, reference));
+            }
+            printf("%5.2f  %-16s %7zu  %13zu  %6.2f px\n", zoom,
+                   mode ? "tolerance 0.25px" : "16 iterations", points,
+                   vertices, error * zoom);
+        }
+    }
+    tessellator.setTolerance(0);
+
+    vgDestroyContextMNK();
+
+    VGErrorCode error = vgGetError();
+    if (error != VG_NO_ERROR) {
+        fprintf(stderr, "VG error 0x%x\n", error);
+        return 1;
+    }
+    return 0;
+}
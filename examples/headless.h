@@ -0,0 +1,89 @@
+/**
+ * @file headless.h
+ * @brief OpenGL 3.3 context without a window for the tests and benchmarks.
+ *
+ * Uses an EGL surfaceless display, e.g. Mesa llvmpipe with
+ * LIBGL_ALWAYS_SOFTWARE=1, and renders into an offscreen color buffer.
+ */
+#ifndef __HEADLESS_H__
+#define __HEADLESS_H__
+
+// headless OpenGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#define GL_GLEXT_PROTOTYPES 1
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+// System
+#include <cstdarg>
+#include <cstdio>
+
+inline bool initHeadlessGL(int width, int height) {
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)
+        eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (!getPlatformDisplay) {
+        fprintf(stderr, "eglGetPlatformDisplayEXT not available\n");
+        return false;
+    }
+    EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                            EGL_DEFAULT_DISPLAY, nullptr);
+    EGLint     major, minor;
+    if (!eglInitialize(display, &major, &minor) ||
+        !eglBindAPI(EGL_OPENGL_API)) {
+        fprintf(stderr, "Failed to initialize EGL\n");
+        return false;
+    }
+
+    const EGLint attribs[] = {EGL_CONTEXT_MAJOR_VERSION,
+                              3,
+                              EGL_CONTEXT_MINOR_VERSION,
+                              3,
+                              EGL_CONTEXT_OPENGL_PROFILE_MASK,
+                              EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                              EGL_NONE};
+    EGLContext   context =
+        eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attribs);
+    if (context == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        fprintf(stderr, "Failed to create an OpenGL 3.3 context\n");
+        return false;
+    }
+
+    // render into an offscreen color buffer
+    GLuint fbo, rbo;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glGenRenderbuffers(1, &rbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                              GL_RENDERBUFFER, rbo);
+    glViewport(0, 0, width, height);
+    return true;
+}
+
+/// failed expect() calls so far. a test returns testResult() from main.
+inline int test_failures = 0;
+
+/// prints the printf style message, marked as failed unless ok.
+inline bool expect(bool ok, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    printf("%s ", ok ? "ok  " : "FAIL");
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+    if (!ok) {
+        ++test_failures;
+    }
+    return ok;
+}
+
+inline int testResult() {
+    printf("%s: %d failed\n", test_failures ? "FAILED" : "PASSED",
+           test_failures);
+    return test_failures ? 1 : 0;
+}
+
+#endif
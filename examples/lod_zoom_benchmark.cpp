@@ -0,0 +1,147 @@
+/**
+ * @file lod_zoom_benchmark.cpp
+ * @brief Zooms the tiger in and out with VG_TESSELLATION_TOLERANCE_MNK and
+ * several VG_TESSELLATION_LOD_BUDGET_MNK sizes.
+ *
+ * Every frame clears and draws the fills and strokes of all tiger paths at
+ * the next zoom of a sweep from 0.25x to 16x and back, geometric so every
+ * octave gets the same frames. Fixed iterations are drawn first for
+ * comparison. For each setting prints the frame time, the fill
+ * tessellations and level of detail hits over the sweep, and the triangles
+ * drawn per frame with vertices drawn per second, counted with a
+ * GL_PRIMITIVES_GENERATED query. The tessellation cache is off. Pass the
+ * frames, 2000 by default.
+ */
+
+// MonkVG OpenVG interface
+#include <MonkVG/openvg.h>
+#include <MonkVG/vgext.h>
+
+// headless OpenGL
+#include "headless.h"
+
+// System
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Tiger Paths
+#include "tiger_paths.h"
+
+#define SURFACE_WIDTH  600
+#define SURFACE_HEIGHT 600
+
+constexpr VGfloat kMinZoom = 0.25f;
+constexpr VGfloat kMaxZoom = 16.0f;
+
+/// fills built by any of the fill paths
+VGint fillTessellations() {
+    return vgGeti(VG_TESSELLATION_CONVEX_FILLS_MNK) +
+           vgGeti(VG_TESSELLATION_SIMPLE_FILLS_MNK) +
+           vgGeti(VG_TESSELLATION_GENERAL_FILLS_MNK) +
+           vgGeti(VG_TESSELLATION_SHAPE_FILLS_MNK);
+}
+
+/// the zoom of frame out of frames, 0.25x at the ends and 16x in the middle
+VGfloat frameZoom(int frame, int frames) {
+    const double half  = frames / 2.0;
+    const double along = 1 - fabs(frame - half) / half;
+    return (VGfloat)(kMinZoom * pow(kMaxZoom / kMinZoom, along));
+}
+
+/// recreates the tiger, so every setting starts from unbuilt paths
+void loadScene(std::vector<VGPath> &paths) {
+    for (VGPath path : paths)
+        vgDestroyPath(path);
+    paths.clear();
+    for (int i = 0; i < pathCount; ++i) {
+        paths.push_back(vgCreatePath(VG_PATH_FORMAT_STANDARD,
+                                     VG_PATH_DATATYPE_F, 1, 0, 0, 0,
+                                     VG_PATH_CAPABILITY_ALL));
+        vgAppendPathData(paths[i], commandCounts[i], commandArrays[i],
+                         dataArrays[i]);
+    }
+}
+
+/// draws the sweep and prints one line of results
+void zoomSweep(const char *name, VGfloat tolerance, VGint lod_budget,
+               std::vector<VGPath> &paths, int frames) {
+    vgSetf(VG_TESSELLATION_TOLERANCE_MNK, tolerance);
+    vgSeti(VG_TESSELLATION_LOD_BUDGET_MNK, lod_budget);
+    loadScene(paths);
+
+    GLuint query;
+    glGenQueries(1, &query);
+    const VGint fills  = fillTessellations();
+    const VGint hits   = vgGeti(VG_TESSELLATION_LOD_HITS_MNK);
+    GLuint64    primitives = 0;
+    auto        start  = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        const VGfloat zoom = frameZoom(frame, frames);
+        vgClear(0, 0, SURFACE_WIDTH, SURFACE_HEIGHT);
+        vgLoadIdentity();
+        vgTranslate(SURFACE_WIDTH / 2, SURFACE_HEIGHT / 2);
+        vgScale(zoom, -zoom);
+        vgTranslate(-240, -420);
+
+        glBeginQuery(GL_PRIMITIVES_GENERATED, query);
+        for (VGPath path : paths)
+            vgDrawPath(path, VG_FILL_PATH | VG_STROKE_PATH);
+        glEndQuery(GL_PRIMITIVES_GENERATED);
+
+        GLuint64 frame_primitives = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &frame_primitives);
+        primitives += frame_primitives;
+    }
+    glFinish();
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+            .count();
+    glDeleteQueries(1, &query);
+
+    printf("%-18s %7.2f ms  %8d  %8d  %9.0f  %8.1f\n", name,
+           seconds * 1e3 / frames, fillTessellations() - fills,
+           vgGeti(VG_TESSELLATION_LOD_HITS_MNK) - hits,
+           (double)primitives / frames, primitives * 3 / seconds * 1e-6);
+}
+
+int main(int argc, char **argv) {
+    const int frames = argc > 1 ? std::max(2, atoi(argv[1])) : 2000;
+    if (!initHeadlessGL(SURFACE_WIDTH, SURFACE_HEIGHT))
+        return 1;
+    vgCreateContextMNK(SURFACE_WIDTH, SURFACE_HEIGHT,
+                       VG_RENDERING_BACKEND_TYPE_OPENGL33);
+    vgSeti(VG_TESSELLATION_CACHE_BUDGET_MNK, 0);
+
+    VGPaint paint    = vgCreatePaint();
+    VGfloat color[4] = {0.8f, 0.4f, 0.1f, 1};
+    vgSetParameterfv(paint, VG_PAINT_COLOR, 4, color);
+    vgSetPaint(paint, VG_FILL_PATH | VG_STROKE_PATH);
+    vgSetf(VG_STROKE_LINE_WIDTH, 1);
+    vgSeti(VG_MATRIX_MODE, VG_MATRIX_PATH_USER_TO_SURFACE);
+
+    printf("tiger, %d paths, %d frames zooming %.2fx to %.0fx and back\n",
+           pathCount, frames, kMinZoom, kMaxZoom);
+    printf("%-18s %10s  %8s  %8s  %9s  %8s\n", "", "per frame", "fills",
+           "LOD hits", "triangles", "Mverts/s");
+    std::vector<VGPath> paths;
+    zoomSweep("16 iterations", 0, 0, paths, frames);
+    zoomSweep("tolerance, no LOD", 0.25f, 0, paths, frames);
+    zoomSweep("tolerance, 64KB", 0.25f, 64 * 1024, paths, frames);
+    zoomSweep("tolerance, 256KB", 0.25f, 256 * 1024, paths, frames);
+
+    for (VGPath path : paths)
+        vgDestroyPath(path);
+    vgDestroyPaint(paint);
+    vgDestroyContextMNK();
+
+    VGErrorCode error = vgGetError();
+    if (error != VG_NO_ERROR) {
+        fprintf(stderr, "VG error 0x%x\n", error);
+        return 1;
+    }
+    return 0;
+}
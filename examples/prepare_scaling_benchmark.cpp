@@ -0,0 +1,170 @@
+/**
+ * @file prepare_scaling_benchmark.cpp
+ * @brief Times the parallel path build behind vgPrepareDrawPathsMNK on 1,
+ * 2, 4 ... threads.
+ *
+ * The scene is 4 copies of the tiger, 960 paths. Every run re-appends the
+ * path data untimed, then times building the fills and strokes of all
+ * paths on a thread pool with one tessellator per thread, the way
+ * vgPrepareDrawPathsMNK does before it uploads. The thread counts go up to
+ * the hardware threads, or to the second argument. The first argument is
+ * the number of runs, 20 by default. Last, vgPrepareDrawPathsMNK itself is
+ * timed with its upload and the context's tessellator, on all paths at once
+ * and path by path, which does not use the pool.
+ * Uses the library internals, so it builds against the private headers.
+ */
+
+// MonkVG OpenVG interface
+#include <MonkVG/openvg.h>
+#include <MonkVG/vgext.h>
+
+// headless OpenGL, first so the GL headers get the prototypes it needs
+#include "headless.h"
+
+// MonkVG internals
+#include "mkContext.h"
+#include "mkThreadPool.h"
+#include "glu-tessellator/gluTessellator.h"
+#include "sweep-tessellator/sweepTessellator.h"
+
+// System
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Tiger Paths
+#include "tiger_paths.h"
+
+#define SURFACE_WIDTH  600
+#define SURFACE_HEIGHT 600
+
+using namespace MonkVG;
+
+constexpr int kSceneCopies = 4;
+
+void reloadScene(const std::vector<VGPath> &paths) {
+    for (size_t i = 0; i < paths.size(); ++i) {
+        const int tiger = (int)(i % pathCount);
+        vgClearPath(paths[i], VG_PATH_CAPABILITY_ALL);
+        vgAppendPathData(paths[i], commandCounts[tiger], commandArrays[tiger],
+                         dataArrays[tiger]);
+    }
+}
+
+double median(std::vector<double> &times) {
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+std::unique_ptr<ITessellator> createTessellator(VGTessellatorTypeMNK type) {
+    if (type == VG_TESSELLATOR_GLU_MNK) {
+        return std::make_unique<GLUTessellator>();
+    }
+    return std::make_unique<SweepTessellator>();
+}
+
+/// median milliseconds to build every path's fill and stroke on threads
+double timeBuild(VGTessellatorTypeMNK type, const std::vector<VGPath> &paths,
+                 uint32_t threads, int runs) {
+    ThreadPool                                 pool(threads);
+    std::vector<std::unique_ptr<ITessellator>> tessellators;
+    for (uint32_t t = 0; t < pool.getThreadCount(); ++t) {
+        tessellators.push_back(createTessellator(type));
+    }
+
+    std::vector<double> times;
+    for (int run = 0; run < runs; ++run) {
+        reloadScene(paths);
+        auto start = std::chrono::steady_clock::now();
+        pool.parallelFor(paths.size(), [&](size_t i, uint32_t thread) {
+            IPath *path = (IPath *)paths[i];
+            path->buildFillIfDirty(*tessellators[thread]);
+            path->buildStrokeIfDirty(*tessellators[thread]);
+        });
+        times.push_back(std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start)
+                            .count());
+    }
+    return median(times);
+}
+
+/// median milliseconds of vgPrepareDrawPathsMNK on all paths, or on one
+/// path at a time, which builds on the calling thread only
+double timePrepare(const std::vector<VGPath> &paths, bool together,
+                   int runs) {
+    std::vector<double> times;
+    for (int run = 0; run < runs; ++run) {
+        reloadScene(paths);
+        auto start = std::chrono::steady_clock::now();
+        if (together) {
+            vgPrepareDrawPathsMNK((VGint)paths.size(), paths.data(),
+                                  VG_FILL_PATH | VG_STROKE_PATH);
+        } else {
+            for (const VGPath &path : paths) {
+                vgPrepareDrawPathsMNK(1, &path,
+                                      VG_FILL_PATH | VG_STROKE_PATH);
+            }
+        }
+        times.push_back(std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start)
+                            .count());
+    }
+    return median(times);
+}
+
+int main(int argc, char **argv) {
+    const int      runs = argc > 1 ? std::max(1, atoi(argv[1])) : 20;
+    const uint32_t hardware =
+        std::max(1u, std::thread::hardware_concurrency());
+    const uint32_t max_threads =
+        argc > 2 ? (uint32_t)std::max(1, atoi(argv[2])) : hardware;
+    if (!initHeadlessGL(SURFACE_WIDTH, SURFACE_HEIGHT))
+        return 1;
+    vgCreateContextMNK(SURFACE_WIDTH, SURFACE_HEIGHT,
+                       VG_RENDERING_BACKEND_TYPE_OPENGL33);
+
+    std::vector<VGPath> paths;
+    for (int i = 0; i < kSceneCopies * pathCount; ++i) {
+        paths.push_back(vgCreatePath(VG_PATH_FORMAT_STANDARD,
+                                     VG_PATH_DATATYPE_F, 1, 0, 0, 0,
+                                     VG_PATH_CAPABILITY_ALL));
+    }
+
+    printf("%zu paths, fill and stroke, %u hardware threads, median of %d "
+           "runs\n",
+           paths.size(), hardware, runs);
+    for (VGTessellatorTypeMNK type :
+         {VG_TESSELLATOR_GLU_MNK, VG_TESSELLATOR_SWEEP_MNK}) {
+        const char *name = type == VG_TESSELLATOR_GLU_MNK ? "GLU" : "sweep";
+        double      one_thread = 0;
+        for (uint32_t threads = 1; threads <= max_threads; threads *= 2) {
+            const double ms = timeBuild(type, paths, threads, runs);
+            if (threads == 1) {
+                one_thread = ms;
+            }
+            printf("%-5s %2u threads: %7.2f ms, %.2fx\n", name, threads, ms,
+                   one_thread / ms);
+        }
+    }
+
+    const double serial   = timePrepare(paths, false, runs);
+    const double prepared = timePrepare(paths, true, runs);
+    printf("vgPrepareDrawPathsMNK, path by path: %7.2f ms\n", serial);
+    printf("vgPrepareDrawPathsMNK, all paths:    %7.2f ms, %.2fx\n", prepared,
+           serial / prepared);
+
+    for (VGPath path : paths)
+        vgDestroyPath(path);
+    vgDestroyContextMNK();
+
+    VGErrorCode error = vgGetError();
+    if (error != VG_NO_ERROR) {
+        fprintf(stderr, "VG error 0x%x\n", error);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file shape_benchmark.cpp
+ * @brief Times a dashboard of 10k filled round rects drawn as VGU
+ * primitives and as plain paths.
+ *
+ * The primitives are made with vguRoundRect, which the OpenGL backend draws
+ * from a mesh of rounded corners shared by every round rect with the same
+ * segments. The plain paths are the same round rects copied with
+ * vgTransformPath by the identity, which flattens and fills their arcs
+ * into a mesh per path. For each prints the first frame, which builds and
+ * uploads every fill, then the median frame with a fixed transform and
+ * with VG_TESSELLATION_TOLERANCE_MNK while zooming, which rebuilds the
+ * fills whose corners need other segments. Triangles per frame are
+ * counted with a GL_PRIMITIVES_GENERATED query. Rasterization is off with
+ * GL_RASTERIZER_DISCARD, so a software renderer's fill rate, the same for
+ * both, does not hide the building, uploading and drawing. Pass the
+ * frames, 100 by default.
+ */
+
+// MonkVG OpenVG interface
+#include <MonkVG/openvg.h>
+#include <MonkVG/vgext.h>
+#include <MonkVG/vgu.h>
+
+// headless OpenGL
+#include "headless.h"
+
+// System
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#define SURFACE_WIDTH  600
+#define SURFACE_HEIGHT 600
+
+constexpr int kShapes = 10000;
+
+/// random round rects of 10 to 60 pixels with corners up to half their size
+std::vector<VGPath> createDashboard(bool primitives) {
+    std::mt19937                          rng(9);
+    std::uniform_real_distribution<float> unit(0, 1);
+    std::vector<VGPath>                   paths;
+    VGPath rect = vgCreatePath(VG_PATH_FORMAT_STANDARD, VG_PATH_DATATYPE_F, 1,
+                               0, 0, 0, VG_PATH_CAPABILITY_ALL);
+    vgLoadIdentity(); // vgTransformPath copies through the matrix
+    for (int i = 0; i < kShapes; ++i) {
+        const VGfloat width  = 10 + unit(rng) * 50;
+        const VGfloat height = 10 + unit(rng) * 50;
+        const VGfloat arc    = unit(rng) * std::min(width, height) / 2;
+        const VGfloat x      = unit(rng) * (SURFACE_WIDTH - width);
+        const VGfloat y      = unit(rng) * (SURFACE_HEIGHT - height);
+        VGPath path = vgCreatePath(VG_PATH_FORMAT_STANDARD, VG_PATH_DATATYPE_F,
+                                   1, 0, 0, 0, VG_PATH_CAPABILITY_ALL);
+        if (primitives) {
+            vguRoundRect(path, x, y, width, height, arc, arc);
+        } else {
+            vgClearPath(rect, VG_PATH_CAPABILITY_ALL);
+            vguRoundRect(rect, x, y, width, height, arc, arc);
+            vgTransformPath(path, rect);
+        }
+        paths.push_back(path);
+    }
+    vgDestroyPath(rect);
+    return paths;
+}
+
+/// milliseconds to draw the paths at zoom, with the triangles drawn
+double drawFrame(const std::vector<VGPath> &paths, VGfloat zoom,
+                 GLuint query, GLuint64 &triangles) {
+    auto start = std::chrono::steady_clock::now();
+    vgClear(0, 0, SURFACE_WIDTH, SURFACE_HEIGHT);
+    vgLoadIdentity();
+    vgTranslate(-SURFACE_WIDTH / 2, -SURFACE_HEIGHT / 2);
+    vgScale(zoom, zoom);
+    vgTranslate(SURFACE_WIDTH / 2, SURFACE_HEIGHT / 2);
+    glBeginQuery(GL_PRIMITIVES_GENERATED, query);
+    for (VGPath path : paths)
+        vgDrawPath(path, VG_FILL_PATH);
+    glEndQuery(GL_PRIMITIVES_GENERATED);
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &triangles);
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+/// median milliseconds of frames, zooming from 1x to 4x if zooming
+double medianFrame(const std::vector<VGPath> &paths, int frames, bool zoom,
+                   GLuint query, GLuint64 &triangles) {
+    std::vector<double> times;
+    for (int frame = 0; frame < frames; ++frame) {
+        const VGfloat scale = zoom ? powf(4, (VGfloat)frame / frames) : 1;
+        times.push_back(drawFrame(paths, scale, query, triangles));
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+/// draws the dashboard and prints one line of results
+void dashboard(const char *name, bool primitives, int frames) {
+    vgSetf(VG_TESSELLATION_TOLERANCE_MNK, 0);
+    std::vector<VGPath> paths = createDashboard(primitives);
+
+    GLuint query;
+    glGenQueries(1, &query);
+    GLuint64     triangles = 0;
+    const double first     = drawFrame(paths, 1, query, triangles);
+    const double still     = medianFrame(paths, frames, false, query,
+                                         triangles);
+    vgSetf(VG_TESSELLATION_TOLERANCE_MNK, 0.25f);
+    GLuint64     zoom_triangles = 0;
+    const double zooming =
+        medianFrame(paths, frames, true, query, zoom_triangles);
+    glDeleteQueries(1, &query);
+
+    printf("%-11s %8.2f ms  %8.2f ms  %9llu  %8.2f ms  %9llu\n", name, first,
+           still, (unsigned long long)triangles, zooming,
+           (unsigned long long)zoom_triangles);
+    for (VGPath path : paths)
+        vgDestroyPath(path);
+}
+
+int main(int argc, char **argv) {
+    const int frames = argc > 1 ? std::max(1, atoi(argv[1])) : 100;
+    if (!initHeadlessGL(SURFACE_WIDTH, SURFACE_HEIGHT))
+        return 1;
+    vgCreateContextMNK(SURFACE_WIDTH, SURFACE_HEIGHT,
+                       VG_RENDERING_BACKEND_TYPE_OPENGL33);
+    vgSeti(VG_TESSELLATION_CACHE_BUDGET_MNK, 0);
+
+    VGPaint paint    = vgCreatePaint();
+    VGfloat color[4] = {0.2f, 0.5f, 0.8f, 0.5f};
+    vgSetParameterfv(paint, VG_PAINT_COLOR, 4, color);
+    vgSetPaint(paint, VG_FILL_PATH);
+    vgSeti(VG_MATRIX_MODE, VG_MATRIX_PATH_USER_TO_SURFACE);
+    glEnable(GL_RASTERIZER_DISCARD);
+
+    printf("%d round rects, median of %d frames\n", kShapes, frames);
+    printf("%-11s %11s  %11s  %9s  %11s  %9s\n", "", "first", "still",
+           "triangles", "zooming", "triangles");
+    dashboard("primitives", true, frames);
+    dashboard("paths", false, frames);
+
+    vgDestroyPaint(paint);
+    vgDestroyContextMNK();
+
+    VGErrorCode error = vgGetError();
+    if (error != VG_NO_ERROR) {
+        fprintf(stderr, "VG error 0x%x\n", error);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,242 @@
+/**
+ * @file shape_compare.cpp
+ * @brief Test that round rects and ellipses drawn from the shared round
+ * shape mesh cover the same pixels as their path.
+ *
+ * Renders random vguRoundRect and vguEllipse primitives offscreen, once as
+ * the primitive, which the OpenGL backend draws from a mesh of rounded
+ * corners shared by every shape with the same segments, and once copied
+ * into a plain path with vgTransformPath by the identity, which drops the
+ * primitive and flattens and fills its arcs. Both are drawn with fixed
+ * iterations and with VG_TESSELLATION_TOLERANCE_MNK, upright and rotated
+ * and sheared, and with a stroke over the fill. A shape fails when the
+ * areas differ by more than 1%, or more than 0.1% of its pixels differ
+ * without a 1 pixel shift of an edge explaining them. The primitives'
+ * vgPathBounds must be their rects. Runs headless on an EGL surfaceless
+ * display.
+ */
+
+// MonkVG OpenVG interface
+#include <MonkVG/openvg.h>
+#include <MonkVG/vgext.h>
+#include <MonkVG/vgu.h>
+
+// headless OpenGL
+#include "headless.h"
+
+// System
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#define IMAGE_WIDTH  600
+#define IMAGE_HEIGHT 600
+
+/// a vguRoundRect, or a vguEllipse centered on x, y
+struct shape_t {
+    bool    ellipse = false;
+    VGfloat x = 0, y = 0, width = 0, height = 0;
+    VGfloat arc_width = 0, arc_height = 0;
+};
+
+/// random shapes from a few pixels to most of the image. Some corners are
+/// larger than the rect, which vguRoundRect clamps, and some ellipses are
+/// thin.
+std::vector<shape_t> createShapes(int count) {
+    std::mt19937                          rng(9);
+    std::uniform_real_distribution<float> unit(0, 1);
+    std::vector<shape_t>                  shapes(count);
+    for (int i = 0; i < count; ++i) {
+        shape_t &shape = shapes[i];
+        shape.ellipse  = i % 2 == 1;
+        shape.width    = 2 + powf(unit(rng), 2) * 400;
+        shape.height   = i % 5 == 0 ? 3 + unit(rng) * 10
+                                    : 2 + powf(unit(rng), 2) * 400;
+        shape.x        = 100 + unit(rng) * 400;
+        shape.y        = 100 + unit(rng) * 400;
+        if (!shape.ellipse) {
+            shape.x -= shape.width / 2;
+            shape.y -= shape.height / 2;
+            shape.arc_width  = unit(rng) * shape.width * 1.2f;
+            shape.arc_height = unit(rng) * shape.height * 1.2f;
+        }
+    }
+    return shapes;
+}
+
+/// the shape as its VGU primitive, or copied into a plain path
+VGPath createPath(const shape_t &shape, bool primitive) {
+    VGPath path = vgCreatePath(VG_PATH_FORMAT_STANDARD, VG_PATH_DATATYPE_F, 1,
+                               0, 0, 0, VG_PATH_CAPABILITY_ALL);
+    if (shape.ellipse) {
+        vguEllipse(path, shape.x, shape.y, shape.width, shape.height);
+    } else {
+        vguRoundRect(path, shape.x, shape.y, shape.width, shape.height,
+                     shape.arc_width, shape.arc_height);
+    }
+    if (primitive) {
+        return path;
+    }
+    VGPath  copy = vgCreatePath(VG_PATH_FORMAT_STANDARD, VG_PATH_DATATYPE_F, 1,
+                                0, 0, 0, VG_PATH_CAPABILITY_ALL);
+    VGfloat matrix[9];
+    vgGetMatrix(matrix);
+    vgLoadIdentity();
+    vgTransformPath(copy, path);
+    vgLoadMatrix(matrix);
+    vgDestroyPath(path);
+    return copy;
+}
+
+/// the path drawn with paint_modes on black
+std::vector<uint32_t> render(VGPath path, VGbitfield paint_modes) {
+    glClear(GL_COLOR_BUFFER_BIT);
+    vgDrawPath(path, paint_modes);
+
+    std::vector<uint32_t> image(IMAGE_WIDTH * IMAGE_HEIGHT);
+    glFinish();
+    glReadPixels(0, 0, IMAGE_WIDTH, IMAGE_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE,
+                 image.data());
+    return image;
+}
+
+/// true if the pixel value occurs within 1 pixel of (x, y) in image.
+bool hasNeighbor(const std::vector<uint32_t> &image, int x, int y,
+                 uint32_t value) {
+    for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, IMAGE_HEIGHT - 1);
+         ++ny) {
+        for (int nx = std::max(x - 1, 0);
+             nx <= std::min(x + 1, IMAGE_WIDTH - 1); ++nx) {
+            if (image[ny * IMAGE_WIDTH + nx] == value)
+                return true;
+        }
+    }
+    return false;
+}
+
+/// renders the shape both ways and expects the same coverage. Returns
+/// false on a mismatch.
+bool compareShape(const char *name, int index, const shape_t &shape,
+                  VGbitfield paint_modes) {
+    VGPath primitive = createPath(shape, true);
+    VGPath plain     = createPath(shape, false);
+    std::vector<uint32_t> a = render(primitive, paint_modes);
+    std::vector<uint32_t> b = render(plain, paint_modes);
+    vgDestroyPath(primitive);
+    vgDestroyPath(plain);
+
+    int a_area = 0, b_area = 0, unexplained = 0;
+    for (int y = 0; y < IMAGE_HEIGHT; ++y) {
+        for (int x = 0; x < IMAGE_WIDTH; ++x) {
+            uint32_t pa = a[y * IMAGE_WIDTH + x];
+            uint32_t pb = b[y * IMAGE_WIDTH + x];
+            a_area += pa != 0;
+            b_area += pb != 0;
+            if (pa != pb &&
+                (!hasNeighbor(b, x, y, pa) || !hasNeighbor(a, x, y, pb)))
+                ++unexplained;
+        }
+    }
+
+    // both are flattened within the tolerance, but not at the same points.
+    // the smallest shapes are a few pixels, so allow a couple of pixels.
+    const bool ok = std::abs(a_area - b_area) <= 2 + b_area / 100 &&
+                    unexplained <= 2 + b_area / 1000;
+    // only report the failures
+    if (!ok) {
+        expect(false,
+               "%s %d: the primitive covers %d pixels, the path %d, %d not "
+               "explained by a 1px edge shift",
+               name, index, a_area, b_area, unexplained);
+    }
+    return ok;
+}
+
+/// compares every shape under the current settings
+void compareShapes(const char *setting, const std::vector<shape_t> &shapes,
+                   VGbitfield paint_modes) {
+    const int failures = test_failures;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        compareShape(shapes[i].ellipse ? "ellipse" : "round rect", (int)i,
+                     shapes[i], paint_modes);
+    }
+    expect(test_failures == failures, "%zu shapes cover the same pixels, %s",
+           shapes.size(), setting);
+}
+
+int main(int argc, char **argv) {
+    if (!initHeadlessGL(IMAGE_WIDTH, IMAGE_HEIGHT))
+        return 1;
+    vgCreateContextMNK(IMAGE_WIDTH, IMAGE_HEIGHT,
+                       VG_RENDERING_BACKEND_TYPE_OPENGL33);
+    vgSeti(VG_TESSELLATION_CACHE_BUDGET_MNK, 0);
+
+    VGPaint fill     = vgCreatePaint();
+    VGfloat white[4] = {1, 1, 1, 1};
+    vgSetParameterfv(fill, VG_PAINT_COLOR, 4, white);
+    vgSetPaint(fill, VG_FILL_PATH);
+    VGPaint stroke  = vgCreatePaint();
+    VGfloat red[4]  = {1, 0, 0, 1};
+    vgSetParameterfv(stroke, VG_PAINT_COLOR, 4, red);
+    vgSetPaint(stroke, VG_STROKE_PATH);
+    vgSetf(VG_STROKE_LINE_WIDTH, 3);
+    glClearColor(0, 0, 0, 0);
+    vgSeti(VG_MATRIX_MODE, VG_MATRIX_PATH_USER_TO_SURFACE);
+
+    std::vector<shape_t> shapes = createShapes(200);
+
+    // every primitive is drawn from the shape, the copies are not
+    const VGint shape_fills = vgGeti(VG_TESSELLATION_SHAPE_FILLS_MNK);
+    vgLoadIdentity();
+    compareShapes("16 iterations", shapes, VG_FILL_PATH);
+    expect(vgGeti(VG_TESSELLATION_SHAPE_FILLS_MNK) - shape_fills ==
+               (VGint)shapes.size(),
+           "every primitive fill is generated from its shape");
+
+    vgSetf(VG_TESSELLATION_TOLERANCE_MNK, 0.25f);
+    compareShapes("tolerance 0.25", shapes, VG_FILL_PATH);
+
+    // rotated and sheared about the center of the image. each call here
+    // applies after the ones before it.
+    vgTranslate(-IMAGE_WIDTH / 2, -IMAGE_HEIGHT / 2);
+    vgRotate(30);
+    vgShear(0.3f, 0);
+    vgTranslate(IMAGE_WIDTH / 2, IMAGE_HEIGHT / 2);
+    compareShapes("tolerance 0.25, rotated and sheared", shapes,
+                  VG_FILL_PATH);
+
+    // the stroke is drawn with its own shader after the fill
+    vgLoadIdentity();
+    compareShapes("tolerance 0.25, filled and stroked", shapes,
+                  VG_FILL_PATH | VG_STROKE_PATH);
+
+    // the bounds of a primitive are its rect, where a flattened ellipse
+    // may fall short of its top and bottom
+    int bounds_off = 0;
+    for (const shape_t &shape : shapes) {
+        const VGfloat rect[4] = {
+            shape.ellipse ? shape.x - shape.width / 2 : shape.x,
+            shape.ellipse ? shape.y - shape.height / 2 : shape.y,
+            shape.width, shape.height};
+        VGfloat bounds[4];
+        VGPath  primitive = createPath(shape, true);
+        vgPathBounds(primitive, &bounds[0], &bounds[1], &bounds[2],
+                     &bounds[3]);
+        vgDestroyPath(primitive);
+        for (int i = 0; i < 4; ++i) {
+            bounds_off += fabsf(bounds[i] - rect[i]) > 1e-4f * IMAGE_WIDTH;
+        }
+    }
+    expect(bounds_off == 0, "vgPathBounds of the primitives are their rects, "
+                            "%d values off",
+           bounds_off);
+
+    expect(vgGetError() == VG_NO_ERROR, "no VG error");
+    vgDestroyPaint(fill);
+    vgDestroyPaint(stroke);
+    vgDestroyContextMNK();
+    return testResult();
+}
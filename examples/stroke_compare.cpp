@@ -0,0 +1,252 @@
+/**
+ * @file stroke_compare.cpp
+ * @brief Golden image test of VG_STROKE_MODE_GPU_MNK against the CPU stroker.
+ *
+ * Renders the same strokes offscreen with VG_STROKE_MODE_MESH_MNK and
+ * VG_STROKE_MODE_GPU_MNK for every width, cap and join, and fails when a
+ * pixel differs by more than a 1 pixel shift of an edge. Runs headless on
+ * an EGL surfaceless display, e.g. Mesa llvmpipe with
+ * LIBGL_ALWAYS_SOFTWARE=1. Pass a directory to write both images of every
+ * failing case as PPM files.
+ */
+
+// MonkVG OpenVG interface
+#include <MonkVG/openvg.h>
+#include <MonkVG/vgext.h>
+
+// headless OpenGL
+#include "headless.h"
+
+// System
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Tiger Paths
+#include "tiger_paths.h"
+
+#define IMAGE_WIDTH  600
+#define IMAGE_HEIGHT 600
+
+using image_t = std::vector<uint32_t>;
+
+image_t grabImage() {
+    image_t image(IMAGE_WIDTH * IMAGE_HEIGHT);
+    glFinish();
+    glReadPixels(0, 0, IMAGE_WIDTH, IMAGE_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE,
+                 image.data());
+    return image;
+}
+
+void saveImage(const std::string &name, const image_t &image) {
+    FILE *file = fopen(name.c_str(), "wb");
+    if (!file) {
+        fprintf(stderr, "Cannot write %s\n", name.c_str());
+        return;
+    }
+    fprintf(file, "P6 %d %d 255\n", IMAGE_WIDTH, IMAGE_HEIGHT);
+    for (int y = IMAGE_HEIGHT - 1; y >= 0; --y) {
+        for (int x = 0; x < IMAGE_WIDTH; ++x) {
+            fwrite(&image[y * IMAGE_WIDTH + x], 1, 3, file);
+        }
+    }
+    fclose(file);
+}
+
+/// true if the pixel value occurs within radius of (x, y) in image.
+bool hasNearby(const image_t &image, int x, int y, int radius,
+               uint32_t value) {
+    for (int dy = -radius; dy <= radius; ++dy) {
+        for (int dx = -radius; dx <= radius; ++dx) {
+            int nx = x + dx, ny = y + dy;
+            if (nx < 0 || ny < 0 || nx >= IMAGE_WIDTH || ny >= IMAGE_HEIGHT)
+                continue;
+            if (image[ny * IMAGE_WIDTH + nx] == value)
+                return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Counts the pixels of a and b that differ, and of those the ones with no
+ * equal pixel within radius in the other image. Only the latter are not
+ * explained by an edge landing on a neighbouring pixel.
+ */
+int compareImages(const image_t &a, const image_t &b, int radius,
+                  int &differing) {
+    int unexplained = 0;
+    differing       = 0;
+    for (int y = 0; y < IMAGE_HEIGHT; ++y) {
+        for (int x = 0; x < IMAGE_WIDTH; ++x) {
+            uint32_t va = a[y * IMAGE_WIDTH + x];
+            uint32_t vb = b[y * IMAGE_WIDTH + x];
+            if (va == vb)
+                continue;
+            ++differing;
+            if (!hasNearby(b, x, y, radius, va) ||
+                !hasNearby(a, x, y, radius, vb))
+                ++unexplained;
+        }
+    }
+    return unexplained;
+}
+
+VGPath createPolyline(const std::vector<VGfloat> &coords, bool closed) {
+    VGPath path = vgCreatePath(VG_PATH_FORMAT_STANDARD, VG_PATH_DATATYPE_F, 1,
+                               0, 0, 0, VG_PATH_CAPABILITY_ALL);
+    std::vector<VGubyte> segments = {VG_MOVE_TO_ABS};
+    segments.resize(coords.size() / 2, VG_LINE_TO_ABS);
+    if (closed)
+        segments.push_back(VG_CLOSE_PATH);
+    vgAppendPathData(path, (VGint)segments.size(), segments.data(),
+                     coords.data());
+    return path;
+}
+
+/// the corner cases of the stroker: sharp and reversing joins, dots, curves.
+std::vector<VGPath> createShapes() {
+    std::vector<VGPath> shapes;
+
+    // zigzag with sharp turns
+    shapes.push_back(createPolyline(
+        {20, 20, 120, 30, 40, 60, 140, 80, 30, 110, 150, 100, 150, 40},
+        false));
+
+    std::vector<VGfloat> star;
+    for (int i = 0; i < 10; ++i) {
+        float angle  = i * float(M_PI) / 5;
+        float radius = (i & 1) ? 25 : 60;
+        star.push_back(260 + radius * cosf(angle));
+        star.push_back(80 + radius * sinf(angle));
+    }
+    shapes.push_back(createPolyline(star, true));
+
+    // near and exact reversal
+    shapes.push_back(createPolyline({350, 20, 450, 20, 350, 22}, false));
+    shapes.push_back(createPolyline({380, 80, 480, 80, 380, 80}, false));
+
+    // zero length segment, drawn as a dot by round and square caps
+    shapes.push_back(createPolyline({500, 50, 500, 50}, false));
+
+    shapes.push_back(
+        createPolyline({520, 20, 580, 20, 580, 80, 520, 80}, true));
+
+    std::vector<VGfloat> ellipse;
+    for (int i = 0; i < 64; ++i) {
+        ellipse.push_back(100 + 60 * cosf(i * float(M_PI) / 32));
+        ellipse.push_back(250 + 40 * sinf(i * float(M_PI) / 32));
+    }
+    shapes.push_back(createPolyline(ellipse, true));
+
+    // very short segment at a sharp turn
+    shapes.push_back(
+        createPolyline({200, 200, 260, 300, 261, 200, 330, 300}, false));
+
+    return shapes;
+}
+
+std::vector<VGPath> createTiger() {
+    std::vector<VGPath> paths;
+    for (int i = 0; i < pathCount; ++i) {
+        VGPath path = vgCreatePath(VG_PATH_FORMAT_STANDARD, VG_PATH_DATATYPE_F,
+                                   1, 0, 0, 0, VG_PATH_CAPABILITY_ALL);
+        vgAppendPathData(path, commandCounts[i], commandArrays[i],
+                         dataArrays[i]);
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+int main(int argc, char **argv) {
+    if (!initHeadlessGL(IMAGE_WIDTH, IMAGE_HEIGHT))
+        return 1;
+    vgCreateContextMNK(IMAGE_WIDTH, IMAGE_HEIGHT,
+                       VG_RENDERING_BACKEND_TYPE_OPENGL33);
+
+    VGPaint stroke   = vgCreatePaint();
+    VGfloat black[4] = {0, 0, 0, 1};
+    vgSetParameterfv(stroke, VG_PAINT_COLOR, 4, black);
+    vgSetPaint(stroke, VG_STROKE_PATH);
+    glClearColor(1, 1, 1, 1);
+    vgSetf(VG_STROKE_MITER_LIMIT, 4);
+
+    std::vector<VGPath> shapes = createShapes();
+    std::vector<VGPath> tiger  = createTiger();
+
+    const VGCapStyle  caps[]  = {VG_CAP_BUTT, VG_CAP_ROUND, VG_CAP_SQUARE};
+    const VGJoinStyle joins[] = {VG_JOIN_MITER, VG_JOIN_ROUND, VG_JOIN_BEVEL};
+    const char       *cap_names[]  = {"butt", "round", "square"};
+    const char       *join_names[] = {"miter", "round", "bevel"};
+    const VGint modes[] = {VG_STROKE_MODE_MESH_MNK, VG_STROKE_MODE_GPU_MNK};
+
+    int failures = 0;
+    for (VGfloat width : {1.0f, 6.0f, 14.0f}) {
+        for (int cap = 0; cap < 3; ++cap) {
+            for (int join = 0; join < 3; ++join) {
+                image_t images[2];
+                for (int mode = 0; mode < 2; ++mode) {
+                    vgSeti(VG_STROKE_MODE_MNK, modes[mode]);
+                    vgSetf(VG_STROKE_LINE_WIDTH, width);
+                    vgSeti(VG_STROKE_CAP_STYLE, caps[cap]);
+                    vgSeti(VG_STROKE_JOIN_STYLE, joins[join]);
+                    glClear(GL_COLOR_BUFFER_BIT);
+
+                    vgSeti(VG_MATRIX_MODE, VG_MATRIX_PATH_USER_TO_SURFACE);
+                    vgLoadIdentity();
+                    for (VGPath path : shapes)
+                        vgDrawPath(path, VG_STROKE_PATH);
+
+                    // wide strokes bury the tiger in ink, skip it there
+                    vgScale(0.5f, -0.5f);
+                    vgTranslate(330, 420);
+                    if (width < 10) {
+                        for (VGPath path : tiger)
+                            vgDrawPath(path, VG_STROKE_PATH);
+                    }
+                    images[mode] = grabImage();
+                }
+
+                int differing;
+                int unexplained =
+                    compareImages(images[0], images[1], 1, differing);
+                printf("width %4.1f cap %-6s join %-5s: %6d pixels differ, "
+                       "%d not explained by a 1px edge shift\n",
+                       width, cap_names[cap], join_names[join], differing,
+                       unexplained);
+                if (unexplained == 0)
+                    continue;
+
+                ++failures;
+                if (argc > 1) {
+                    std::string name = std::string(argv[1]) + "/stroke_" +
+                                       std::to_string(int(width)) + "_" +
+                                       cap_names[cap] + "_" +
+                                       join_names[join];
+                    saveImage(name + "_mesh.ppm", images[0]);
+                    saveImage(name + "_gpu.ppm", images[1]);
+                }
+            }
+        }
+    }
+
+    VGErrorCode vg_error = vgGetError();
+    GLenum      gl_error = glGetError();
+    if (vg_error != VG_NO_ERROR || gl_error != GL_NO_ERROR) {
+        fprintf(stderr, "VG error 0x%x, GL error 0x%x\n", vg_error, gl_error);
+        ++failures;
+    }
+
+    for (VGPath path : shapes)
+        vgDestroyPath(path);
+    for (VGPath path : tiger)
+        vgDestroyPath(path);
+    vgDestroyPaint(stroke);
+    vgDestroyContextMNK();
+
+    printf("%s: %d failing cases\n", failures ? "FAILED" : "PASSED",
+           failures);
+    return failures ? 1 : 0;
+}
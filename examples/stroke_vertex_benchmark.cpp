@@ -0,0 +1,187 @@
+/**
+ * @file stroke_vertex_benchmark.cpp
+ * @brief Counts the vertices and triangles the stroker builds for the tiger
+ * with every cap and join, and checks the meshes.
+ *
+ * Strokes all tiger paths flattened with 16 iterations at widths 1 and 4.
+ * Prints the vertices, triangles and median milliseconds of each style,
+ * next to the 4 vertices per flattened segment of the fat lines the stroker
+ * replaced. Fails when a triangle has no area, or when a point inside the
+ * stroke body, a third of the width to either side of the middle of a
+ * segment, is not covered by a triangle. Uses the library internals, so it
+ * builds against the private headers.
+ */
+
+// MonkVG internals
+#include "sweep-tessellator/sweepTessellator.h"
+#include "mkPath.h"
+
+// System
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Tiger Paths
+#include "tiger_paths.h"
+
+using namespace MonkVG;
+
+constexpr uint32_t kIterations = 16;
+constexpr int      kRuns       = 10;
+
+struct tiger_path_t {
+    std::vector<VGubyte> segments;
+    path_coords_t        coords;
+};
+
+std::vector<tiger_path_t> loadTiger() {
+    std::vector<tiger_path_t> tiger(pathCount);
+    for (int i = 0; i < pathCount; ++i) {
+        size_t num_coords = 0;
+        for (int s = 0; s < commandCounts[i]; ++s) {
+            const VGubyte segment = commandArrays[i][s];
+            tiger[i].segments.push_back(segment);
+            num_coords += IPath::segmentToNumCoordinates(
+                (VGPathSegment)(segment & 0x1e));
+        }
+        tiger[i].coords.append(dataArrays[i], num_coords);
+    }
+    return tiger;
+}
+
+/// twice the signed area of the triangle a b c
+double cross(const VGfloat *a, const VGfloat *b, const VGfloat *c) {
+    return ((double)b[0] - a[0]) * ((double)c[1] - a[1]) -
+           ((double)b[1] - a[1]) * ((double)c[0] - a[0]);
+}
+
+bool covers(const indexed_mesh_t &mesh, const VGfloat p[2]) {
+    for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+        const VGfloat *a = &mesh.vertices[mesh.indices[t] * 2];
+        const VGfloat *b = &mesh.vertices[mesh.indices[t + 1] * 2];
+        const VGfloat *c = &mesh.vertices[mesh.indices[t + 2] * 2];
+        const double   ab = cross(a, b, p), bc = cross(b, c, p),
+                     ca = cross(c, a, p);
+        if ((ab >= 0 && bc >= 0 && ca >= 0) ||
+            (ab <= 0 && bc <= 0 && ca <= 0))
+            return true;
+    }
+    return false;
+}
+
+/// triangles of the mesh without area
+size_t degenerateTriangles(const indexed_mesh_t &mesh) {
+    size_t degenerate = 0;
+    for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+        degenerate += cross(&mesh.vertices[mesh.indices[t] * 2],
+                            &mesh.vertices[mesh.indices[t + 1] * 2],
+                            &mesh.vertices[mesh.indices[t + 2] * 2]) == 0;
+    }
+    return degenerate;
+}
+
+/// points a third of the width to either side of the middle of each
+/// segment longer than the width that the mesh does not cover
+size_t uncoveredSamples(const flattened_path_t &path,
+                        const indexed_mesh_t &mesh, VGfloat width) {
+    size_t uncovered = 0;
+    for (const contour_t &contour : path.contours) {
+        const uint32_t segments = contour.closed ? contour.count
+                                                 : contour.count - 1;
+        for (uint32_t s = 0; contour.count > 1 && s < segments; ++s) {
+            const vertex_2d_t &a = path.points[contour.first + s];
+            const vertex_2d_t &b =
+                path.points[contour.first + (s + 1) % contour.count];
+            const VGfloat dx = b.x - a.x, dy = b.y - a.y;
+            const VGfloat length = std::hypot(dx, dy);
+            if (length <= width) {
+                continue;
+            }
+            const VGfloat nx = -dy / length * width / 3;
+            const VGfloat ny = dx / length * width / 3;
+            for (VGfloat side : {-1.0f, 1.0f}) {
+                const VGfloat p[2] = {(a.x + b.x) / 2 + side * nx,
+                                      (a.y + b.y) / 2 + side * ny};
+                uncovered += !covers(mesh, p);
+            }
+        }
+    }
+    return uncovered;
+}
+
+/// line segments of the flattened path, which the fat lines drew as 4
+/// vertices each
+size_t flattenedSegments(const flattened_path_t &path) {
+    size_t segments = 0;
+    for (const contour_t &contour : path.contours) {
+        if (contour.count > 1) {
+            segments += contour.closed ? contour.count : contour.count - 1;
+        }
+    }
+    return segments;
+}
+
+int main(int argc, char **argv) {
+    std::vector<tiger_path_t>     tiger = loadTiger();
+    std::vector<flattened_path_t> flattened(tiger.size());
+    SweepTessellator              tessellator;
+    size_t                        segments = 0;
+    for (size_t i = 0; i < tiger.size(); ++i) {
+        tessellator.flatten(tiger[i].segments, tiger[i].coords, kIterations,
+                            flattened[i]);
+        segments += flattenedSegments(flattened[i]);
+    }
+
+    printf("tiger strokes, %d paths, %u iterations\n", pathCount,
+           kIterations);
+    printf("fat lines: %zu vertices\n", segments * 4);
+    printf("width  cap     join    vertices  triangles      ms  degenerate  "
+           "uncovered\n");
+    const char *caps[]  = {"butt", "round", "square"};
+    const char *joins[] = {"miter", "round", "bevel"};
+    bool        ok      = true;
+    indexed_mesh_t mesh;
+    for (VGfloat width : {1.0f, 4.0f}) {
+        for (int cap = 0; cap < 3; ++cap) {
+            for (int join = 0; join < 3; ++join) {
+                stroke_style_t style;
+                style.width = width;
+                style.cap   = (VGCapStyle)(VG_CAP_BUTT + cap);
+                style.join  = (VGJoinStyle)(VG_JOIN_MITER + join);
+
+                size_t vertices = 0, triangles = 0, degenerate = 0,
+                       uncovered = 0;
+                for (const flattened_path_t &path : flattened) {
+                    tessellator.buildStroke(path, style, kIterations, mesh);
+                    vertices += mesh.vertexCount();
+                    triangles += mesh.indices.size() / 3;
+                    degenerate += degenerateTriangles(mesh);
+                    uncovered += uncoveredSamples(path, mesh, width);
+                }
+
+                std::vector<double> times;
+                for (int run = 0; run < kRuns; ++run) {
+                    auto start = std::chrono::steady_clock::now();
+                    for (const flattened_path_t &path : flattened)
+                        tessellator.buildStroke(path, style, kIterations,
+                                                mesh);
+                    times.push_back(std::chrono::duration<double, std::milli>(
+                                        std::chrono::steady_clock::now() -
+                                        start)
+                                        .count());
+                }
+                std::sort(times.begin(), times.end());
+
+                ok &= degenerate == 0 && uncovered == 0;
+                printf("%5.0f  %-6s  %-6s  %8zu  %9zu  %6.2f  %10zu  %9zu\n",
+                       width, caps[cap], joins[join], vertices, triangles,
+                       times[times.size() / 2], degenerate, uncovered);
+            }
+        }
+    }
+
+    printf("%s\n", ok ? "PASSED" : "FAILED");
+    return ok ? 0 : 1;
+}
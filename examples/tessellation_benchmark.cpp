@@ -0,0 +1,88 @@
+/**
+ * @file tessellation_benchmark.cpp
+ * @brief Times the GLU and sweep-line fill tessellators on the tiger.
+ *
+ * Every run re-appends the tiger's path data untimed, then times
+ * vgPathBounds over all paths, which flattens and tessellates the fills
+ * without uploading them. The tessellation cache is off. Runs headless on
+ * an EGL surfaceless display. Pass the number of runs, 50 by default.
+ */
+
+// MonkVG OpenVG interface
+#include <MonkVG/openvg.h>
+#include <MonkVG/vgext.h>
+
+// headless OpenGL
+#include "headless.h"
+
+// System
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Tiger Paths
+#include "tiger_paths.h"
+
+#define SURFACE_WIDTH  600
+#define SURFACE_HEIGHT 600
+
+/// median milliseconds to tessellate all tiger fills with the tessellator.
+double timeTessellator(VGTessellatorTypeMNK type, std::vector<VGPath> &paths,
+                       int runs) {
+    vgSeti(VG_TESSELLATOR_TYPE_MNK, type);
+    std::vector<double> times;
+    for (int run = 0; run < runs; ++run) {
+        for (int i = 0; i < pathCount; ++i) {
+            vgClearPath(paths[i], VG_PATH_CAPABILITY_ALL);
+            vgAppendPathData(paths[i], commandCounts[i], commandArrays[i],
+                             dataArrays[i]);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < pathCount; ++i) {
+            VGfloat x, y, width, height;
+            vgPathBounds(paths[i], &x, &y, &width, &height);
+        }
+        times.push_back(std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start)
+                            .count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+int main(int argc, char **argv) {
+    const int runs = argc > 1 ? std::max(1, atoi(argv[1])) : 50;
+    if (!initHeadlessGL(SURFACE_WIDTH, SURFACE_HEIGHT))
+        return 1;
+    vgCreateContextMNK(SURFACE_WIDTH, SURFACE_HEIGHT,
+                       VG_RENDERING_BACKEND_TYPE_OPENGL33);
+    vgSeti(VG_TESSELLATION_CACHE_BUDGET_MNK, 0);
+
+    std::vector<VGPath> paths;
+    for (int i = 0; i < pathCount; ++i) {
+        paths.push_back(vgCreatePath(VG_PATH_FORMAT_STANDARD,
+                                     VG_PATH_DATATYPE_F, 1, 0, 0, 0,
+                                     VG_PATH_CAPABILITY_ALL));
+    }
+
+    const double glu   = timeTessellator(VG_TESSELLATOR_GLU_MNK, paths, runs);
+    const double sweep = timeTessellator(VG_TESSELLATOR_SWEEP_MNK, paths, runs);
+    printf("tiger fills, %d paths, median of %d runs\n", pathCount, runs);
+    printf("GLU:   %.2f ms\n", glu);
+    printf("sweep: %.2f ms\n", sweep);
+    printf("sweep is %.2fx as fast as GLU\n", glu / sweep);
+
+    for (VGPath path : paths)
+        vgDestroyPath(path);
+    vgDestroyContextMNK();
+
+    VGErrorCode error = vgGetError();
+    if (error != VG_NO_ERROR) {
+        fprintf(stderr, "VG error 0x%x\n", error);
+        return 1;
+    }
+    return 0;
+}
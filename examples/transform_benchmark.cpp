@@ -0,0 +1,152 @@
+/**
+ * @file transform_benchmark.cpp
+ * @brief Times vgTransformPath on paths of a million coordinates.
+ *
+ * Every run clears the destination untimed, then times one vgTransformPath
+ * under a rotating and scaling matrix. Absolute lines are transformed from
+ * float to float, 16 bit to float and float to 32 bit. Relative cubics,
+ * lines and horizontal lines take the slower path through every segment.
+ * Appending the float lines with vgAppendPathData is timed alongside, as
+ * the cost of only copying the data. Pass the number of runs, 50 by
+ * default.
+ */
+
+// MonkVG OpenVG interface
+#include <MonkVG/openvg.h>
+#include <MonkVG/vgext.h>
+
+// headless OpenGL
+#include "headless.h"
+
+// System
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#define SURFACE_WIDTH  600
+#define SURFACE_HEIGHT 600
+
+constexpr int kCoords = 1000000;
+
+/// segments and coordinates for vgAppendPathData, in any datatype
+template <typename T> struct path_data_t {
+    std::vector<VGubyte> segments;
+    std::vector<T>       coords;
+};
+
+/// absolute lines through random points
+template <typename T> path_data_t<T> createLines(std::mt19937 &rng) {
+    std::uniform_int_distribution<int> coord(-1000, 1000);
+    path_data_t<T>                     data;
+    for (int i = 0; i < kCoords / 2; ++i) {
+        data.segments.push_back(i ? VG_LINE_TO_ABS : VG_MOVE_TO_ABS);
+        data.coords.push_back((T)coord(rng));
+        data.coords.push_back((T)coord(rng));
+    }
+    return data;
+}
+
+/// relative cubics, lines and horizontal lines in turn
+path_data_t<VGfloat> createRelative(std::mt19937 &rng) {
+    std::uniform_real_distribution<VGfloat> coord(-10, 10);
+    path_data_t<VGfloat>                    data;
+    data.segments.push_back(VG_MOVE_TO_ABS);
+    data.coords.insert(data.coords.end(), {0, 0});
+    while (data.coords.size() < kCoords) {
+        const VGubyte segment = data.segments.size() % 3 == 1 ? VG_CUBIC_TO_REL
+                                : data.segments.size() % 3 == 2
+                                    ? VG_LINE_TO_REL
+                                    : VG_HLINE_TO_REL;
+        const int count = segment == VG_CUBIC_TO_REL  ? 6
+                          : segment == VG_LINE_TO_REL ? 2
+                                                      : 1;
+        data.segments.push_back(segment);
+        for (int i = 0; i < count; ++i) {
+            data.coords.push_back(coord(rng));
+        }
+    }
+    return data;
+}
+
+template <typename T>
+VGPath createPath(VGPathDatatype datatype, const path_data_t<T> &data) {
+    VGPath path = vgCreatePath(VG_PATH_FORMAT_STANDARD, datatype, 1, 0, 0, 0,
+                               VG_PATH_CAPABILITY_ALL);
+    vgAppendPathData(path, (VGint)data.segments.size(), data.segments.data(),
+                     data.coords.data());
+    return path;
+}
+
+/// median milliseconds of run after clearing dst
+template <typename Run> double timeRuns(VGPath dst, int runs, Run run) {
+    std::vector<double> times;
+    for (int i = 0; i < runs; ++i) {
+        vgClearPath(dst, VG_PATH_CAPABILITY_ALL);
+        auto start = std::chrono::steady_clock::now();
+        run();
+        times.push_back(std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start)
+                            .count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+double timeTransform(VGPath dst, VGPath src, int runs) {
+    return timeRuns(dst, runs, [&] { vgTransformPath(dst, src); });
+}
+
+int main(int argc, char **argv) {
+    const int runs = argc > 1 ? std::max(1, atoi(argv[1])) : 50;
+    if (!initHeadlessGL(SURFACE_WIDTH, SURFACE_HEIGHT))
+        return 1;
+    vgCreateContextMNK(SURFACE_WIDTH, SURFACE_HEIGHT,
+                       VG_RENDERING_BACKEND_TYPE_OPENGL33);
+    vgSeti(VG_MATRIX_MODE, VG_MATRIX_PATH_USER_TO_SURFACE);
+    vgLoadIdentity();
+    vgScale(1.5f, 0.75f);
+    vgRotate(30);
+    vgTranslate(100, 50);
+
+    std::mt19937                rng(25);
+    const path_data_t<VGfloat>  lines    = createLines<VGfloat>(rng);
+    const path_data_t<VGshort>  lines16  = createLines<VGshort>(rng);
+    const path_data_t<VGfloat>  relative = createRelative(rng);
+    VGPath src   = createPath(VG_PATH_DATATYPE_F, lines);
+    VGPath src16 = createPath(VG_PATH_DATATYPE_S_16, lines16);
+    VGPath src_relative = createPath(VG_PATH_DATATYPE_F, relative);
+    VGPath dst   = vgCreatePath(VG_PATH_FORMAT_STANDARD, VG_PATH_DATATYPE_F,
+                                1, 0, 0, 0, VG_PATH_CAPABILITY_ALL);
+    VGPath dst32 = vgCreatePath(VG_PATH_FORMAT_STANDARD, VG_PATH_DATATYPE_S_32,
+                                1.0f / 256, 0, 0, 0, VG_PATH_CAPABILITY_ALL);
+
+    printf("vgTransformPath, %d coordinates, median of %d runs\n", kCoords,
+           runs);
+    const double append = timeRuns(dst, runs, [&] {
+        vgAppendPathData(dst, (VGint)lines.segments.size(),
+                         lines.segments.data(), lines.coords.data());
+    });
+    printf("append lines, float:          %6.2f ms\n", append);
+    printf("lines, float to float:        %6.2f ms\n",
+           timeTransform(dst, src, runs));
+    printf("lines, 16 bit to float:       %6.2f ms\n",
+           timeTransform(dst, src16, runs));
+    printf("lines, float to 32 bit:       %6.2f ms\n",
+           timeTransform(dst32, src, runs));
+    printf("relative, float to float:     %6.2f ms (%zu coordinates)\n",
+           timeTransform(dst, src_relative, runs), relative.coords.size());
+
+    for (VGPath path : {src, src16, src_relative, dst, dst32})
+        vgDestroyPath(path);
+    vgDestroyContextMNK();
+
+    VGErrorCode error = vgGetError();
+    if (error != VG_NO_ERROR) {
+        fprintf(stderr, "VG error 0x%x\n", error);
+        return 1;
+    }
+    return 0;
+}
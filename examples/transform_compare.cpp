@@ -0,0 +1,351 @@
+/**
+ * @file transform_compare.cpp
+ * @brief Test of vgTransformPath against a reference transform and against
+ * drawing the source path under the matrix.
+ *
+ * The source path has absolute and relative lines, horizontal and vertical
+ * lines, smooth and plain curves and all four arcs, over two contours. The
+ * reference converts it to absolute coordinates, turns horizontal and
+ * vertical lines into lines, transforms every point and finds the radii and
+ * rotation of each arc from the transformed ellipse, reversing arcs under a
+ * mirroring matrix. For a rotating, a mirroring and a shearing matrix the
+ * path is transformed into a float path, a scaled 32 bit path and into
+ * itself. Each must have the segment and coordinate counts of the
+ * reference, and its fill must cover the same pixels as the reference and
+ * as the source drawn under the matrix, up to a 1 pixel shift of an edge.
+ * Runs headless on an EGL surfaceless display.
+ */
+
+// MonkVG OpenVG interface
+#include <MonkVG/openvg.h>
+#include <MonkVG/vgext.h>
+
+// headless OpenGL
+#include "headless.h"
+
+// System
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include <vector>
+
+#define IMAGE_WIDTH  600
+#define IMAGE_HEIGHT 600
+
+/// path data for vgAppendPathData
+struct shape_t {
+    std::vector<VGubyte> segments;
+    std::vector<VGfloat> coords;
+
+    void add(VGubyte segment, std::initializer_list<VGfloat> values) {
+        segments.push_back(segment);
+        coords.insert(coords.end(), values);
+    }
+};
+
+/// every segment type but the plain absolute ones twice, in a 0 to 100
+/// box
+shape_t createSource() {
+    shape_t shape;
+    shape.add(VG_MOVE_TO_ABS, {10, 10});
+    shape.add(VG_HLINE_TO_REL, {30});
+    shape.add(VG_VLINE_TO_ABS, {20});
+    shape.add(VG_LINE_TO_REL, {20, -10});
+    shape.add(VG_HLINE_TO_ABS, {90});
+    shape.add(VG_VLINE_TO_REL, {25});
+    shape.add(VG_SCCWARC_TO_REL, {12, 8, 30, -10, 20});
+    shape.add(VG_CUBIC_TO_REL, {5, 10, -15, 20, -20, 15});
+    shape.add(VG_SCUBIC_TO_ABS, {50, 75, 45, 70});
+    shape.add(VG_LCWARC_TO_ABS, {15, 10, -20, 30, 80});
+    shape.add(VG_QUAD_TO_REL, {-10, 10, -15, 0});
+    shape.add(VG_SQUAD_TO_REL, {-5, -20});
+    shape.add(VG_CLOSE_PATH, {});
+
+    // a relative move from the start of the closed contour
+    shape.add(VG_MOVE_TO_REL, {50, 75});
+    shape.add(VG_LCCWARC_TO_REL, {10, 6, 45, 20, 0});
+    shape.add(VG_SCWARC_TO_ABS, {9, 9, 0, 60, 95});
+    shape.add(VG_QUAD_TO_ABS, {70, 100, 55, 98});
+    shape.add(VG_SQUAD_TO_ABS, {60, 85});
+    shape.add(VG_CLOSE_PATH, {});
+    return shape;
+}
+
+/// the path user to surface matrix as x' = m[0] x + m[1] y + m[2],
+/// y' = m[3] x + m[4] y + m[5]
+struct matrix_t {
+    double m[6];
+
+    void apply(double &x, double &y, bool translate) const {
+        const double tx = m[0] * x + m[1] * y + (translate ? m[2] : 0);
+        y               = m[3] * x + m[4] * y + (translate ? m[5] : 0);
+        x               = tx;
+    }
+};
+
+matrix_t currentMatrix() {
+    VGfloat m[9];
+    vgGetMatrix(m);
+    return {{m[0], m[1], m[2], m[3], m[4], m[5]}};
+}
+
+/// the radii and rotation in degrees of the ellipse rh, rv, rot under the
+/// linear part of m, from the eigenvectors of A A^T for the ellipse axes A
+void transformEllipse(const matrix_t &m, double &rh, double &rv,
+                      double &rot) {
+    const double c = cos(rot * M_PI / 180), s = sin(rot * M_PI / 180);
+    // columns of A: m times the rotated, scaled unit axes
+    const double a00 = (m.m[0] * c + m.m[1] * s) * rh;
+    const double a10 = (m.m[3] * c + m.m[4] * s) * rh;
+    const double a01 = (-m.m[0] * s + m.m[1] * c) * rv;
+    const double a11 = (-m.m[3] * s + m.m[4] * c) * rv;
+    const double s00 = a00 * a00 + a01 * a01;
+    const double s01 = a00 * a10 + a01 * a11;
+    const double s11 = a10 * a10 + a11 * a11;
+    const double half = (s00 + s11) / 2;
+    const double disc = hypot((s00 - s11) / 2, s01);
+    rh                = sqrt(half + disc);
+    rv                = sqrt(std::max(half - disc, 0.0));
+    rot               = atan2(2 * s01, s00 - s11) / 2 * 180 / M_PI;
+}
+
+/// the source in absolute coordinates transformed by m, horizontal and
+/// vertical lines as lines
+shape_t referenceTransform(const shape_t &src, const matrix_t &m) {
+    const bool mirrors = m.m[0] * m.m[4] - m.m[1] * m.m[3] < 0;
+    shape_t    out;
+    double     start_x = 0, start_y = 0, x = 0, y = 0;
+    size_t     in = 0;
+    for (VGubyte segment : src.segments) {
+        const bool    relative = segment & VG_RELATIVE;
+        const double  ox = relative ? x : 0, oy = relative ? y : 0;
+        const VGubyte type = segment & ~VG_RELATIVE;
+        // appends n points read from the source. the last one is the new
+        // current point.
+        auto points = [&](int n) {
+            for (int i = 0; i < n; ++i) {
+                double px = ox + src.coords[in++];
+                double py = oy + src.coords[in++];
+                x = px, y = py;
+                m.apply(px, py, true);
+                out.coords.push_back((VGfloat)px);
+                out.coords.push_back((VGfloat)py);
+            }
+        };
+
+        switch (type) {
+        case VG_CLOSE_PATH:
+            out.segments.push_back(VG_CLOSE_PATH);
+            x = start_x, y = start_y;
+            break;
+        case VG_MOVE_TO:
+            out.segments.push_back(VG_MOVE_TO_ABS);
+            points(1);
+            start_x = x, start_y = y;
+            break;
+        case VG_HLINE_TO:
+        case VG_VLINE_TO: {
+            out.segments.push_back(VG_LINE_TO_ABS);
+            double px = type == VG_HLINE_TO ? ox + src.coords[in] : x;
+            double py = type == VG_VLINE_TO ? oy + src.coords[in] : y;
+            ++in;
+            x = px, y = py;
+            m.apply(px, py, true);
+            out.coords.push_back((VGfloat)px);
+            out.coords.push_back((VGfloat)py);
+            break;
+        }
+        case VG_SCCWARC_TO:
+        case VG_SCWARC_TO:
+        case VG_LCCWARC_TO:
+        case VG_LCWARC_TO: {
+            // counter clockwise and clockwise swap under a mirror
+            static const VGubyte mirrored[] = {
+                VG_SCWARC_TO, VG_SCCWARC_TO, VG_LCWARC_TO, VG_LCCWARC_TO};
+            out.segments.push_back(
+                mirrors ? mirrored[(type - VG_SCCWARC_TO) / 2] : type);
+            double rh = src.coords[in], rv = src.coords[in + 1];
+            double rot = src.coords[in + 2];
+            in += 3;
+            transformEllipse(m, rh, rv, rot);
+            out.coords.insert(out.coords.end(),
+                              {(VGfloat)rh, (VGfloat)rv, (VGfloat)rot});
+            points(1);
+            break;
+        }
+        case VG_QUAD_TO:
+        case VG_SCUBIC_TO:
+            out.segments.push_back(type);
+            points(2);
+            break;
+        case VG_CUBIC_TO:
+            out.segments.push_back(type);
+            points(3);
+            break;
+        default: // lines and smooth quads
+            out.segments.push_back(type);
+            points(1);
+            break;
+        }
+    }
+    return out;
+}
+
+VGPath createPath(const shape_t &shape) {
+    VGPath path = vgCreatePath(VG_PATH_FORMAT_STANDARD, VG_PATH_DATATYPE_F, 1,
+                               0, 0, 0, VG_PATH_CAPABILITY_ALL);
+    vgAppendPathData(path, (VGint)shape.segments.size(),
+                     shape.segments.data(), shape.coords.data());
+    return path;
+}
+
+/// the fill of path in white on black under the current matrix
+std::vector<uint32_t> renderFill(VGPath path) {
+    glClear(GL_COLOR_BUFFER_BIT);
+    vgDrawPath(path, VG_FILL_PATH);
+    std::vector<uint32_t> image(IMAGE_WIDTH * IMAGE_HEIGHT);
+    glFinish();
+    glReadPixels(0, 0, IMAGE_WIDTH, IMAGE_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE,
+                 image.data());
+    return image;
+}
+
+/// true if the pixel value occurs within 1 pixel of (x, y) in image.
+bool hasNeighbor(const std::vector<uint32_t> &image, int x, int y,
+                 uint32_t value) {
+    for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, IMAGE_HEIGHT - 1);
+         ++ny) {
+        for (int nx = std::max(x - 1, 0);
+             nx <= std::min(x + 1, IMAGE_WIDTH - 1); ++nx) {
+            if (image[ny * IMAGE_WIDTH + nx] == value)
+                return true;
+        }
+    }
+    return false;
+}
+
+/// expects a and b to cover the same pixels up to a 1 pixel edge shift
+void compareImages(const char *name, const char *what,
+                   const std::vector<uint32_t> &a,
+                   const std::vector<uint32_t> &b) {
+    int area = 0, unexplained = 0;
+    for (int y = 0; y < IMAGE_HEIGHT; ++y) {
+        for (int x = 0; x < IMAGE_WIDTH; ++x) {
+            const uint32_t va = a[y * IMAGE_WIDTH + x];
+            const uint32_t vb = b[y * IMAGE_WIDTH + x];
+            area += va != 0;
+            if (va != vb &&
+                (!hasNeighbor(b, x, y, va) || !hasNeighbor(a, x, y, vb)))
+                ++unexplained;
+        }
+    }
+    expect(area > 1000 && unexplained == 0,
+           "%s: covers the pixels of %s, %d pixels, %d not explained by a "
+           "1px edge shift",
+           name, what, area, unexplained);
+}
+
+/// transforms the source under the current matrix into a new path of
+/// datatype and scale, or into a copy of itself, and compares it with the
+/// reference
+void compareTransform(const char *name, const shape_t &source,
+                      VGPathDatatype datatype, VGfloat scale, bool in_place) {
+    const matrix_t m         = currentMatrix();
+    shape_t        reference = referenceTransform(source, m);
+    VGPath         src       = createPath(source);
+    VGPath         dst       = src;
+    if (in_place) {
+        // the source stays in front of what it appends
+        reference.segments.insert(reference.segments.begin(),
+                                  source.segments.begin(),
+                                  source.segments.end());
+        reference.coords.insert(reference.coords.begin(),
+                                source.coords.begin(), source.coords.end());
+        vgTransformPath(src, src);
+    } else {
+        dst = vgCreatePath(VG_PATH_FORMAT_STANDARD, datatype, scale, 0, 0, 0,
+                           VG_PATH_CAPABILITY_ALL);
+        vgTransformPath(dst, src);
+    }
+
+    const VGint segments = vgGetParameteri(dst, VG_PATH_NUM_SEGMENTS);
+    const VGint coords   = vgGetParameteri(dst, VG_PATH_NUM_COORDS);
+    expect(segments == (VGint)reference.segments.size() &&
+               coords == (VGint)reference.coords.size(),
+           "%s: %d segments and %d coordinates, reference %zu and %zu", name,
+           segments, coords, reference.segments.size(),
+           reference.coords.size());
+
+    // the transformed path and the reference are drawn untransformed
+    std::vector<uint32_t> under_matrix = renderFill(src);
+    VGPath                ref          = createPath(reference);
+    VGfloat               matrix[9];
+    vgGetMatrix(matrix);
+    vgLoadIdentity();
+    std::vector<uint32_t> transformed = renderFill(dst);
+    compareImages(name, "the reference", transformed, renderFill(ref));
+    if (!in_place) {
+        compareImages(name, "the source under the matrix", transformed,
+                      under_matrix);
+    }
+    vgLoadMatrix(matrix);
+
+    vgDestroyPath(ref);
+    if (dst != src)
+        vgDestroyPath(dst);
+    vgDestroyPath(src);
+}
+
+int main(int argc, char **argv) {
+    if (!initHeadlessGL(IMAGE_WIDTH, IMAGE_HEIGHT))
+        return 1;
+    vgCreateContextMNK(IMAGE_WIDTH, IMAGE_HEIGHT,
+                       VG_RENDERING_BACKEND_TYPE_OPENGL33);
+
+    VGPaint fill     = vgCreatePaint();
+    VGfloat white[4] = {1, 1, 1, 1};
+    vgSetParameterfv(fill, VG_PAINT_COLOR, 4, white);
+    vgSetPaint(fill, VG_FILL_PATH);
+    glClearColor(0, 0, 0, 0);
+    vgSeti(VG_MATRIX_MODE, VG_MATRIX_PATH_USER_TO_SURFACE);
+    vgSeti(VG_FILL_RULE, VG_NON_ZERO);
+
+    const shape_t source = createSource();
+    for (int matrix = 0; matrix < 3; ++matrix) {
+        // each call here applies after the ones before it
+        vgLoadIdentity();
+        const char *name = "rotating";
+        if (matrix == 0) {
+            vgScale(3.5f, 2.5f);
+            vgRotate(35);
+            vgTranslate(300, 40);
+        } else if (matrix == 1) {
+            name = "mirroring";
+            vgScale(-4, 3.5f);
+            vgRotate(10);
+            vgTranslate(480, 80);
+        } else {
+            name = "shearing";
+            vgScale(3, 3.5f);
+            vgShear(0.6f, 0.2f);
+            vgTranslate(60, 100);
+        }
+
+        char label[64];
+        snprintf(label, sizeof(label), "%s, float", name);
+        compareTransform(label, source, VG_PATH_DATATYPE_F, 1, false);
+        snprintf(label, sizeof(label), "%s, scaled 32 bit", name);
+        compareTransform(label, source, VG_PATH_DATATYPE_S_32, 1.0f / 256,
+                         false);
+        snprintf(label, sizeof(label), "%s, in place", name);
+        compareTransform(label, source, VG_PATH_DATATYPE_F, 1, true);
+    }
+
+    expect(vgGetError() == VG_NO_ERROR, "no VG error");
+    vgDestroyPaint(fill);
+    vgDestroyContextMNK();
+    return testResult();
+}
@@ -65,6 +65,93 @@ typedef enum {
     VG_SURFACE_WIDTH_MNK  = 0x1171,
     VG_SURFACE_HEIGHT_MNK = 0x1172,
 
+    /* the fill tessellator. see VGTessellatorTypeMNK */
+    VG_TESSELLATOR_TYPE_MNK = 0x1173,
+
+    /* read only. heap allocations made by the tessellator's internal
+     * storage. stays constant when re-tessellating paths of similar size.
+     */
+    VG_TESSELLATOR_HEAP_ALLOCATIONS_MNK = 0x1174,
+
+    /* maximum distance in surface pixels between a curve and the line
+     * segments it is flattened into. each curve gets as many segments as its
+     * size under the current path transform needs. 0 (default) uses
+     * VG_TESSELLATION_ITERATIONS_MNK segments for every curve.
+     */
+    VG_TESSELLATION_TOLERANCE_MNK = 0x1175,
+
+    /* VG_TRUE to rebuild modified paths on a background thread. a path keeps
+     * drawing its last built geometry until the rebuild is done. off by
+     * default.
+     */
+    VG_TESSELLATION_ASYNC_MNK = 0x1176,
+
+    /* bytes of tessellated geometry cached for reuse by paths with the same
+     * data and tessellation settings. least recently used geometry is
+     * evicted first. every entry keeps a copy of its path data to compare
+     * lookups against, so only enable it when many paths repeat the same
+     * data. 0 disables the cache. 0 by default.
+     */
+    VG_TESSELLATION_CACHE_BUDGET_MNK = 0x1177,
+
+    /* read only. tessellation cache lookups that found geometry, lookups
+     * that did not, and bytes currently cached.
+     */
+    VG_TESSELLATION_CACHE_HITS_MNK   = 0x1178,
+    VG_TESSELLATION_CACHE_MISSES_MNK = 0x1179,
+    VG_TESSELLATION_CACHE_BYTES_MNK  = 0x117A,
+
+    /* read only. fills triangulated directly because they are a single
+     * convex contour, a single simple contour, and fills that needed the
+     * full tessellator.
+     */
+    VG_TESSELLATION_CONVEX_FILLS_MNK  = 0x117B,
+    VG_TESSELLATION_SIMPLE_FILLS_MNK  = 0x117C,
+    VG_TESSELLATION_GENERAL_FILLS_MNK = 0x117D,
+
+    /* read only. fills generated from the shape of a path that only holds
+     * a vguRect, vguRoundRect, vguEllipse or vguArc, including round rects
+     * and ellipses drawn from the backend's shared mesh of rounded corners.
+     */
+    VG_TESSELLATION_SHAPE_FILLS_MNK = 0x117E,
+
+    /* bytes of geometry each path keeps from the tolerances it was built
+     * with before, together with its GPU buffers, so zooming back to a
+     * scale it was drawn at does not tessellate it again. least recently
+     * drawn levels are dropped first. needs VG_TESSELLATION_TOLERANCE_MNK.
+     * 0 (default) keeps only the current geometry.
+     */
+    VG_TESSELLATION_LOD_BUDGET_MNK = 0x117F,
+
+    /* read only. fills and strokes drawn from a level of detail their path
+     * kept instead of being tessellated again.
+     */
+    VG_TESSELLATION_LOD_HITS_MNK = 0x1180,
+
+    /* microseconds per frame that drawing may spend tessellating paths. a
+     * frame starts at vgClear, or a 60th of a second after the last one.
+     * paths that do not fit are built in the next frames, largest on
+     * screen first, and draw their last built geometry or nothing until
+     * then. 0 (default) builds every path when drawn.
+     */
+    VG_TESSELLATION_FRAME_BUDGET_MNK = 0x1181,
+
+    /* read only. draws whose tessellation was deferred to a later frame,
+     * and frames that spent more than the budget.
+     */
+    VG_TESSELLATION_DEFERRED_MNK        = 0x1182,
+    VG_TESSELLATION_BUDGET_OVERRUNS_MNK = 0x1183,
+
+    /* how strokes are drawn. see VGStrokeModeMNK */
+    VG_STROKE_MODE_MNK = 0x1184,
+
+    /* strokes narrower than this many surface pixels under the path
+     * transform are drawn as one pixel wide lines, without joins or caps.
+     * only the OpenGL backend draws hairlines. batches never do. 0
+     * (default) never.
+     */
+    VG_STROKE_HAIRLINE_WIDTH_MNK = 0x1185,
+
     VG_PARAM_TYPE_MNK_FORCE_SIZE = VG_MAX_ENUM
 } VGParamTypeMNK;
 
@@ -83,6 +170,33 @@ typedef enum {
     VG_RENDERING_BACKEND_TYPE_FORCE_SIZE = VG_MAX_ENUM
 } VGRenderingBackendTypeMNK;
 
+/**
+ * @brief Fill tessellator types.
+ * NOTE: Need to compile with the tessellator enabled.
+ * See: CMakeLists.txt for details.
+ *
+ */
+typedef enum {
+    VG_TESSELLATOR_GLU_MNK         = 0,
+    VG_TESSELLATOR_SWEEP_MNK       = 1,
+    VG_TESSELLATOR_TYPE_FORCE_SIZE = VG_MAX_ENUM
+} VGTessellatorTypeMNK;
+
+/**
+ * @brief Stroke drawing modes.
+ * VG_STROKE_MODE_GPU_MNK uploads only the flattened path, one instance per
+ * line segment, and expands the stroke with its joins and caps in the
+ * vertex shader. Stroke width, cap, join and miter limit changes then need
+ * no tessellation or upload. Only the OpenGL backend supports it. Dashed
+ * strokes and batches are always drawn as a mesh.
+ *
+ */
+typedef enum {
+    VG_STROKE_MODE_MESH_MNK       = 0, // triangles built on the CPU
+    VG_STROKE_MODE_GPU_MNK        = 1, // expanded in the vertex shader
+    VG_STROKE_MODE_FORCE_SIZE_MNK = VG_MAX_ENUM
+} VGStrokeModeMNK;
+
 /* batches are a method for significantly speeding up rendering of collections
  * of static paths
  */
@@ -96,6 +210,64 @@ VG_API_CALL void VG_API_ENTRY vgDrawBatchMNK(VGBatchMNK batch) VG_API_EXIT;
 VG_API_CALL void VG_API_ENTRY vgDumpBatchMNK(VGBatchMNK batch, void **vertices,
                                              size_t *size) VG_API_EXIT;
 
+/**
+ * @brief Build the fill and/or stroke geometry of many paths at once, for
+ * example when loading a scene. The tessellation runs on a thread pool and
+ * the GPU buffers are built on the calling thread. Drawing a prepared path
+ * with the same paint modes, fill rule, stroke width, paints and path
+ * transform then skips tessellation and upload.
+ *
+ * @param count number of paths
+ * @param paths the paths
+ * @param paintModes VGbitfield of VG_FILL_PATH and/or VG_STROKE_PATH
+ * @return VG_API_CALL
+ */
+VG_API_CALL void VG_API_ENTRY vgPrepareDrawPathsMNK(
+    VGint count, const VGPath *paths, VGbitfield paintModes) VG_API_EXIT;
+
+/**
+ * @brief Build the fill and/or stroke geometry of a path and its GPU
+ * buffers now, for the current fill rule, stroke width, paints and path
+ * transform, so the first vgDrawPath with the same state only draws. Unlike
+ * vgPathBounds it also builds the stroke and uploads. Not limited by
+ * VG_TESSELLATION_FRAME_BUDGET_MNK. See: vgPrepareDrawPathsMNK
+ *
+ * @param path the path
+ * @param paintModes VGbitfield of VG_FILL_PATH and/or VG_STROKE_PATH
+ * @return VG_API_CALL
+ */
+VG_API_CALL void VG_API_ENTRY vgPreparePathMNK(
+    VGPath path, VGbitfield paintModes) VG_API_EXIT;
+
+/**
+ * @brief Called with its userData once MonkVG no longer reads the path data
+ * given to vgAppendPathDataNoCopyMNK. May be called on a MonkVG worker
+ * thread.
+ */
+typedef void (*VGPathDataReleaseMNK)(void *userData);
+
+/**
+ * @brief Append to a path like vgAppendPathData, but read the coordinates in
+ * place instead of copying them, for example out of a memory mapped file.
+ * Only a path without coordinates reads them in place. Otherwise they are
+ * copied. The segments are always copied. The coordinates must not change
+ * until release is called, once the path, its cached geometry and its
+ * background builds are done with them. Editing the path copies them
+ * first. On an error or a copy, release is called before this returns.
+ *
+ * @param dstPath the path
+ * @param numSegments number of segments
+ * @param pathSegments the segments
+ * @param pathData the coordinates in the path datatype, aligned to it
+ * @param release called when pathData is no longer read. May be NULL.
+ * @param userData passed to release
+ * @return VG_API_CALL
+ */
+VG_API_CALL void VG_API_ENTRY vgAppendPathDataNoCopyMNK(
+    VGPath dstPath, VGint numSegments, const VGubyte *pathSegments,
+    const void *pathData, VGPathDataReleaseMNK release,
+    void *userData) VG_API_EXIT;
+
 /**
  * @brief Creates a MonkVG context with the specified rendering backend.
  *
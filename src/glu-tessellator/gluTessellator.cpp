@@ -10,31 +10,30 @@
  */
 #include "gluTessellator.h"
 #include "mkContext.h"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 
 namespace MonkVG {
 
-GLUTessellator::GLUTessellator() : ITessellator() {
-    // BUGBUG: wanted to avoid resizing as we pass a pointer to the data
-    // in gluTessVertex
-    // _tess_verts.reserve(1024);
-}
-
-void GLUTessellator::tessellate(const std::vector<VGubyte> &segments,
-                                const std::vector<VGfloat> &fcoords,
-                                const VGFillRule           fill_rule,
-                                const uint32_t              tess_iterations,
-                                std::vector<VGfloat>       &vertices,
-                                bounding_box_t             &bounding_box) {
-
-    _out_vertices     = &vertices;
-    _out_bounding_box = &bounding_box;
+namespace {
+/**
+ * @brief Routes libtess allocations on this thread into the arena for the
+ * lifetime of the scope. Restores malloc/free when done, also on exceptions.
+ */
+struct arena_scope_t {
+    arena_scope_t(_GLUtessAllocFunc a, _GLUtessReallocFunc r,
+                  _GLUtessFreeFunc f, void *user) {
+        gluTessAllocator(a, r, f, user);
+    }
+    ~arena_scope_t() { gluTessAllocator(nullptr, nullptr, nullptr, nullptr); }
+};
+} // namespace
 
-    // create the tesselator
+GLUTessellator::GLUTessellator() : ITessellator() {
+    // the tessellator object is allocated outside of the arena so it
+    // survives rewinds
     _glu_tessellator = gluNewTess();
-    _tess_verts.clear();
-    _start_vert = {0, 0};
-    _last_vert  = {0, 0};
 
     // set the callback functions
     gluTessCallback(_glu_tessellator, GLU_TESS_BEGIN_DATA,
@@ -45,8 +44,44 @@ void GLUTessellator::tessellate(const std::vector<VGubyte> &segments,
                     (GLvoid(APIENTRY *)()) & GLUTessellator::tessVertex);
     gluTessCallback(_glu_tessellator, GLU_TESS_COMBINE_DATA,
                     (GLvoid(APIENTRY *)()) & GLUTessellator::tessCombine);
+    // with an edge flag callback libtess skips its single contour fast
+    // path, which fans any contour that turns the same way at every vertex,
+    // and so fills a star that winds twice with overlapping triangles.
+    // small convex and simple contours never reach GLU anyway.
+    // See: tessellateIndexed()
+    gluTessCallback(_glu_tessellator, GLU_TESS_EDGE_FLAG_DATA,
+                    (GLvoid(APIENTRY *)()) & GLUTessellator::tessEdgeFlag);
     gluTessCallback(_glu_tessellator, GLU_TESS_ERROR,
                     (GLvoid(APIENTRY *)()) & GLUTessellator::tessError);
+    gluTessProperty(_glu_tessellator, GLU_TESS_TOLERANCE,
+                    0.5f); // HARDWIRED: TODO: make this a parameter
+}
+
+GLUTessellator::~GLUTessellator() {
+    // a polygon left open by an exception still has its mesh in the arena
+    arena_scope_t scope(&GLUTessellator::tessAlloc,
+                        &GLUTessellator::tessRealloc,
+                        &GLUTessellator::tessFree, this);
+    gluDeleteTess(_glu_tessellator);
+    _glu_tessellator = nullptr;
+}
+
+void GLUTessellator::tessellate(const flattened_path_t &path,
+                                const VGFillRule        fill_rule,
+                                std::vector<VGfloat>   &vertices,
+                                bounding_box_t         &bounding_box) {
+
+    _out_vertices     = &vertices;
+    _out_bounding_box = &bounding_box;
+
+    // reset the tesselator. everything allocated for the previous path is
+    // dead once its polygon ended.
+    _arena.rewind();
+    arena_scope_t scope(&GLUTessellator::tessAlloc,
+                        &GLUTessellator::tessRealloc,
+                        &GLUTessellator::tessFree, this);
+    _start_vert = {0, 0};
+    _last_vert  = {0, 0};
 
     if (fill_rule == VG_EVEN_ODD) {
         gluTessProperty(_glu_tessellator, GLU_TESS_WINDING_RULE,
@@ -55,302 +90,29 @@ void GLUTessellator::tessellate(const std::vector<VGubyte> &segments,
         gluTessProperty(_glu_tessellator, GLU_TESS_WINDING_RULE,
                         GLU_TESS_WINDING_NONZERO);
     }
-    gluTessProperty(_glu_tessellator, GLU_TESS_TOLERANCE,
-                    0.5f); // HARDWIRED: TODO: make this a parameter
 
     gluTessBeginPolygon(_glu_tessellator, this);
-    auto   coords_it = fcoords.begin();
-    VGbyte segment   = VG_CLOSE_PATH;
-    v3_t   coords(0, 0, 0);
-    v3_t   prev(0, 0, 0);
-    int    num_contours = 0;
-
-    for (const auto &segment : segments) {
-
-        // todo: deal with relative move
-        bool isRelative = segment & VG_RELATIVE;
-        switch (segment >> 1) {
-        case (VG_CLOSE_PATH >> 1): {
-            if (num_contours) {
-                gluTessEndContour(_glu_tessellator);
-                num_contours--;
-            }
-
-        } break;
-        case (VG_MOVE_TO >> 1): {
-            if (num_contours) {
-                gluTessEndContour(_glu_tessellator);
-                num_contours--;
-            }
-
-            gluTessBeginContour(_glu_tessellator);
-            num_contours++;
-            coords.x = *coords_it;
-            coords_it++;
-            coords.y = *coords_it;
-            coords_it++;
-
-            GLdouble *l = addTessVertex(coords);
-            gluTessVertex(_glu_tessellator, l, l);
-
-        } break;
-        case (VG_LINE_TO >> 1): {
-            prev     = coords;
-            coords.x = *coords_it;
-            coords_it++;
-            coords.y = *coords_it;
-            coords_it++;
-            if (isRelative) {
-                coords.x += prev.x;
-                coords.y += prev.y;
-            }
-
-            GLdouble *l = addTessVertex(coords);
-            gluTessVertex(_glu_tessellator, l, l);
-        } break;
-        case (VG_HLINE_TO >> 1): {
-            prev     = coords;
-            coords.x = *coords_it;
-            coords_it++;
-            if (isRelative) {
-                coords.x += prev.x;
-            }
-
-            GLdouble *l = addTessVertex(coords);
-            gluTessVertex(_glu_tessellator, l, l);
-        } break;
-        case (VG_VLINE_TO >> 1): {
-            prev     = coords;
-            coords.y = *coords_it;
-            coords_it++;
-            if (isRelative) {
-                coords.y += prev.y;
-            }
-
-            GLdouble *l = addTessVertex(coords);
+    for (const contour_t &contour : path.contours) {
+        if (contour.count < 3) {
+            continue; // encloses nothing
+        }
+        gluTessBeginContour(_glu_tessellator);
+        for (uint32_t i = 0; i < contour.count; i++) {
+            const vertex_2d_t &p = path.points[contour.first + i];
+            GLdouble *l = addTessVertex(v3_t(p.x, p.y, 0));
             gluTessVertex(_glu_tessellator, l, l);
-        } break;
-        case (VG_SCUBIC_TO >> 1): {
-            prev         = coords;
-            VGfloat cp2x = *coords_it;
-            coords_it++;
-            VGfloat cp2y = *coords_it;
-            coords_it++;
-            VGfloat p3x = *coords_it;
-            coords_it++;
-            VGfloat p3y = *coords_it;
-            coords_it++;
-
-            if (isRelative) {
-                cp2x += prev.x;
-                cp2y += prev.y;
-                p3x += prev.x;
-                p3y += prev.y;
-            }
-
-            VGfloat cp1x = 2.0f * cp2x - p3x;
-            VGfloat cp1y = 2.0f * cp2y - p3y;
-
-            VGfloat increment = 1.0f / float(tess_iterations);
-            for (VGfloat t = increment; t < 1.0f + increment; t += increment) {
-                v3_t c;
-                c.x         = calcCubicBezier1d(coords.x, cp1x, cp2x, p3x, t);
-                c.y         = calcCubicBezier1d(coords.y, cp1y, cp2y, p3y, t);
-                c.z         = 0;
-                GLdouble *l = addTessVertex(c);
-                gluTessVertex(_glu_tessellator, l, l);
-            }
-            coords.x = p3x;
-            coords.y = p3y;
-
-        } break;
-        case (VG_CUBIC_TO >> 1): {
-            prev         = coords;
-            VGfloat cp1x = *coords_it;
-            coords_it++;
-            VGfloat cp1y = *coords_it;
-            coords_it++;
-            VGfloat cp2x = *coords_it;
-            coords_it++;
-            VGfloat cp2y = *coords_it;
-            coords_it++;
-            VGfloat p3x = *coords_it;
-            coords_it++;
-            VGfloat p3y = *coords_it;
-            coords_it++;
-
-            if (isRelative) {
-                cp1x += prev.x;
-                cp1y += prev.y;
-                cp2x += prev.x;
-                cp2y += prev.y;
-                p3x += prev.x;
-                p3y += prev.y;
-            }
-
-            VGfloat increment = 1.0f / float(tess_iterations);
-            for (VGfloat t = increment; t < 1.0f + increment; t += increment) {
-                v3_t c;
-                c.x         = calcCubicBezier1d(coords.x, cp1x, cp2x, p3x, t);
-                c.y         = calcCubicBezier1d(coords.y, cp1y, cp2y, p3y, t);
-                c.z         = 0;
-                GLdouble *l = addTessVertex(c);
-                gluTessVertex(_glu_tessellator, l, l);
-            }
-            coords.x = p3x;
-            coords.y = p3y;
-
-        } break;
-
-        case (VG_QUAD_TO >> 1): {
-            prev        = coords;
-            VGfloat cpx = *coords_it;
-            coords_it++;
-            VGfloat cpy = *coords_it;
-            coords_it++;
-            VGfloat px = *coords_it;
-            coords_it++;
-            VGfloat py = *coords_it;
-            coords_it++;
-
-            if (isRelative) {
-                cpx += prev.x;
-                cpy += prev.y;
-                px += prev.x;
-                py += prev.y;
-            }
-
-            VGfloat increment = 1.0f / float(tess_iterations);
-            for (VGfloat t = increment; t < 1.0f + increment; t += increment) {
-                v3_t c;
-                c.x         = calcQuadBezier1d(coords.x, cpx, px, t);
-                c.y         = calcQuadBezier1d(coords.y, cpy, py, t);
-                c.z         = 0;
-                GLdouble *l = addTessVertex(c);
-                gluTessVertex(_glu_tessellator, l, l);
-            }
-
-            coords.x = px;
-            coords.y = py;
-
-        } break;
-
-        case (VG_SCCWARC_TO >> 1):
-        case (VG_SCWARC_TO >> 1):
-        case (VG_LCCWARC_TO >> 1):
-        case (VG_LCWARC_TO >> 1):
-
-        {
-            VGfloat rh = *coords_it;
-            coords_it++;
-            VGfloat rv = *coords_it;
-            coords_it++;
-            VGfloat rot = *coords_it;
-            coords_it++;
-            VGfloat cp1x = *coords_it;
-            coords_it++;
-            VGfloat cp1y = *coords_it;
-            coords_it++;
-            if (isRelative) {
-                cp1x += prev.x;
-                cp1y += prev.y;
-            }
-
-            // convert to Center Parameterization (see OpenVG Spec Apendix A)
-            VGfloat   cx0[2];
-            VGfloat   cx1[2];
-            VGboolean success =
-                findEllipses(rh, rv, rot, coords.x, coords.y, cp1x, cp1y,
-                             &cx0[0], &cx0[1], &cx1[0], &cx1[1]);
-
-            if (success) {
-                // see:
-                // http://en.wikipedia.org/wiki/Ellipse#Ellipses_in_computer_graphics
-                const uint32_t steps   = tess_iterations;
-                VGfloat        beta    = 0; // angle. todo
-                VGfloat        sinbeta = sinf(beta);
-                VGfloat        cosbeta = cosf(beta);
-
-                // calculate the start and end angles
-                vertex_2d_t center;
-                center.x = cx0[0];
-                center.y = cx0[1];
-                vertex_2d_t norm[2];
-                norm[0].x           = center.x - coords.x;
-                norm[0].y           = center.y - coords.y;
-                VGfloat inverse_len = 1.0f / sqrtf((norm[0].x * norm[0].x) +
-                                                   (norm[0].y * norm[0].y));
-                norm[0].x *= inverse_len;
-                norm[0].y *= inverse_len;
-
-                norm[1].x   = center.x - cp1x;
-                norm[1].y   = center.y - cp1y;
-                inverse_len = 1.0f / sqrtf((norm[1].x * norm[1].x) +
-                                           (norm[1].y * norm[1].y));
-                norm[1].x *= inverse_len;
-                norm[1].y *= inverse_len;
-                VGfloat startAngle = degrees(acosf(-norm[0].x));
-                VGfloat endAngle   = degrees(acosf(-norm[1].x));
-
-                VGfloat cross = norm[0].x;
-
-                if (cross >= 0) {
-                    startAngle = 360 - startAngle;
-                    endAngle   = 360 - endAngle;
-                }
-                if (startAngle > endAngle) {
-                    VGfloat tmp = startAngle;
-                    startAngle  = endAngle;
-                    endAngle    = tmp;
-                    startAngle  = startAngle - 90;
-                    endAngle    = endAngle - 90;
-                }
-                for (VGfloat g = startAngle; g < endAngle; g += 360 / steps) {
-                    v3_t c;
-
-                    VGfloat alpha    = g * (M_PI / 180.0f);
-                    VGfloat sinalpha = sinf(alpha);
-                    VGfloat cosalpha = cosf(alpha);
-
-                    c.x = cx0[0] +
-                          (rh * cosalpha * cosbeta - rv * sinalpha * sinbeta);
-                    c.y = cx0[1] +
-                          (rh * cosalpha * sinbeta + rv * sinalpha * cosbeta);
-                    c.z = 0;
-
-                    GLdouble *l = addTessVertex(c);
-                    gluTessVertex(_glu_tessellator, l, l);
-                }
-            }
-
-            coords.x = cp1x;
-            coords.y = cp1y;
-
-        } break;
-
-        default:
-            throw std::runtime_error("Unsupported segment type");
-            break;
         }
-    } // foreach segment
-
-    if (num_contours) {
         gluTessEndContour(_glu_tessellator);
-        num_contours--;
     }
-
-    if (num_contours != 0) {
-        throw std::runtime_error("Error in tesselation");
-    }
-
     gluTessEndPolygon(_glu_tessellator);
 
-    // destroy the tesselator
-    gluDeleteTess(_glu_tessellator);
-    _glu_tessellator = nullptr;
-
     _out_vertices     = nullptr;
     _out_bounding_box = nullptr;
+    if (_error) {
+        std::exception_ptr error = nullptr;
+        std::swap(error, _error);
+        std::rethrow_exception(error);
+    }
 }
 
 void GLUTessellator::tessellate(IPath *path, const uint32_t tess_iterations,
@@ -379,60 +141,63 @@ void GLUTessellator::tessEnd(GLvoid *user) {
  * @param user
  */
 void GLUTessellator::tessVertex(GLvoid *vertex, GLvoid *user) {
-    GLUTessellator         *me = (GLUTessellator *)user;
-    std::array<GLdouble, 2> v  = {((GLdouble *)vertex)[0],
-                                  ((GLdouble *)vertex)[1]};
+    GLUTessellator *me = (GLUTessellator *)user;
+    me->guard([&] { me->addTessOutput((GLdouble *)vertex); });
+}
 
-    if (me->primType() == GL_TRIANGLE_FAN) {
+void GLUTessellator::addTessOutput(const GLdouble *vertex) {
+    std::array<GLdouble, 2> v = {vertex[0], vertex[1]};
+
+    if (primType() == GL_TRIANGLE_FAN) {
         // break up fans and strips into triangles
-        switch (me->_vert_cnt) {
+        switch (_vert_cnt) {
         case 0:
-            me->_start_vert[0] = v[0];
-            me->_start_vert[1] = v[1];
+            _start_vert[0] = v[0];
+            _start_vert[1] = v[1];
             break;
         case 1:
-            me->_last_vert[0] = v[0];
-            me->_last_vert[1] = v[1];
+            _last_vert[0] = v[0];
+            _last_vert[1] = v[1];
             break;
 
         default:
-            me->addVertex(me->_start_vert);
-            me->addVertex(me->_last_vert);
-            me->addVertex(v);
-            me->_last_vert[0] = v[0];
-            me->_last_vert[1] = v[1];
+            addVertex(_start_vert);
+            addVertex(_last_vert);
+            addVertex(v);
+            _last_vert[0] = v[0];
+            _last_vert[1] = v[1];
             break;
         }
-    } else if (me->primType() == GL_TRIANGLES) {
-        me->addVertex(v);
-    } else if (me->primType() == GL_TRIANGLE_STRIP) {
-        switch (me->_vert_cnt) {
+    } else if (primType() == GL_TRIANGLES) {
+        addVertex(v);
+    } else if (primType() == GL_TRIANGLE_STRIP) {
+        switch (_vert_cnt) {
         case 0:
-            me->addVertex(v);
+            addVertex(v);
             break;
         case 1:
-            me->_start_vert[0] = v[0];
-            me->_start_vert[1] = v[1];
-            me->addVertex(v);
+            _start_vert[0] = v[0];
+            _start_vert[1] = v[1];
+            addVertex(v);
             break;
         case 2:
-            me->_last_vert[0] = v[0];
-            me->_last_vert[1] = v[1];
-            me->addVertex(v);
+            _last_vert[0] = v[0];
+            _last_vert[1] = v[1];
+            addVertex(v);
             break;
 
         default:
-            me->addVertex(me->_start_vert);
-            me->addVertex(me->_last_vert);
-            me->addVertex(v);
-            me->_start_vert[0] = me->_last_vert[0];
-            me->_start_vert[1] = me->_last_vert[1];
-            me->_last_vert[0]  = v[0];
-            me->_last_vert[1]  = v[1];
+            addVertex(_start_vert);
+            addVertex(_last_vert);
+            addVertex(v);
+            _start_vert[0] = _last_vert[0];
+            _start_vert[1] = _last_vert[1];
+            _last_vert[0]  = v[0];
+            _last_vert[1]  = v[1];
             break;
         }
     }
-    me->_vert_cnt++;
+    _vert_cnt++;
 }
 
 void GLUTessellator::tessCombine(GLdouble coords[3], void *data[4],
@@ -440,8 +205,13 @@ void GLUTessellator::tessCombine(GLdouble coords[3], void *data[4],
                                  void *polygonData) {
 
     GLUTessellator *me = (GLUTessellator *)polygonData;
-    me->_tess_verts.push_back(v3_t(coords));
-    *outData = &me->_tess_verts.back().x;
+    // libtess reports a missing vertex as an error
+    *outData = nullptr;
+    me->guard([&] { *outData = me->addTessVertex(v3_t(coords)); });
+}
+
+void GLUTessellator::tessEdgeFlag(GLboolean flag, GLvoid *user) {
+    // DO NOTHING
 }
 
 void GLUTessellator::tessError(GLenum errorCode) {
@@ -449,4 +219,27 @@ void GLUTessellator::tessError(GLenum errorCode) {
               << gluErrorString(errorCode) << std::endl;
 }
 
+void *GLUTessellator::tessAlloc(void *user, size_t size) {
+    GLUTessellator *me = (GLUTessellator *)user;
+    void           *p  = nullptr;
+    me->guard([&] { p = me->_arena.allocate(size); });
+    return p;
+}
+
+void *GLUTessellator::tessRealloc(void *user, void *ptr, size_t size) {
+    GLUTessellator *me = (GLUTessellator *)user;
+    void           *p  = nullptr;
+    me->guard([&] { p = me->_arena.reallocate(ptr, size); });
+    return p;
+}
+
+void GLUTessellator::tessFree(void *user, void *ptr) {
+    // arena memory is reclaimed by rewinding. only memory allocated before
+    // the arena was installed (the tessellator object) is really freed.
+    GLUTessellator *me = (GLUTessellator *)user;
+    if (ptr != nullptr && !me->_arena.owns(ptr)) {
+        std::free(ptr);
+    }
+}
+
 } // namespace MonkVG
@@ -11,21 +11,22 @@
 #ifndef __GLU_TESSELATOR_H__
 #define __GLU_TESSELATOR_H__
 #include "mkTessellator.h"
+#include "mkArena.h"
 #include <GL/glu.h>
 #include <vector>
-#include <list>
 #include <functional>
 #include <array>
 #include <cstdint>
+#include <exception>
 namespace MonkVG {
 class GLUTessellator : public ITessellator {
   public:
     GLUTessellator();
-    virtual ~GLUTessellator() = default;
+    virtual ~GLUTessellator();
 
-    void tessellate(const std::vector<VGubyte> &segments,
-                    const std::vector<VGfloat> &coords,
-                    const VGFillRule fill_rule, const uint32_t tess_iterations,
+    using ITessellator::tessellate;
+
+    void tessellate(const flattened_path_t &path, const VGFillRule fill_rule,
                     std::vector<VGfloat> &vertices,
                     bounding_box_t       &bounding_box) override;
 
@@ -33,6 +34,10 @@ class GLUTessellator : public ITessellator {
                     std::vector<VGfloat> &vertices,
                     bounding_box_t       &bounding_box) override;
 
+    uint64_t getHeapAllocations() const override {
+        return _arena.heapAllocations();
+    }
+
   private:
     /**
      * @brief Used by the GLU tessellator to track vertices.
@@ -46,23 +51,36 @@ class GLUTessellator : public ITessellator {
     };
 
   private:
-    // GLU Tessalator
+    // GLU Tessalator. created once and reused for every path.
     GLUtesselator *_glu_tessellator = nullptr;
 
-    // storage for the tesselated vertices
+    // storage for the tesselated vertices and for libtess' own mesh and
+    // sweep structures. the arena keeps pointers stable (GLU holds on to
+    // them until gluTessEndPolygon) and is rewound between paths.
     // NOTE: these verts are in 3D space
-    // NOTE: the use of list is because we need pointers to items in the list
-    // and vector will reallocate memory and invalidate the pointers
-    std::list<v3_t> _tess_verts = {};
-    GLdouble       *tessVerticesBackPtr() { return &(_tess_verts.back().x); }
+    Arena _arena = {};
+
+    // C++ exceptions cannot unwind through libtess, so the callbacks keep
+    // the first one and it is rethrown once libtess returned
+    std::exception_ptr _error = nullptr;
+
+    /// @brief run f, keeping what it throws in _error
+    template <typename F> void guard(F &&f) noexcept {
+        try {
+            f();
+        } catch (...) {
+            if (!_error) {
+                _error = std::current_exception();
+            }
+        }
+    }
 
     /// @brief Add a vertex to the tesselation vertex list
     /// @param v a 3D vertex
-    /// @return pointer to the end of the vertex list
+    /// @return pointer to the stored vertex
     GLdouble *addTessVertex(const v3_t &v) {
         // updateBounds(v.x, v.y);
-        _tess_verts.push_back(v);
-        return tessVerticesBackPtr();
+        return &_arena.make<v3_t>(v)->x;
     }
 
     // output vertices and bounding box
@@ -98,11 +116,19 @@ class GLUTessellator : public ITessellator {
     static void tessBegin(GLenum type, GLvoid *user);
     static void tessEnd(GLvoid *user);
     static void tessVertex(GLvoid *vertex, GLvoid *user);
+    void        addTessOutput(const GLdouble *vertex); // of tessVertex()
     static void tessCombine(GLdouble coords[3], void *data[4],
                             GLfloat weight[4], void **outData,
                             void *polygonData);
+    static void tessEdgeFlag(GLboolean flag, GLvoid *user);
     static void tessError(GLenum errorCode);
 
+    // libtess allocator hooks. See: gluTessAllocator(). They return nullptr
+    // when the arena throws, which libtess reports as GLU_OUT_OF_MEMORY.
+    static void *tessAlloc(void *user, size_t size);
+    static void *tessRealloc(void *user, void *ptr, size_t size);
+    static void  tessFree(void *user, void *ptr);
+
 }; // GLUTessellator
 } // namespace MonkVG
 #endif // __GLU_TESSELATOR_H__
@@ -0,0 +1,105 @@
+/**
+ * @file mkArena.cpp
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Chunked bump allocator implementation
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "mkArena.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace MonkVG {
+
+namespace {
+// every allocation is preceded by a header holding its size so it can be
+// reallocated
+constexpr size_t kAlign  = alignof(std::max_align_t);
+constexpr size_t kHeader = (sizeof(size_t) + kAlign - 1) & ~(kAlign - 1);
+
+inline size_t alignUp(const size_t n) { return (n + kAlign - 1) & ~(kAlign - 1); }
+} // namespace
+
+Arena::Arena(size_t chunk_size) : _chunk_size(alignUp(chunk_size)) {}
+
+Arena::~Arena() {
+    for (chunk_t &chunk : _chunks) {
+        std::free(chunk.data);
+    }
+}
+
+void *Arena::allocate(size_t size) {
+    const size_t total = kHeader + alignUp(size);
+
+    // find room in the current or a following chunk
+    while (_chunk < _chunks.size() &&
+           _offset + total > _chunks[_chunk].size) {
+        _chunk++;
+        _offset = 0;
+    }
+
+    if (_chunk == _chunks.size()) {
+        // out of chunks. grow geometrically so the chunk count stays small.
+        chunk_t chunk;
+        chunk.size = std::max(_chunk_size, total);
+        chunk.data = (uint8_t *)std::malloc(chunk.size);
+        if (chunk.data == nullptr) {
+            throw std::bad_alloc();
+        }
+        _chunks.push_back(chunk);
+        _chunk_size *= 2;
+        _heap_allocations++;
+        _offset = 0;
+    }
+
+    uint8_t *p = _chunks[_chunk].data + _offset;
+    *(size_t *)p = size;
+    _offset += total;
+    return p + kHeader;
+}
+
+void *Arena::reallocate(void *p, size_t size) {
+    if (p == nullptr) {
+        return allocate(size);
+    }
+
+    uint8_t     *header   = (uint8_t *)p - kHeader;
+    const size_t old_size = *(size_t *)header;
+
+    // the last allocation can grow in place
+    if (_chunk < _chunks.size()) {
+        const chunk_t &chunk = _chunks[_chunk];
+        const size_t   start = (size_t)(header - chunk.data);
+        if (header + kHeader + alignUp(old_size) == chunk.data + _offset &&
+            start + kHeader + alignUp(size) <= chunk.size) {
+            *(size_t *)header = size;
+            _offset           = start + kHeader + alignUp(size);
+            return p;
+        }
+    }
+
+    void *n = allocate(size);
+    std::memcpy(n, p, std::min(old_size, size));
+    return n;
+}
+
+bool Arena::owns(const void *p) const {
+    const uint8_t *b = (const uint8_t *)p;
+    for (const chunk_t &chunk : _chunks) {
+        if (b >= chunk.data && b < chunk.data + chunk.size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Arena::rewind() {
+    _chunk  = 0;
+    _offset = 0;
+}
+
+} // namespace MonkVG
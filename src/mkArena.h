@@ -0,0 +1,69 @@
+/**
+ * @file mkArena.h
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Chunked bump allocator that is rewound instead of freed
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __mkArena_h__
+#define __mkArena_h__
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace MonkVG {
+
+/**
+ * @brief A chunked bump allocator. Pointers stay valid until rewind(). Chunks
+ * are kept across rewinds so a workload of similar size allocates nothing
+ * from the heap after the first run.
+ */
+class Arena {
+  public:
+    Arena() : Arena(64 * 1024) {}
+    explicit Arena(size_t chunk_size);
+    ~Arena();
+
+    Arena(const Arena &)            = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /// @brief allocate size bytes aligned to max_align_t
+    void *allocate(size_t size);
+
+    /// @brief grow or shrink an allocation. p may be nullptr.
+    void *reallocate(void *p, size_t size);
+
+    /// @brief construct a T in the arena. The destructor is never called.
+    template <typename T, typename... Args> T *make(Args &&...args) {
+        return new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /// @brief true if p was allocated from this arena
+    bool owns(const void *p) const;
+
+    /// @brief release every allocation, keeping the chunks for reuse
+    void rewind();
+
+    /// @brief number of chunks allocated from the heap so far
+    uint64_t heapAllocations() const { return _heap_allocations; }
+
+  private:
+    struct chunk_t {
+        uint8_t *data = nullptr;
+        size_t   size = 0;
+    };
+
+    std::vector<chunk_t> _chunks           = {};
+    size_t               _chunk            = 0; // current chunk
+    size_t               _offset           = 0; // offset into current chunk
+    size_t               _chunk_size       = 0; // size of the next new chunk
+    uint64_t             _heap_allocations = 0;
+};
+
+} // namespace MonkVG
+#endif // __mkArena_h__
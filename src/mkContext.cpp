@@ -21,6 +21,13 @@
 #include "glu-tessellator/gluTessellator.h"
 #endif
 
+#if defined(MNKVG_SWEEP_TESSELATION)
+#include "sweep-tessellator/sweepTessellator.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+
 using namespace MonkVG;
 
 VG_API_CALL VGboolean vgCreateContextMNK(VGint width, VGint height,
@@ -54,7 +61,7 @@ VG_API_CALL void VG_API_ENTRY vgSeti(VGuint type, VGint value) VG_API_EXIT {
 
 VG_API_CALL void VG_API_ENTRY vgSetfv(VGuint type, VGint count,
                                       const VGfloat *values) VG_API_EXIT {
-    IContext::instance().set(type, values);
+    IContext::instance().set(type, count, values);
 }
 VG_API_CALL void VG_API_ENTRY vgSetiv(VGuint type, VGint count,
                                       const VGint *values) VG_API_EXIT {}
@@ -72,11 +79,13 @@ VG_API_CALL VGint VG_API_ENTRY vgGeti(VGuint type) VG_API_EXIT {
 }
 
 VG_API_CALL VGint VG_API_ENTRY vgGetVectorSize(VGuint type) VG_API_EXIT {
-    return -1;
+    return IContext::instance().getVectorSize(type);
 }
 
 VG_API_CALL void VG_API_ENTRY vgGetfv(VGuint type, VGint count,
-                                      VGfloat *values) VG_API_EXIT {}
+                                      VGfloat *values) VG_API_EXIT {
+    IContext::instance().get(type, count, values);
+}
 
 VG_API_CALL void VG_API_ENTRY vgGetiv(VGuint type, VGint count,
                                       VGint *values) VG_API_EXIT {}
@@ -84,6 +93,8 @@ VG_API_CALL void VG_API_ENTRY vgGetiv(VGuint type, VGint count,
 /* Masking and Clearing */
 VG_API_CALL void VG_API_ENTRY vgClear(VGint x, VGint y, VGint width,
                                       VGint height) VG_API_EXIT {
+    // clearing starts a new frame
+    IContext::instance().getTessellationScheduler().beginFrame();
     IContext::instance().clear(x, y, width, height);
 }
 
@@ -120,7 +131,9 @@ IContext::IContext() {
     setImageMode(_image_mode); 
 
 #if defined(MNKVG_GLU_TESSELATION)
-    _tessellator = std::make_unique<GLUTessellator>();
+    setTessellatorType(VG_TESSELLATOR_GLU_MNK);
+#elif defined(MNKVG_SWEEP_TESSELATION)
+    setTessellatorType(VG_TESSELLATOR_SWEEP_MNK);
 #else
     static_assert(false, "No tessellator defined");
 #endif
@@ -133,13 +146,38 @@ void IContext::set(VGuint type, VGfloat f) {
     case VG_STROKE_LINE_WIDTH:
         setStrokeLineWidth(f);
         break;
+    case VG_STROKE_MITER_LIMIT:
+        // the spec clamps limits below 1 to 1
+        setStrokeMiterLimit(std::max(f, 1.0f));
+        break;
+    case VG_STROKE_DASH_PHASE:
+        setStrokeDashPhase(f);
+        break;
+    case VG_TESSELLATION_TOLERANCE_MNK:
+        if (f < 0) {
+            SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+            break;
+        }
+        setTessellationTolerance(f);
+        break;
+    case VG_STROKE_HAIRLINE_WIDTH_MNK:
+        if (f < 0) {
+            SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+            break;
+        }
+        setStrokeHairlineWidth(f);
+        break;
     default:
         SetError(VG_ILLEGAL_ARGUMENT_ERROR);
         break;
     }
 }
 
-void IContext::set(VGuint type, const VGfloat *fv) {
+void IContext::set(VGuint type, VGint count, const VGfloat *fv) {
+    if (count < 0 || (count > 0 && fv == nullptr)) {
+        SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+        return;
+    }
     switch (type) {
     case VG_CLEAR_COLOR:
         setClearColor(fv);
@@ -147,6 +185,9 @@ void IContext::set(VGuint type, const VGfloat *fv) {
     case VG_GLYPH_ORIGIN:
         setGlyphOrigin(fv);
         break;
+    case VG_STROKE_DASH_PATTERN:
+        setStrokeDashPattern(count, fv);
+        break;
 
     default:
         SetError(VG_ILLEGAL_ARGUMENT_ERROR);
@@ -163,12 +204,63 @@ void IContext::set(VGuint type, VGint i) {
     case VG_FILL_RULE:
         setFillRule((VGFillRule)i);
         break;
+    case VG_STROKE_CAP_STYLE:
+        if (i < VG_CAP_BUTT || i > VG_CAP_SQUARE) {
+            SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+            break;
+        }
+        setStrokeCapStyle((VGCapStyle)i);
+        break;
+    case VG_STROKE_JOIN_STYLE:
+        if (i < VG_JOIN_MITER || i > VG_JOIN_BEVEL) {
+            SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+            break;
+        }
+        setStrokeJoinStyle((VGJoinStyle)i);
+        break;
+    case VG_STROKE_DASH_PHASE_RESET:
+        setStrokeDashPhaseReset(i != VG_FALSE);
+        break;
+    case VG_STROKE_MODE_MNK:
+        if (i < VG_STROKE_MODE_MESH_MNK || i > VG_STROKE_MODE_GPU_MNK) {
+            SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+            break;
+        }
+        setStrokeMode((VGStrokeModeMNK)i);
+        break;
     case VG_TESSELLATION_ITERATIONS_MNK:
         setTessellationIterations(i);
         break;
     case VG_IMAGE_MODE:
         setImageMode((VGImageMode)i);
         break;
+    case VG_TESSELLATOR_TYPE_MNK:
+        setTessellatorType((VGTessellatorTypeMNK)i);
+        break;
+    case VG_TESSELLATION_ASYNC_MNK:
+        setTessellationAsync(i != VG_FALSE);
+        break;
+    case VG_TESSELLATION_CACHE_BUDGET_MNK:
+        if (i < 0) {
+            SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+            break;
+        }
+        _tessellation_cache.setBudget((size_t)i);
+        break;
+    case VG_TESSELLATION_LOD_BUDGET_MNK:
+        if (i < 0) {
+            SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+            break;
+        }
+        setTessellationLodBudget((size_t)i);
+        break;
+    case VG_TESSELLATION_FRAME_BUDGET_MNK:
+        if (i < 0) {
+            SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+            break;
+        }
+        _tessellation_scheduler.setBudget((uint32_t)i);
+        break;
     default:
         break;
     }
@@ -178,19 +270,43 @@ void IContext::get(VGuint type, VGfloat &f) const {
     case VG_STROKE_LINE_WIDTH:
         f = getStrokeLineWidth();
         break;
+    case VG_STROKE_MITER_LIMIT:
+        f = getStrokeMiterLimit();
+        break;
+    case VG_STROKE_DASH_PHASE:
+        f = getStrokeDashPhase();
+        break;
+    case VG_TESSELLATION_TOLERANCE_MNK:
+        f = getTessellationTolerance();
+        break;
+    case VG_STROKE_HAIRLINE_WIDTH_MNK:
+        f = getStrokeHairlineWidth();
+        break;
     default:
         SetError(VG_ILLEGAL_ARGUMENT_ERROR);
         break;
     }
 }
 
-void IContext::get(VGuint type, VGfloat *fv) const {
+void IContext::get(VGuint type, VGint count, VGfloat *fv) const {
+    if (count < 0 || count > getVectorSize(type) ||
+        (count > 0 && fv == nullptr)) {
+        SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+        return;
+    }
+    // only count values are written, which may be fewer than the vector has
+    VGfloat values[4];
     switch (type) {
     case VG_CLEAR_COLOR:
-        getClearColor(fv);
+        getClearColor(values);
+        std::copy_n(values, count, fv);
         break;
     case VG_GLYPH_ORIGIN:
-        getGlyphOrigin(fv);
+        getGlyphOrigin(values);
+        std::copy_n(values, count, fv);
+        break;
+    case VG_STROKE_DASH_PATTERN:
+        std::copy_n(getStrokeDashPattern().begin(), count, fv);
         break;
 
     default:
@@ -208,6 +324,21 @@ void IContext::get(VGuint type, VGint &i) const {
     case VG_FILL_RULE:
         i = getFillRule();
         break;
+    case VG_STROKE_CAP_STYLE:
+        i = getStrokeCapStyle();
+        break;
+    case VG_STROKE_JOIN_STYLE:
+        i = getStrokeJoinStyle();
+        break;
+    case VG_STROKE_DASH_PHASE_RESET:
+        i = getStrokeDashPhaseReset() ? VG_TRUE : VG_FALSE;
+        break;
+    case VG_STROKE_MODE_MNK:
+        i = getStrokeMode();
+        break;
+    case VG_MAX_DASH_COUNT:
+        i = (VGint)stroke_style_t::max_dash_count;
+        break;
     case VG_TESSELLATION_ITERATIONS_MNK:
         i = getTessellationIterations();
         break;
@@ -220,12 +351,220 @@ void IContext::get(VGuint type, VGint &i) const {
     case VG_SURFACE_HEIGHT_MNK:
         i = getHeight();
         break;
+    case VG_TESSELLATOR_TYPE_MNK:
+        i = getTessellatorType();
+        break;
+    case VG_TESSELLATION_ASYNC_MNK:
+        i = getTessellationAsync() ? VG_TRUE : VG_FALSE;
+        break;
+    case VG_TESSELLATOR_HEAP_ALLOCATIONS_MNK: {
+        uint64_t allocations = _tessellator->getHeapAllocations();
+        for (const auto &tessellator : _worker_tessellators) {
+            allocations += tessellator->getHeapAllocations();
+        }
+        i = (VGint)allocations;
+    } break;
+    case VG_TESSELLATION_CONVEX_FILLS_MNK:
+        i = (VGint)getFillRouteCount(ITessellator::FillRoute::Convex);
+        break;
+    case VG_TESSELLATION_SIMPLE_FILLS_MNK:
+        i = (VGint)getFillRouteCount(ITessellator::FillRoute::Simple);
+        break;
+    case VG_TESSELLATION_GENERAL_FILLS_MNK:
+        i = (VGint)getFillRouteCount(ITessellator::FillRoute::General);
+        break;
+    case VG_TESSELLATION_SHAPE_FILLS_MNK:
+        i = (VGint)getFillRouteCount(ITessellator::FillRoute::Shape);
+        break;
+    case VG_TESSELLATION_CACHE_BUDGET_MNK:
+        i = (VGint)_tessellation_cache.getBudget();
+        break;
+    case VG_TESSELLATION_CACHE_HITS_MNK:
+        i = (VGint)_tessellation_cache.getHits();
+        break;
+    case VG_TESSELLATION_CACHE_MISSES_MNK:
+        i = (VGint)_tessellation_cache.getMisses();
+        break;
+    case VG_TESSELLATION_CACHE_BYTES_MNK:
+        i = (VGint)_tessellation_cache.getBytes();
+        break;
+    case VG_TESSELLATION_LOD_BUDGET_MNK:
+        i = (VGint)getTessellationLodBudget();
+        break;
+    case VG_TESSELLATION_LOD_HITS_MNK:
+        i = (VGint)_tess_lod_hits.load(std::memory_order_relaxed);
+        break;
+    case VG_TESSELLATION_FRAME_BUDGET_MNK:
+        i = (VGint)_tessellation_scheduler.getBudget();
+        break;
+    case VG_TESSELLATION_DEFERRED_MNK:
+        i = (VGint)_tessellation_scheduler.getDeferred();
+        break;
+    case VG_TESSELLATION_BUDGET_OVERRUNS_MNK:
+        i = (VGint)_tessellation_scheduler.getOverruns();
+        break;
 
     default:
         break;
     }
 }
 
+VGint IContext::getVectorSize(VGuint type) const {
+    switch (type) {
+    case VG_CLEAR_COLOR:
+        return 4;
+    case VG_GLYPH_ORIGIN:
+        return 2;
+    case VG_STROKE_DASH_PATTERN:
+        return (VGint)getStrokeDashPattern().size();
+    default:
+        return -1;
+    }
+}
+
+void IContext::setStrokeDashPattern(const VGint count, const VGfloat *values) {
+    const size_t n =
+        std::min((size_t)std::max(count, 0), stroke_style_t::max_dash_count);
+    _stroke_style.dash_pattern.assign(values, values + n);
+}
+
+uint64_t
+IContext::getFillRouteCount(const ITessellator::FillRoute route) const {
+    uint64_t count = _tessellator->getFillRouteCount(route);
+    for (const auto &tessellator : _worker_tessellators) {
+        count += tessellator->getFillRouteCount(route);
+    }
+    if (_tessellation_worker) {
+        count += _tessellation_worker->getTessellator().getFillRouteCount(route);
+    }
+    return count;
+}
+
+std::unique_ptr<ITessellator>
+IContext::createTessellator(VGTessellatorTypeMNK type) {
+    switch (type) {
+#if defined(MNKVG_GLU_TESSELATION)
+    case VG_TESSELLATOR_GLU_MNK:
+        return std::make_unique<GLUTessellator>();
+#endif
+#if defined(MNKVG_SWEEP_TESSELATION)
+    case VG_TESSELLATOR_SWEEP_MNK:
+        return std::make_unique<SweepTessellator>();
+#endif
+    default:
+        // tessellator not compiled in
+        return nullptr;
+    }
+}
+
+void IContext::setTessellatorType(VGTessellatorTypeMNK type) {
+    std::unique_ptr<ITessellator> tessellator = createTessellator(type);
+    if (!tessellator) {
+        SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+        return;
+    }
+    _tessellator      = std::move(tessellator);
+    _tessellator_type = type;
+    _worker_tessellators.clear();
+    _tessellation_worker = nullptr; // finishes what is queued
+
+    // the cached meshes came from the old tessellator
+    _tessellation_cache.clear();
+}
+
+TessellationWorker &IContext::getTessellationWorker() {
+    if (!_tessellation_worker) {
+        _tessellation_worker = std::make_unique<TessellationWorker>(
+            createTessellator(_tessellator_type));
+    }
+    return *_tessellation_worker;
+}
+
+void IContext::prepareDrawPaths(IPath *const *paths, const size_t count,
+                                const VGbitfield paint_modes) {
+    if (currentBatch() || count == 0) {
+        return;
+    }
+
+    // a path must not be built by two threads at once
+    _prepare_paths.assign(paths, paths + count);
+    std::sort(_prepare_paths.begin(), _prepare_paths.end());
+    _prepare_paths.erase(
+        std::unique(_prepare_paths.begin(), _prepare_paths.end()),
+        _prepare_paths.end());
+
+    const auto build = [&](const size_t i, const uint32_t thread) {
+        ITessellator &tessellator =
+            thread == 0 ? *_tessellator : *_worker_tessellators[thread - 1];
+        if (paint_modes & VG_FILL_PATH) {
+            _prepare_paths[i]->buildFillIfDirty(tessellator);
+        }
+        if (paint_modes & VG_STROKE_PATH) {
+            _prepare_paths[i]->buildStrokeIfDirty(tessellator);
+        }
+    };
+
+    // tessellate on the pool. a single path does not start it.
+    if (_prepare_paths.size() == 1) {
+        build(0, 0);
+    } else {
+        if (!_thread_pool) {
+            _thread_pool = std::make_unique<ThreadPool>();
+        }
+        while (_worker_tessellators.size() + 1 <
+               _thread_pool->getThreadCount()) {
+            _worker_tessellators.push_back(
+                createTessellator(_tessellator_type));
+        }
+        _thread_pool->parallelFor(_prepare_paths.size(), build);
+    }
+
+    // upload on this thread. evicted geometry may own GPU buffers so it is
+    // released here too.
+    _tessellation_cache.releaseEvicted();
+    for (IPath *path : _prepare_paths) {
+        path->buildBuffers(paint_modes);
+    }
+    _prepare_paths.clear();
+}
+
+VGfloat IContext::getPathTessellationTolerance(const VGfloat current) const {
+    if (_tess_tolerance <= 0) {
+        return 0;
+    }
+
+    const VGfloat tolerance = _tess_tolerance / getPathScale();
+    if (!std::isfinite(tolerance)) {
+        return _tess_tolerance;
+    }
+
+    int exponent;
+    frexpf(tolerance, &exponent);
+    const VGfloat octave = ldexpf(1.0f, exponent - 1);
+
+    // coarser only once the tolerance is half an octave past the next one
+    const VGfloat kHysteresis = 1.41421356f;
+    if (current > 0 && current < octave &&
+        tolerance < 2.0f * current * kHysteresis) {
+        return current;
+    }
+    return octave;
+}
+
+VGfloat IContext::getPathScale() const {
+    // the largest singular value of the linear part
+    const Matrix33 &m  = _path_user_to_surface;
+    const VGfloat   t  = m.a * m.a + m.b * m.b + m.c * m.c + m.d * m.d;
+    const VGfloat   dt = m.a * m.d - m.b * m.c;
+    return sqrtf(0.5f * (t + sqrtf(std::max(0.0f, t * t - 4.0f * dt * dt))));
+}
+
+bool IContext::isHairlineStroke() const {
+    // a stroke of no width draws nothing, not a hairline
+    return _stroke_hairline_width > 0 && _stroke_style.width > 0 &&
+           _stroke_style.width * getPathScale() < _stroke_hairline_width;
+}
+
 void IContext::setMatrixMode(VGMatrixMode mode) {
     _matrix_mode = mode;
     switch (mode) {
@@ -19,11 +19,18 @@
 #include "mkFont.h"
 #include "mkMath.h"
 #include "mkTessellator.h"
+#include "mkThreadPool.h"
+#include "mkTessellationCache.h"
+#include "mkTessellationScheduler.h"
+#include "mkTessellationWorker.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <atomic>
+#include <memory>
 #include <stack>
+#include <vector>
 
 namespace MonkVG {
 
@@ -86,15 +93,75 @@ class IContext {
 
     //// parameters ////
     void set(VGuint type, VGfloat f);
-    void set(VGuint type, const VGfloat *values);
+    void set(VGuint type, VGint count, const VGfloat *values);
     void set(VGuint type, VGint i);
     void get(VGuint type, VGfloat &f) const;
-    void get(VGuint type, VGfloat *fv) const;
+    void get(VGuint type, VGint count, VGfloat *fv) const;
     void get(VGuint type, VGint &i) const;
+    VGint getVectorSize(VGuint type) const;
 
     //// stroke parameters ////
-    inline void    setStrokeLineWidth(VGfloat w) { _stroke_line_width = w; }
-    inline VGfloat getStrokeLineWidth() const { return _stroke_line_width; }
+    inline void    setStrokeLineWidth(VGfloat w) { _stroke_style.width = w; }
+    inline VGfloat getStrokeLineWidth() const { return _stroke_style.width; }
+
+    inline void       setStrokeCapStyle(VGCapStyle c) { _stroke_style.cap = c; }
+    inline VGCapStyle getStrokeCapStyle() const { return _stroke_style.cap; }
+
+    inline void setStrokeJoinStyle(VGJoinStyle j) { _stroke_style.join = j; }
+    inline VGJoinStyle getStrokeJoinStyle() const { return _stroke_style.join; }
+
+    inline void setStrokeMiterLimit(VGfloat l) {
+        _stroke_style.miter_limit = l;
+    }
+    inline VGfloat getStrokeMiterLimit() const {
+        return _stroke_style.miter_limit;
+    }
+
+    /// @brief set the dash pattern from count values. Values past
+    /// stroke_style_t::max_dash_count are ignored and no values turn dashing
+    /// off.
+    void setStrokeDashPattern(VGint count, const VGfloat *values);
+    inline const std::vector<VGfloat> &getStrokeDashPattern() const {
+        return _stroke_style.dash_pattern;
+    }
+
+    inline void setStrokeDashPhase(VGfloat p) {
+        _stroke_style.dash_phase = p;
+    }
+    inline VGfloat getStrokeDashPhase() const {
+        return _stroke_style.dash_phase;
+    }
+
+    inline void setStrokeDashPhaseReset(bool r) {
+        _stroke_style.dash_phase_reset = r;
+    }
+    inline bool getStrokeDashPhaseReset() const {
+        return _stroke_style.dash_phase_reset;
+    }
+
+    /// @brief the stroke parameters paths are stroked with
+    inline const stroke_style_t &getStrokeStyle() const {
+        return _stroke_style;
+    }
+
+    /// @brief how strokes are drawn. Backends without GPU strokes draw
+    /// meshes either way. See: VG_STROKE_MODE_MNK
+    inline void setStrokeMode(VGStrokeModeMNK m) { _stroke_mode = m; }
+    inline VGStrokeModeMNK getStrokeMode() const { return _stroke_mode; }
+
+    /// @brief strokes narrower than this many surface pixels are drawn as
+    /// one pixel lines by backends that can. 0 never. See:
+    /// VG_STROKE_HAIRLINE_WIDTH_MNK
+    inline void setStrokeHairlineWidth(VGfloat w) {
+        _stroke_hairline_width = w;
+    }
+    inline VGfloat getStrokeHairlineWidth() const {
+        return _stroke_hairline_width;
+    }
+
+    /// @brief true if the stroke is wider than 0 but narrower than the
+    /// hairline width under the current path user to surface transform
+    bool isHairlineStroke() const;
 
     //// surface properties ////
     inline void setClearColor(const VGfloat *c) {
@@ -146,6 +213,44 @@ class IContext {
 
     inline void setTessellationIterations(int32_t i) { _tess_iterations = i; }
 
+    /// flattening tolerance in surface pixels. 0 uses the iterations.
+    inline VGfloat getTessellationTolerance() const { return _tess_tolerance; }
+    inline void    setTessellationTolerance(VGfloat t) { _tess_tolerance = t; }
+
+    /**
+     * @brief The flattening tolerance in path user space for the current
+     * path user to surface transform. Rounded down to a power of two so
+     * paths are only re-tessellated when the scale changes noticeably.
+     * Returns 0 when no tolerance is set.
+     *
+     * @param current the tolerance the path was last built with. A finer
+     * current tolerance is kept until the path is drawn half an octave
+     * smaller than where it would switch, so zooming out and in around a
+     * power of two does not rebuild it every frame.
+     */
+    VGfloat getPathTessellationTolerance(VGfloat current = 0) const;
+
+    /// @brief how much the path user to surface transform stretches a user
+    /// space distance at most
+    VGfloat getPathScale() const;
+
+    /// bytes of levels of detail kept per path. See:
+    /// VG_TESSELLATION_LOD_BUDGET_MNK
+    inline size_t getTessellationLodBudget() const { return _tess_lod_budget; }
+    inline void   setTessellationLodBudget(size_t b) { _tess_lod_budget = b; }
+
+    /// fills and strokes drawn from a kept level of detail. May be counted
+    /// from any thread.
+    inline void countLodHit() {
+        _tess_lod_hits.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// fill tessellator
+    inline VGTessellatorTypeMNK getTessellatorType() const {
+        return _tessellator_type;
+    }
+    void setTessellatorType(VGTessellatorTypeMNK type);
+
     /// batch drawing ///
     virtual void startBatch(IBatch *batch)                               = 0;
     virtual void dumpBatch(IBatch *batch, void **vertices, size_t *size) = 0;
@@ -217,6 +322,39 @@ class IContext {
 
     ITessellator &getTessellator() { return *_tessellator; }
 
+    /// fills triangulated through route by all of the context's
+    /// tessellators. See: ITessellator::FillRoute
+    uint64_t getFillRouteCount(ITessellator::FillRoute route) const;
+
+    /// background path rebuilds. See: VG_TESSELLATION_ASYNC_MNK
+    inline bool getTessellationAsync() const { return _tess_async; }
+    inline void setTessellationAsync(bool async) { _tess_async = async; }
+    TessellationWorker &getTessellationWorker();
+
+    /// geometry shared by identical paths. See:
+    /// VG_TESSELLATION_CACHE_BUDGET_MNK
+    TessellationCache &getTessellationCache() { return _tessellation_cache; }
+
+    /// per frame tessellation budget. See:
+    /// VG_TESSELLATION_FRAME_BUDGET_MNK
+    TessellationScheduler &getTessellationScheduler() {
+        return _tessellation_scheduler;
+    }
+
+    /**
+     * @brief Build the fill and/or stroke of many paths at once. The
+     * tessellation is spread over a thread pool with one tessellator per
+     * thread. The GPU buffers are then built on the calling thread. Does
+     * nothing while a batch is being recorded since batched paths are always
+     * rebuilt when drawn.
+     *
+     * @param paths the paths. Repeated paths are built once.
+     * @param count number of paths
+     * @param paint_modes VGbitfield of VG_FILL_PATH and/or VG_STROKE_PATH
+     */
+    void prepareDrawPaths(IPath *const *paths, size_t count,
+                          VGbitfield paint_modes);
+
   protected:
     // surface properties
     VGint   _width  = 0;
@@ -233,11 +371,16 @@ class IContext {
     std::stack<glm::mat4> _projection_stack = {};
 
     // stroke properties
-    VGfloat _stroke_line_width = 1.0; // VG_STROKE_LINE_WIDTH
+    stroke_style_t  _stroke_style          = {};
+    VGStrokeModeMNK _stroke_mode           = VG_STROKE_MODE_MESH_MNK;
+    VGfloat         _stroke_hairline_width = 0;
 
     // rendering quality
-    VGRenderingQuality _rendering_quality = VG_RENDERING_QUALITY_BETTER;
-    int32_t            _tess_iterations   = 16;
+    VGRenderingQuality    _rendering_quality = VG_RENDERING_QUALITY_BETTER;
+    int32_t               _tess_iterations   = 16;
+    VGfloat               _tess_tolerance    = 0;
+    size_t                _tess_lod_budget   = 0; // per path
+    std::atomic<uint64_t> _tess_lod_hits     = 0;
 
     // paints
     IPaint    *_stroke_paint = nullptr;
@@ -260,7 +403,28 @@ class IContext {
     VGRenderingBackendTypeMNK _backend_renderer;
 
     // tessellator
-    std::unique_ptr<ITessellator> _tessellator = nullptr;
+    VGTessellatorTypeMNK          _tessellator_type = VG_TESSELLATOR_GLU_MNK;
+    std::unique_ptr<ITessellator> _tessellator      = nullptr;
+
+    // bulk path preparation. the workers are started on first use. worker
+    // thread i uses _worker_tessellators[i - 1], the calling thread uses
+    // _tessellator.
+    std::unique_ptr<ThreadPool>                _thread_pool         = nullptr;
+    std::vector<std::unique_ptr<ITessellator>> _worker_tessellators = {};
+    std::vector<IPath *>                       _prepare_paths       = {};
+
+    // background path rebuilds. the worker is started on first use.
+    bool                                _tess_async          = false;
+    std::unique_ptr<TessellationWorker> _tessellation_worker = nullptr;
+
+    // tessellated geometry by path data and settings
+    TessellationCache _tessellation_cache;
+
+    // tessellation time spent drawing this frame
+    TessellationScheduler _tessellation_scheduler;
+
+    static std::unique_ptr<ITessellator>
+    createTessellator(VGTessellatorTypeMNK type);
 };
 } // namespace MonkVG
 
@@ -0,0 +1,157 @@
+/**
+ * @file mkCurves.cpp
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Batched evaluation of the curves paths are flattened into
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "mkCurves.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define MK_CURVES_SSE 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MK_CURVES_NEON 1
+#endif
+
+namespace MonkVG {
+
+namespace {
+
+/// @brief one coordinate of a bezier in power basis: ((a t + b) t + c) t + d
+struct polynomial_t {
+    VGfloat a, b, c, d;
+
+    VGfloat operator()(const VGfloat t) const {
+        return ((a * t + b) * t + c) * t + d;
+    }
+};
+
+/// @brief evaluate x and y at t = i / steps for i = 1 to steps. Power basis
+/// so every t is independent of the others and four fit in a SIMD register.
+void evalPolynomial(const polynomial_t &x, const polynomial_t &y,
+                    const uint32_t steps, vertex_2d_t *out) {
+    const VGfloat dt = 1.0f / VGfloat(steps);
+    uint32_t      i  = 0;
+
+#if MK_CURVES_SSE
+    const __m128  ax = _mm_set1_ps(x.a), bx = _mm_set1_ps(x.b);
+    const __m128  cx = _mm_set1_ps(x.c), dx = _mm_set1_ps(x.d);
+    const __m128  ay = _mm_set1_ps(y.a), by = _mm_set1_ps(y.b);
+    const __m128  cy = _mm_set1_ps(y.c), dy = _mm_set1_ps(y.d);
+    const __m128  vdt   = _mm_set1_ps(dt);
+    const __m128i first = _mm_setr_epi32(1, 2, 3, 4);
+    for (; i + 4 <= steps; i += 4) {
+        const __m128 t = _mm_mul_ps(
+            _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32((int)i), first)),
+            vdt);
+        const __m128 px = _mm_add_ps(
+            _mm_mul_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(ax, t), bx), t),
+                           cx),
+                t),
+            dx);
+        const __m128 py = _mm_add_ps(
+            _mm_mul_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(ay, t), by), t),
+                           cy),
+                t),
+            dy);
+        // interleave into x, y pairs
+        _mm_storeu_ps(out[i].v, _mm_unpacklo_ps(px, py));
+        _mm_storeu_ps(out[i + 2].v, _mm_unpackhi_ps(px, py));
+    }
+#elif MK_CURVES_NEON
+    const float32x4_t vdt      = vdupq_n_f32(dt);
+    const uint32_t    first[4] = {1, 2, 3, 4};
+    const uint32x4_t  vfirst   = vld1q_u32(first);
+    for (; i + 4 <= steps; i += 4) {
+        const float32x4_t t =
+            vmulq_f32(vcvtq_f32_u32(vaddq_u32(vdupq_n_u32(i), vfirst)), vdt);
+        float32x4x2_t xy;
+        xy.val[0] = vmlaq_f32(vdupq_n_f32(x.c), t,
+                              vmlaq_f32(vdupq_n_f32(x.b), t,
+                                        vdupq_n_f32(x.a)));
+        xy.val[0] = vmlaq_f32(vdupq_n_f32(x.d), t, xy.val[0]);
+        xy.val[1] = vmlaq_f32(vdupq_n_f32(y.c), t,
+                              vmlaq_f32(vdupq_n_f32(y.b), t,
+                                        vdupq_n_f32(y.a)));
+        xy.val[1] = vmlaq_f32(vdupq_n_f32(y.d), t, xy.val[1]);
+        vst2q_f32(out[i].v, xy); // stores interleaved
+    }
+#endif
+
+    for (; i < steps; i++) {
+        const VGfloat t = VGfloat(i + 1) * dt;
+        out[i].x        = x(t);
+        out[i].y        = y(t);
+    }
+}
+
+inline polynomial_t quadPolynomial(const VGfloat p0, const VGfloat p1,
+                                   const VGfloat p2) {
+    return {0, p0 - 2.0f * p1 + p2, 2.0f * (p1 - p0), p0};
+}
+
+inline polynomial_t cubicPolynomial(const VGfloat p0, const VGfloat p1,
+                                    const VGfloat p2, const VGfloat p3) {
+    return {p3 - p0 + 3.0f * (p1 - p2), 3.0f * (p0 - 2.0f * p1 + p2),
+            3.0f * (p1 - p0), p0};
+}
+
+} // namespace
+
+void evalQuadBezier(const vertex_2d_t &p0, const vertex_2d_t &p1,
+                    const vertex_2d_t &p2, const uint32_t steps,
+                    vertex_2d_t *out) {
+    if (steps == 0) {
+        return;
+    }
+    evalPolynomial(quadPolynomial(p0.x, p1.x, p2.x),
+                   quadPolynomial(p0.y, p1.y, p2.y), steps, out);
+    out[steps - 1] = p2;
+}
+
+void evalCubicBezier(const vertex_2d_t &p0, const vertex_2d_t &p1,
+                     const vertex_2d_t &p2, const vertex_2d_t &p3,
+                     const uint32_t steps, vertex_2d_t *out) {
+    if (steps == 0) {
+        return;
+    }
+    evalPolynomial(cubicPolynomial(p0.x, p1.x, p2.x, p3.x),
+                   cubicPolynomial(p0.y, p1.y, p2.y, p3.y), steps, out);
+    out[steps - 1] = p3;
+}
+
+void evalEllipse(const vertex_2d_t &center, const vertex_2d_t &u,
+                 const vertex_2d_t &v, const VGfloat start,
+                 const VGfloat sweep, const uint32_t steps,
+                 vertex_2d_t *out) {
+    if (steps == 0) {
+        return;
+    }
+    // in double so the rotation does not drift over many steps
+    const double step     = (double)sweep / steps;
+    const double cos_step = cos(step);
+    const double sin_step = sin(step);
+    double       c        = cos((double)start);
+    double       s        = sin((double)start);
+    for (uint32_t i = 0; i + 1 < steps; i++) {
+        const double next_c = c * cos_step - s * sin_step;
+        s                   = s * cos_step + c * sin_step;
+        c                   = next_c;
+        out[i].x = (VGfloat)(center.x + u.x * c + v.x * s);
+        out[i].y = (VGfloat)(center.y + u.y * c + v.y * s);
+    }
+    // the end exactly
+    const double end   = (double)start + sweep;
+    out[steps - 1].x   = (VGfloat)(center.x + u.x * cos(end) + v.x * sin(end));
+    out[steps - 1].y   = (VGfloat)(center.y + u.y * cos(end) + v.y * sin(end));
+}
+
+} // namespace MonkVG
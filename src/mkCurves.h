@@ -0,0 +1,45 @@
+/**
+ * @file mkCurves.h
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Batched evaluation of the curves paths are flattened into
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __mkCurves_h__
+#define __mkCurves_h__
+#include "mkTypes.h"
+#include <cstdint>
+
+namespace MonkVG {
+
+/**
+ * @brief Evaluate the quadratic bezier p0 p1 p2 at t = i / steps for i = 1
+ * to steps into out[0] to out[steps - 1]. Several t are evaluated at once
+ * with SSE or NEON when available. out[steps - 1] is exactly p2.
+ */
+void evalQuadBezier(const vertex_2d_t &p0, const vertex_2d_t &p1,
+                    const vertex_2d_t &p2, uint32_t steps, vertex_2d_t *out);
+
+/**
+ * @brief Evaluate the cubic bezier p0 p1 p2 p3 at t = i / steps for i = 1
+ * to steps into out[0] to out[steps - 1]. See: evalQuadBezier()
+ */
+void evalCubicBezier(const vertex_2d_t &p0, const vertex_2d_t &p1,
+                     const vertex_2d_t &p2, const vertex_2d_t &p3,
+                     uint32_t steps, vertex_2d_t *out);
+
+/**
+ * @brief Evaluate the ellipse center + u cos(a) + v sin(a) at
+ * a = start + sweep * i / steps for i = 1 to steps into out[0] to
+ * out[steps - 1]. Steps rotate the previous angle instead of calling cos
+ * and sin for each point.
+ */
+void evalEllipse(const vertex_2d_t &center, const vertex_2d_t &u,
+                 const vertex_2d_t &v, VGfloat start, VGfloat sweep,
+                 uint32_t steps, vertex_2d_t *out);
+
+} // namespace MonkVG
+#endif // __mkCurves_h__
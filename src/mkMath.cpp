@@ -10,6 +10,14 @@
 #include "mkMath.h"
 #include "mkContext.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define MK_MATH_SSE 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MK_MATH_NEON 1
+#endif
+
 namespace MonkVG {
 
 void lerpStops(color_t &dst, const gradient_stop_t &stop0,
@@ -49,6 +57,69 @@ void calcStops(const std::vector<gradient_stop_t> &stops,
     }
 }
 
+void affineTransformPoints(const Matrix33 &m, const bool translate,
+                           const VGfloat *in, const size_t count,
+                           VGfloat *out) {
+    const VGfloat e = translate ? m.e : 0;
+    const VGfloat f = translate ? m.f : 0;
+    size_t        i = 0;
+
+#if MK_MATH_SSE
+    // x0 y0 x1 y1 -> a x0 + c y0 + e, b x0 + d y0 + f, ...
+    const __m128 ab = _mm_setr_ps(m.a, m.b, m.a, m.b);
+    const __m128 cd = _mm_setr_ps(m.c, m.d, m.c, m.d);
+    const __m128 ef = _mm_setr_ps(e, f, e, f);
+    for (; i + 2 <= count; i += 2) {
+        const __m128 xy = _mm_loadu_ps(in + i * 2);
+        const __m128 xx = _mm_shuffle_ps(xy, xy, _MM_SHUFFLE(2, 2, 0, 0));
+        const __m128 yy = _mm_shuffle_ps(xy, xy, _MM_SHUFFLE(3, 3, 1, 1));
+        _mm_storeu_ps(out + i * 2,
+                      _mm_add_ps(_mm_add_ps(_mm_mul_ps(ab, xx),
+                                            _mm_mul_ps(cd, yy)),
+                                 ef));
+    }
+#elif MK_MATH_NEON
+    for (; i + 4 <= count; i += 4) {
+        const float32x4x2_t xy = vld2q_f32(in + i * 2); // loads deinterleaved
+        float32x4x2_t       r;
+        r.val[0] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(e), xy.val[0], m.a),
+                               xy.val[1], m.c);
+        r.val[1] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(f), xy.val[0], m.b),
+                               xy.val[1], m.d);
+        vst2q_f32(out + i * 2, r);
+    }
+#endif
+
+    for (; i < count; i++) {
+        const VGfloat x = in[i * 2];
+        const VGfloat y = in[i * 2 + 1];
+        out[i * 2]      = m.a * x + m.c * y + e;
+        out[i * 2 + 1]  = m.b * x + m.d * y + f;
+    }
+}
+
+void affineTransformEllipse(const Matrix33 &m, VGfloat &rh, VGfloat &rv,
+                            VGfloat &rot) {
+    // the ellipse is the unit circle under l = m * rotate(rot) *
+    // scale(rh, rv). l = rotate(phi) * scale(sx, sy) * rotate(theta) and
+    // the circle does not change under rotate(theta).
+    const double r   = rot * (M_PI / 180.0);
+    const double cr  = cos(r), sr = sin(r);
+    const double l00 = (m.a * cr + m.c * sr) * rh;
+    const double l01 = (m.c * cr - m.a * sr) * rv;
+    const double l10 = (m.b * cr + m.d * sr) * rh;
+    const double l11 = (m.d * cr - m.b * sr) * rv;
+
+    const double e   = (l00 + l11) / 2, f = (l00 - l11) / 2;
+    const double g   = (l10 + l01) / 2, h = (l10 - l01) / 2;
+    const double q   = hypot(e, h), s = hypot(f, g);
+    const double phi = (atan2(g, f) + atan2(h, e)) / 2;
+
+    rh  = (VGfloat)(q + s);
+    rv  = (VGfloat)fabs(q - s);
+    rot = (VGfloat)(phi * (180.0 / M_PI));
+}
+
 } // namespace MonkVG
 
 using namespace MonkVG;
@@ -266,6 +266,24 @@ inline void affineTransform(float result[2], const Matrix33 &m,
     result[1] = v[0] * m.get(1, 0) + v[1] * m.get(1, 1) + m.get(1, 2);
 }
 
+/**
+ * @brief Transform count x, y pairs of in by m into out, which may be in.
+ * Two to four points at a time with SSE2 or NEON when available.
+ * @param translate false to apply only the linear part of m, as for
+ * relative coordinates
+ */
+void affineTransformPoints(const Matrix33 &m, bool translate,
+                           const VGfloat *in, size_t count, VGfloat *out);
+
+/**
+ * @brief Transform an ellipse with radii rh and rv whose rh axis is rotated
+ * rot degrees counter clockwise by the linear part of m, in place. The
+ * image of an ellipse under an affine map is an ellipse; its radii are the
+ * singular values of m's linear part times the ellipse's axes.
+ */
+void affineTransformEllipse(const Matrix33 &m, VGfloat &rh, VGfloat &rv,
+                            VGfloat &rot);
+
 /// Gradient helper functions
 /**
  * @brief Calculate the stops surrounding the given gradient position.
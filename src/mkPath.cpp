@@ -10,9 +10,76 @@
 #include "mkPath.h"
 #include "mkContext.h"
 #include <cassert>
+#include <chrono>
+#include <type_traits>
 
 namespace MonkVG { // Internal Implementation
 
+namespace {
+// modifications of a path kept apart until it is drawn. more are merged.
+// See: IPath::modifyFill()
+constexpr size_t kMaxModifiedRanges = 16;
+
+// coordinates transformed at a time on the stack when they are not floats
+// on both sides. whole points. See: transformPoints()
+constexpr size_t kTransformChunk = 256;
+
+/**
+ * @brief Write the count coordinates of src from coordinate first on, x, y
+ * pairs, transformed by m into dst from coordinate out on. Read and written
+ * in place when both are floats without scale and bias, converted through
+ * kTransformChunk coordinates on the stack otherwise.
+ */
+template <typename Cursor>
+void transformPoints(const Cursor src, const size_t first, const size_t count,
+                     const Matrix33 &m, const bool translate,
+                     path_coords_t &dst, const size_t out) {
+    VGfloat *floats = dst.floats();
+    if constexpr (std::is_same_v<Cursor, coord_cursor_t<VGfloat, false>>) {
+        if (floats) {
+            affineTransformPoints(m, translate, src.it + first, count / 2,
+                                  floats + out);
+            return;
+        }
+    }
+    VGfloat xy[kTransformChunk];
+    for (size_t done = 0; done < count; done += kTransformChunk) {
+        const size_t n = std::min(kTransformChunk, count - done);
+        for (size_t i = 0; i < n; i++) {
+            xy[i] = src[first + done + i];
+        }
+        if (floats) {
+            affineTransformPoints(m, translate, xy, n / 2, floats + out + done);
+            continue;
+        }
+        affineTransformPoints(m, translate, xy, n / 2, xy);
+        for (size_t i = 0; i < n; i++) {
+            dst.setValue(out + done + i, xy[i]);
+        }
+    }
+}
+
+/// @brief the segment a transformed segment becomes. See: IPath::transform
+VGubyte transformedSegment(const VGubyte segment, const bool mirrors) {
+    const VGubyte relative = segment & VG_RELATIVE;
+    switch (segment & ~VG_RELATIVE) {
+    case VG_HLINE_TO:
+    case VG_VLINE_TO:
+        return VG_LINE_TO | relative;
+    case VG_SCCWARC_TO:
+        return (mirrors ? VG_SCWARC_TO : VG_SCCWARC_TO) | relative;
+    case VG_SCWARC_TO:
+        return (mirrors ? VG_SCCWARC_TO : VG_SCWARC_TO) | relative;
+    case VG_LCCWARC_TO:
+        return (mirrors ? VG_LCWARC_TO : VG_LCCWARC_TO) | relative;
+    case VG_LCWARC_TO:
+        return (mirrors ? VG_LCCWARC_TO : VG_LCWARC_TO) | relative;
+    default:
+        return segment;
+    }
+}
+} // namespace
+
 uint32_t IPath::segmentToNumCoordinates(VGPathSegment segment) {
 
     static const int32_t segment_to_coord_num[13] = {
@@ -33,59 +100,1141 @@ uint32_t IPath::segmentToNumCoordinates(VGPathSegment segment) {
     return segment_to_coord_num[(uint32_t)segment >> 1];
 }
 
-void IPath::appendData(const VGint numSegments, const VGubyte *pathSegments,
-                       const void *pathData) {
-    int numCoords = 0;
-    for (int i = 0; i < numSegments; i++) {
-        _segments.push_back(pathSegments[i]);
+bool IPath::countCoordinates(const VGint numSegments,
+                             const VGubyte *pathSegments, size_t &numCoords) {
+    numCoords = 0;
+    for (VGint i = 0; i < numSegments; i++) {
+        // either VG_ABSOLUTE or VG_RELATIVE of a known command
+        if ((pathSegments[i] >> 1) > (VG_LCWARC_TO >> 1)) {
+            return false;
+        }
         numCoords += segmentToNumCoordinates(
             static_cast<VGPathSegment>(pathSegments[i]));
     }
+    return true;
+}
 
+void IPath::appendData(const VGint numSegments, const VGubyte *pathSegments,
+                       const void *pathData, const size_t numCoords) {
+    // stored as they are. scale and bias are applied when flattening.
+    _coords.append(pathData, numCoords);
+    appendSegments(numSegments, pathSegments, numCoords);
+}
+
+void IPath::appendData(const VGint numSegments, const VGubyte *pathSegments,
+                       std::shared_ptr<const uint8_t> pathData,
+                       const size_t                   numCoords) {
+    if (_coords.empty()) {
+        _coords.share(std::move(pathData), numCoords);
+    } else {
+        _coords.append(pathData.get(), numCoords);
+    }
+    appendSegments(numSegments, pathSegments, numCoords);
+}
+
+void IPath::appendSegments(const VGint numSegments, const VGubyte *pathSegments,
+                           const size_t numCoords) {
+    _segments.insert(_segments.end(), pathSegments, pathSegments + numSegments);
+    segmentsAppended(numSegments, numCoords);
+}
+
+void IPath::segmentsAppended(const VGint numSegments, const size_t numCoords) {
     _num_segments += numSegments;
-    _num_coords += numCoords;
+    _num_coords += (VGint)numCoords;
+
+    // added new data so we are dirty
+    setFillDirty(true);
+    setStrokeDirty(true);
+    _shape           = {};
+    _flattened_valid = false;
+    _lods.clear();
+
+    // paths that keep growing after they were drawn extend their fill
+    // instead of rebuilding it
+    if (_built_modes & VG_FILL_PATH) {
+        _fill_growing = true;
+    }
+    _fill_editing = false;
+    _fill_contours.clear();
+}
+
+bool IPath::modifyCoords(const VGint startIndex, const VGint numSegments,
+                         const void *pathData) {
+    if ((size_t)startIndex + numSegments > _segments.size()) {
+        return false;
+    }
+    size_t first = 0;
+    for (VGint i = 0; i < startIndex; i++) {
+        first += segmentToNumCoordinates(
+            static_cast<VGPathSegment>(_segments[i]));
+    }
+    size_t count = 0;
+    countCoordinates(numSegments, &_segments[startIndex], count);
+    if (count == 0) {
+        return true;
+    }
+    _coords.replace(first, pathData, count);
+
+    setFillDirty(true);
+    setStrokeDirty(true);
+    _shape           = {};
+    _flattened_valid = false;
+    _lods.clear();
+
+    // a fill that was built is edited instead of rebuilt
+    if (_built_modes & VG_FILL_PATH) {
+        _fill_editing        = true;
+        _fill_growing        = false;
+        _fill_built_segments = 0;
+        _fill_built_coords   = 0;
+    }
+    _fill_modified.emplace_back(startIndex, (size_t)startIndex + numSegments);
+    if (_fill_modified.size() > kMaxModifiedRanges) {
+        std::pair<size_t, size_t> merged = _fill_modified.front();
+        for (const auto &[first, end] : _fill_modified) {
+            merged.first  = std::min(merged.first, first);
+            merged.second = std::max(merged.second, end);
+        }
+        _fill_modified.assign(1, merged);
+    }
+    return true;
+}
+
+void IPath::setShape(const shape_descriptor_t &shape,
+                     const size_t              num_segments) {
+    if (_segments.size() != num_segments) {
+        return;
+    }
+    _shape = shape;
+    setFillDirty(true);
+}
 
-    for (int i = 0; i < numCoords; i++) {
-        switch (_datatype) {
-        case VG_PATH_DATATYPE_F:
-            _fcoords.push_back(*(((VGfloat *)(pathData)) + i));
+void IPath::transform(const IPath &src, const Matrix33 &transform) {
+    const size_t num_segments = src._segments.size();
+    size_t       num_coords   = 0;
+    bool         absolute     = true; // only points, in the same layout
+    for (size_t i = 0; i < num_segments; i++) {
+        const VGubyte segment = src._segments[i];
+        switch (segment & ~VG_RELATIVE) {
+        case VG_HLINE_TO:
+        case VG_VLINE_TO:
+            num_coords += 2;
+            absolute = false;
             break;
+        case VG_SCCWARC_TO:
+        case VG_SCWARC_TO:
+        case VG_LCCWARC_TO:
+        case VG_LCWARC_TO:
+            absolute = false;
+            [[fallthrough]];
         default:
-            // error
-            throw std::runtime_error("Unsupported path data type. Currently "
-                                     "only VG_PATH_DATATYPE_F is supported.");
+            num_coords += segmentToNumCoordinates((VGPathSegment)segment);
+            absolute = absolute && !(segment & VG_RELATIVE);
             break;
         }
     }
 
-    // added new data so we are dirty
-    setFillDirty(true);
-    setStrokeDirty(true);
-}
+    // src may be this path, its data stays at the front
+    const size_t first_segment = _segments.size();
+    const size_t first_coord   = _coords.size();
+    _segments.resize(first_segment + num_segments);
+    _coords.grow(num_coords);
+
+    const bool mirrors =
+        transform.a * transform.d - transform.c * transform.b < 0;
+    for (size_t i = 0; i < num_segments; i++) {
+        _segments[first_segment + i] =
+            transformedSegment(src._segments[i], mirrors);
+    }
+
+    src._coords.visit([&](const auto cursor) {
+        if (absolute) {
+            transformPoints(cursor, 0, num_coords, transform, true, _coords,
+                            first_coord);
+            return;
+        }
 
-void IPath::copy(const IPath &src, const Matrix33 &transform) {
-    // TODO: transform!!!
-    // BUGBUG
-    setNumCoords(src.getNumCoords());
-    setNumSegments(src.getNumSegments());
-    _segments = src._segments;
-    _fcoords  = src._fcoords;
+        // consecutive points that are all absolute or all relative are
+        // transformed together
+        size_t in = 0, out = first_coord;
+        size_t run_in = 0, run_out = 0, run_count = 0;
+        bool   run_translate = true;
+
+        auto flush = [&]() {
+            transformPoints(cursor, run_in, run_count, transform,
+                            run_translate, _coords, run_out);
+            run_count = 0;
+        };
+        auto points = [&](const size_t count, const bool translate) {
+            if (run_count && translate != run_translate) {
+                flush();
+            }
+            if (!run_count) {
+                run_in        = in;
+                run_out       = out;
+                run_translate = translate;
+            }
+            run_count += count;
+            in += count;
+            out += count;
+        };
+
+        // the current point in src, for horizontal and vertical lines
+        vertex_2d_t start = {0, 0}, point = {0, 0};
+        for (size_t i = 0; i < num_segments; i++) {
+            const VGubyte segment  = src._segments[i];
+            const bool    relative = segment & VG_RELATIVE;
+            const VGfloat ox       = relative ? point.x : 0;
+            const VGfloat oy       = relative ? point.y : 0;
+            switch (segment & ~VG_RELATIVE) {
+            case VG_CLOSE_PATH:
+                point = start;
+                break;
+            case VG_HLINE_TO:
+            case VG_VLINE_TO: {
+                flush();
+                const bool    h = (segment & ~VG_RELATIVE) == VG_HLINE_TO;
+                const VGfloat v = cursor[in];
+                VGfloat       xy[2];
+                xy[0] = h ? v : relative ? 0 : point.x;
+                xy[1] = h ? (relative ? 0 : point.y) : v;
+                affineTransformPoints(transform, !relative, xy, 1, xy);
+                _coords.setValue(out, xy[0]);
+                _coords.setValue(out + 1, xy[1]);
+                (h ? point.x : point.y) = (h ? ox : oy) + v;
+                in += 1;
+                out += 2;
+                break;
+            }
+            case VG_SCCWARC_TO:
+            case VG_SCWARC_TO:
+            case VG_LCCWARC_TO:
+            case VG_LCWARC_TO: {
+                flush();
+                VGfloat rh  = cursor[in], rv = cursor[in + 1];
+                VGfloat rot = cursor[in + 2];
+                affineTransformEllipse(transform, rh, rv, rot);
+                _coords.setValue(out, rh);
+                _coords.setValue(out + 1, rv);
+                _coords.setValue(out + 2, rot);
+                in += 3;
+                out += 3;
+                points(2, !relative);
+                point = {ox + cursor[in - 2], oy + cursor[in - 1]};
+                break;
+            }
+            default:
+                points(segmentToNumCoordinates((VGPathSegment)segment),
+                       !relative);
+                point = {ox + cursor[in - 2], oy + cursor[in - 1]};
+                if ((segment & ~VG_RELATIVE) == VG_MOVE_TO) {
+                    start = point;
+                }
+                break;
+            }
+        }
+        flush();
+    });
+
+    segmentsAppended((VGint)num_segments, num_coords);
 }
 
 void IPath::clear(VGbitfield caps) {
 
+    // with background tessellation the last built geometry stays drawable
+    // until the rebuild of the new path data is picked up. otherwise it is
+    // gone with the path data.
+    if (!getContext().getTessellationAsync()) {
+        _fill_mesh.clear();
+        _stroke_mesh.clear();
+        _stroke_segments.clear();
+        _stroke_offsets.clear();
+        _stroke_scaling   = false;
+        _fill_entry       = nullptr;
+        _stroke_entry     = nullptr;
+        _built_modes      = 0;
+        _upload_modes     = 0;
+        _async_modes      = 0;
+        _async_build      = nullptr;
+        _async_superseded = 0;
+    }
+    setFillDirty(true);
+    setStrokeDirty(true);
+    _fill_growing           = false;
+    _fill_built_segments    = 0;
+    _fill_built_coords      = 0;
+    _fill_uploaded_vertices = 0;
+    _fill_uploaded_indices  = 0;
+    _fill_editing           = false;
+    _fill_modified.clear();
+    _fill_contours.clear();
+
     _segments.clear();
+    _shape           = {};
+    _flattened_valid = false;
+    _lods.clear();
     _num_segments = 0;
     _num_coords   = 0;
 
-    switch (_datatype) {
-    case VG_PATH_DATATYPE_F:
-        _fcoords.clear();
-        break;
-    default:
-        // error
-        assert(!"unsupported path data type");
-        break;
+    _coords.clear();
+}
+
+bool IPath::needsFillBuild() {
+    bool rebuild = updateFillPaint();
+    // the flattening depends on the path transform when a tolerance is set
+    const VGfloat tolerance =
+        getContext().getPathTessellationTolerance(_fill_tolerance);
+    if (tolerance != _fill_tolerance) {
+        _fill_tolerance = tolerance;
+        rebuild         = true;
+    }
+    if (getContext().getFillRule() != _fill_rule) {
+        _fill_rule = getContext().getFillRule();
+        rebuild    = true;
+    }
+    const bool round_shape = _shape.isRound() && drawsRoundShapes();
+    if (round_shape != _fill_round_shape) {
+        _fill_round_shape = round_shape;
+        rebuild           = true;
+    }
+    // batches always rebuild
+    if (rebuild || getContext().currentBatch()) {
+        setFillDirty(true);
+        _fill_built_segments = 0; // nothing left to append to
+        _fill_built_coords   = 0;
+        _fill_contours.clear(); // or to modify
+    }
+    return getIsFillDirty();
+}
+
+bool IPath::needsStrokeBuild() {
+    if (updateStrokePaint()) {
+        setStrokeDirty(true);
+    }
+    const VGfloat tolerance =
+        getContext().getPathTessellationTolerance(_stroke_tolerance);
+    if (tolerance != _stroke_tolerance) {
+        _stroke_tolerance = tolerance;
+        setStrokeDirty(true);
+    }
+    // hairlines are always lines on the CPU
+    const stroke_style_t style  = strokeStyle();
+    const bool           on_gpu = !style.hairline && expandsStrokeOnGpu();
+    if (on_gpu != _stroke_on_gpu) {
+        _stroke_on_gpu = on_gpu;
+        setStrokeDirty(true);
+    }
+    // the GPU takes the stroke style as it draws. a new width alone may
+    // only move the vertices. See: rescaleStroke()
+    if (!_stroke_on_gpu && style != _stroke_style) {
+        stroke_style_t same_width = style;
+        same_width.width          = _stroke_style.width;
+        if (same_width == _stroke_style && (_built_modes & VG_STROKE_PATH)) {
+            _stroke_width_dirty = true;
+        } else {
+            setStrokeDirty(true);
+        }
+        _stroke_style = style;
+    }
+    return getIsStrokeDirty() || _stroke_width_dirty ||
+           getContext().currentBatch();
+}
+
+stroke_style_t IPath::strokeStyle() {
+    IContext             &ctx   = getContext();
+    const stroke_style_t &style = ctx.getStrokeStyle();
+    if (!drawsHairlines() || ctx.currentBatch() || !ctx.isHairlineStroke()) {
+        return style;
+    }
+    stroke_style_t hairline   = {};
+    hairline.hairline         = true;
+    hairline.width            = 0;
+    hairline.dash_pattern     = style.dash_pattern;
+    hairline.dash_phase       = style.dash_phase;
+    hairline.dash_phase_reset = style.dash_phase_reset;
+    return hairline;
+}
+
+bool IPath::strokeScales() {
+    return _stroke_width_dirty && !getIsStrokeDirty() &&
+           !getContext().currentBatch();
+}
+
+bool IPath::rescaleStroke(ITessellator &tessellator) {
+    if (!_stroke_scaling || !strokeScales() || _stroke_mesh.indices.empty()) {
+        return false;
+    }
+    tessellator.setTolerance(_stroke_tolerance);
+    if (!tessellator.rescaleStroke(_stroke_offsets, _stroke_style,
+                                   getContext().getTessellationIterations(),
+                                   _stroke_mesh)) {
+        return false;
+    }
+    // a stroke still waiting for its first upload is uploaded whole
+    const bool uploaded = !(_upload_modes & VG_STROKE_PATH);
+    strokeBuilt(true);
+    _stroke_rescaled = uploaded;
+    return true;
+}
+
+void IPath::tessellateFill(ITessellator &tessellator) {
+    // VGU primitives are generated faster than they can be hashed and a
+    // growing or editing path is different every time, so they skip the
+    // caches
+    if (!_shape.isShape() && !_fill_growing && !_fill_editing &&
+        findCachedFill()) {
+        return;
+    }
+    buildFill(tessellator);
+}
+
+void IPath::buildFill(ITessellator &tessellator) {
+    tessellator.setTolerance(_fill_tolerance);
+
+    if (_fill_round_shape && _shape.isRound()) {
+        const uint32_t steps = tessellator.measureShape(
+            _shape, getContext().getTessellationIterations(), _bounds);
+        _fill_mesh.clear();
+        _fill_entry = nullptr;
+        fillBuilt();
+        _fill_shape_steps = steps;
+        _fill_shape       = _shape;
+        return;
+    }
+    if (_shape.isShape()) {
+        tessellator.tessellateShape(_shape,
+                                    getContext().getTessellationIterations(),
+                                    _fill_mesh, _bounds);
+        _fill_entry = nullptr;
+        fillBuilt();
+        return;
+    }
+
+    if (_fill_editing) {
+        if (!modifyFill(tessellator)) {
+            buildFillContours(tessellator);
+        }
+        return;
+    }
+
+    if (_fill_growing) {
+        if (appendFill(tessellator)) {
+            return;
+        }
+        _bounds = {VG_MAX_FLOAT, VG_MAX_FLOAT, -VG_MAX_FLOAT, -VG_MAX_FLOAT};
+        tessellator.tessellateIndexed(
+            getFlattened(tessellator, _fill_tolerance),
+            getContext().getFillRule(), _fill_mesh, _bounds);
+        _fill_entry             = nullptr;
+        _fill_built_segments    = _segments.size();
+        _fill_built_coords      = _coords.size();
+        _fill_uploaded_vertices = 0;
+        _fill_uploaded_indices  = 0;
+        fillBuilt();
+        return;
+    }
+
+    TessellationCache &cache = getContext().getTessellationCache();
+    if (cache.isEnabled() || keepsLods()) {
+        auto entry = std::make_shared<tess_cache_entry_t>();
+        entry->key = fillCacheKey();
+        tessellator.tessellateIndexed(
+            getFlattened(tessellator, _fill_tolerance), entry->key.fill_rule,
+            entry->fill_mesh, entry->bounds);
+        if (cache.isEnabled()) {
+            entry->segments = _segments;
+            entry->coords   = _coords;
+            cache.insert(entry);
+        }
+        keepLod(entry);
+        _fill_entry = std::move(entry);
+        _bounds     = _fill_entry->bounds;
+        _fill_mesh.clear();
+    } else {
+        tessellator.tessellateIndexed(
+            getFlattened(tessellator, _fill_tolerance),
+            getContext().getFillRule(), _fill_mesh, _bounds);
+        _fill_entry = nullptr;
+    }
+    fillBuilt();
+}
+
+void IPath::tessellateStroke(ITessellator &tessellator) {
+    if (_stroke_on_gpu) {
+        // cheaper than looking it up
+        tessellator.buildStrokeSegments(
+            getFlattened(tessellator, _stroke_tolerance), _stroke_segments);
+        _stroke_entry = nullptr;
+        strokeBuilt();
+        return;
+    }
+    if (rescaleStroke(tessellator) || findCachedStroke()) {
+        return;
+    }
+    buildStroke(tessellator);
+}
+
+void IPath::buildStroke(ITessellator &tessellator) {
+    // a new stroke style reuses the flattened curves
+    const flattened_path_t &flattened =
+        getFlattened(tessellator, _stroke_tolerance);
+    const uint32_t tess_iterations = getContext().getTessellationIterations();
+    tessellator.setTolerance(_stroke_tolerance);
+    TessellationCache &cache = getContext().getTessellationCache();
+    if (strokeScales()) {
+        // every width would be a new cache entry
+        tessellator.buildStroke(flattened, strokeStyle(),
+                                tess_iterations, _stroke_mesh,
+                                &_stroke_offsets);
+        _stroke_entry = nullptr;
+        strokeBuilt(true);
+        return;
+    }
+    if (cache.isEnabled() || keepsLods()) {
+        auto entry = std::make_shared<tess_cache_entry_t>();
+        entry->key = strokeCacheKey();
+        tessellator.buildStroke(flattened, entry->key.stroke_style,
+                                tess_iterations, entry->stroke_mesh);
+        if (cache.isEnabled()) {
+            entry->segments = _segments;
+            entry->coords   = _coords;
+            cache.insert(entry);
+        }
+        keepLod(entry);
+        _stroke_entry = std::move(entry);
+        _stroke_mesh.clear();
+    } else {
+        tessellator.buildStroke(flattened, strokeStyle(),
+                                tess_iterations, _stroke_mesh);
+        _stroke_entry = nullptr;
+    }
+    strokeBuilt();
+}
+
+bool IPath::appendFill(ITessellator &tessellator) {
+    // the appended data has to start a new contour and close its last one
+    const size_t first = _fill_built_segments;
+    if (first == 0 || first >= _segments.size() ||
+        _segments[first] != (VG_MOVE_TO | VG_ABSOLUTE) ||
+        (_segments.back() & ~VG_RELATIVE) != VG_CLOSE_PATH) {
+        return false;
+    }
+
+    _tail_segments.assign(_segments.begin() + first, _segments.end());
+    _tail_coords.datatype = _coords.datatype;
+    _tail_coords.scale    = _coords.scale;
+    _tail_coords.bias     = _coords.bias;
+    _tail_coords.clear();
+    _tail_coords.append(_coords, _fill_built_coords,
+                        _coords.size() - _fill_built_coords);
+    bounding_box_t bounds = {VG_MAX_FLOAT, VG_MAX_FLOAT, -VG_MAX_FLOAT,
+                             -VG_MAX_FLOAT};
+    tessellator.setTolerance(_fill_tolerance);
+    tessellator.tessellateIndexed(_tail_segments, _tail_coords,
+                                  getContext().getFillRule(),
+                                  getContext().getTessellationIterations(),
+                                  _tail_mesh, bounds);
+
+    // overlapping contours affect each other through the fill rule
+    if (bounds.overlaps(_bounds)) {
+        return false;
+    }
+
+    const uint32_t base = _fill_mesh.vertexCount();
+    _fill_mesh.vertices.insert(_fill_mesh.vertices.end(),
+                               _tail_mesh.vertices.begin(),
+                               _tail_mesh.vertices.end());
+    _fill_mesh.indices.reserve(_fill_mesh.indices.size() +
+                               _tail_mesh.indices.size());
+    for (const uint32_t index : _tail_mesh.indices) {
+        _fill_mesh.indices.push_back(base + index);
+    }
+    if (bounds.width >= 0) {
+        _bounds.update(bounds.min_x, bounds.min_y);
+        _bounds.update(bounds.min_x + bounds.width,
+                       bounds.min_y + bounds.height);
+    }
+    _fill_built_segments = _segments.size();
+    _fill_built_coords   = _coords.size();
+    fillBuilt();
+    return true;
+}
+
+bool IPath::modifyFill(ITessellator &tessellator) {
+    // a build that is queued or in flight already took the modified
+    // segments the contours are missing
+    if (_fill_contours.empty() || _fill_modified.empty() ||
+        (_async_modes & VG_FILL_PATH) ||
+        (_async_build && (_async_build->paint_modes & VG_FILL_PATH))) {
+        return false;
+    }
+
+    // a fill on the GPU only needs the changed ranges uploaded as long as
+    // the contours keep their vertex and index counts
+    const bool uploaded = !(_upload_modes & VG_FILL_PATH);
+    bool       rewrite  = uploaded || _fill_rewritten;
+    if (uploaded) {
+        _fill_rewrite_first_vertex = UINT32_MAX;
+        _fill_rewrite_end_vertex   = 0;
+        _fill_rewrite_first_index  = UINT32_MAX;
+        _fill_rewrite_end_index    = 0;
+    }
+
+    // each contour holding a modified segment once, in path order. the
+    // first contour starts at segment 0.
+    std::sort(_fill_modified.begin(), _fill_modified.end());
+    size_t next = 0;
+    for (const auto &[first, end] : _fill_modified) {
+        const auto holding = std::upper_bound(
+            _fill_contours.begin(), _fill_contours.end(), first,
+            [](const size_t segment, const fill_contour_t &contour) {
+                return segment < contour.first_segment;
+            });
+        next = std::max(next, (size_t)(holding - _fill_contours.begin()) - 1);
+        for (; next < _fill_contours.size() &&
+               _fill_contours[next].first_segment < end;
+             next++) {
+            if (!modifyContour(tessellator, next, rewrite)) {
+                // _fill_mesh may already be partly modified
+                _fill_contours.clear();
+                return false;
+            }
+        }
+    }
+
+    _bounds = {VG_MAX_FLOAT, VG_MAX_FLOAT, -VG_MAX_FLOAT, -VG_MAX_FLOAT};
+    for (const fill_contour_t &contour : _fill_contours) {
+        if (contour.bounds.width >= 0) {
+            _bounds.update(contour.bounds.min_x, contour.bounds.min_y);
+            _bounds.update(contour.bounds.min_x + contour.bounds.width,
+                           contour.bounds.min_y + contour.bounds.height);
+        }
+    }
+    fillBuilt();
+    _fill_rewritten = rewrite;
+    return true;
+}
+
+bool IPath::modifyContour(ITessellator &tessellator, const size_t index,
+                          bool &rewrite) {
+    fill_contour_t &contour = _fill_contours[index];
+    bounding_box_t  bounds  = {VG_MAX_FLOAT, VG_MAX_FLOAT, -VG_MAX_FLOAT,
+                               -VG_MAX_FLOAT};
+    tessellator.setTolerance(_fill_tolerance);
+    tessellator.tessellateContour(
+        &_segments[contour.first_segment], contour.num_segments, _coords,
+        contour.first_coord, getContext().getFillRule(),
+        getContext().getTessellationIterations(), _tail_mesh, bounds);
+
+    // overlapping contours affect each other through the fill rule
+    for (const fill_contour_t &other : _fill_contours) {
+        if (&other != &contour && bounds.overlaps(other.bounds)) {
+            return false;
+        }
+    }
+    contour.bounds = bounds;
+
+    const uint32_t num_vertices = _tail_mesh.vertexCount();
+    const uint32_t num_indices  = (uint32_t)_tail_mesh.indices.size();
+    if (num_vertices == contour.num_vertices &&
+        num_indices == contour.num_indices) {
+        std::copy(_tail_mesh.vertices.begin(), _tail_mesh.vertices.end(),
+                  _fill_mesh.vertices.begin() +
+                      (size_t)contour.first_vertex * 2);
+        for (uint32_t i = 0; i < num_indices; i++) {
+            _fill_mesh.indices[contour.first_index + i] =
+                contour.first_vertex + _tail_mesh.indices[i];
+        }
+        _fill_rewrite_first_vertex =
+            std::min(_fill_rewrite_first_vertex, contour.first_vertex);
+        _fill_rewrite_end_vertex = std::max(
+            _fill_rewrite_end_vertex, contour.first_vertex + num_vertices);
+        _fill_rewrite_first_index =
+            std::min(_fill_rewrite_first_index, contour.first_index);
+        _fill_rewrite_end_index = std::max(_fill_rewrite_end_index,
+                                           contour.first_index + num_indices);
+        return true;
+    }
+
+    // a new size moves the contours after it
+    auto vertices =
+        _fill_mesh.vertices.begin() + (size_t)contour.first_vertex * 2;
+    vertices = _fill_mesh.vertices.erase(
+        vertices, vertices + (size_t)contour.num_vertices * 2);
+    _fill_mesh.vertices.insert(vertices, _tail_mesh.vertices.begin(),
+                               _tail_mesh.vertices.end());
+    auto indices = _fill_mesh.indices.begin() + contour.first_index;
+    indices =
+        _fill_mesh.indices.erase(indices, indices + contour.num_indices);
+    _fill_mesh.indices.insert(indices, _tail_mesh.indices.begin(),
+                              _tail_mesh.indices.end());
+    for (uint32_t i = 0; i < num_indices; i++) {
+        _fill_mesh.indices[contour.first_index + i] += contour.first_vertex;
+    }
+
+    // unsigned arithmetic wraps, so shrinking adds a negative shift
+    const uint32_t vertex_shift = num_vertices - contour.num_vertices;
+    const uint32_t index_shift  = num_indices - contour.num_indices;
+    for (size_t i = contour.first_index + num_indices;
+         i < _fill_mesh.indices.size(); i++) {
+        _fill_mesh.indices[i] += vertex_shift;
+    }
+    for (size_t later = index + 1; later < _fill_contours.size(); later++) {
+        _fill_contours[later].first_vertex += vertex_shift;
+        _fill_contours[later].first_index += index_shift;
+    }
+    contour.num_vertices = num_vertices;
+    contour.num_indices  = num_indices;
+    rewrite              = false;
+    return true;
+}
+
+void IPath::buildFillContours(ITessellator &tessellator) {
+    tessellator.setTolerance(_fill_tolerance);
+    _bounds = {VG_MAX_FLOAT, VG_MAX_FLOAT, -VG_MAX_FLOAT, -VG_MAX_FLOAT};
+    if (!tessellator.tessellateContours(
+            _segments, _coords, getContext().getFillRule(),
+            getContext().getTessellationIterations(), _fill_mesh, _bounds,
+            _fill_contours)) {
+        // overlapping contours are tessellated together every time
+        tessellator.tessellateIndexed(
+            getFlattened(tessellator, _fill_tolerance),
+            getContext().getFillRule(), _fill_mesh, _bounds);
+    }
+    _fill_entry = nullptr;
+    fillBuilt();
+}
+
+const flattened_path_t &IPath::getFlattened(ITessellator &tessellator,
+                                            const VGfloat tolerance) {
+    const uint32_t tess_iterations = getContext().getTessellationIterations();
+    if (!_flattened_valid || tolerance != _flattened_tolerance ||
+        tess_iterations != _flattened_iterations) {
+        tessellator.setTolerance(tolerance);
+        tessellator.flatten(_segments, _coords, tess_iterations, _flattened);
+        _flattened_valid      = true;
+        _flattened_tolerance  = tolerance;
+        _flattened_iterations = tess_iterations;
+    }
+    return _flattened;
+}
+
+tess_cache_key_t IPath::fillCacheKey() {
+    return TessellationCache::fillKey(
+        _segments, _coords, getContext().getFillRule(),
+        getContext().getTessellationIterations(), _fill_tolerance);
+}
+
+tess_cache_key_t IPath::strokeCacheKey() {
+    return TessellationCache::strokeKey(
+        _segments, _coords, strokeStyle(),
+        getContext().getTessellationIterations(), _stroke_tolerance);
+}
+
+bool IPath::findCachedFill() {
+    TessellationCache &cache = getContext().getTessellationCache();
+    if (!cache.isEnabled() && !keepsLods()) {
+        return false;
+    }
+    const tess_cache_key_t key   = fillCacheKey();
+    auto                   entry = findLod(key);
+    if (!entry && cache.isEnabled()) {
+        entry = cache.find(key, _segments, _coords);
+        if (entry) {
+            keepLod(entry);
+        }
+    }
+    if (!entry) {
+        return false;
+    }
+    _fill_entry = std::move(entry);
+    _bounds     = _fill_entry->bounds;
+    _fill_mesh.clear();
+    fillBuilt();
+    return true;
+}
+
+bool IPath::findCachedStroke() {
+    TessellationCache &cache = getContext().getTessellationCache();
+    if ((!cache.isEnabled() && !keepsLods()) || strokeScales()) {
+        return false;
+    }
+    const tess_cache_key_t key   = strokeCacheKey();
+    auto                   entry = findLod(key);
+    if (!entry && cache.isEnabled()) {
+        entry = cache.find(key, _segments, _coords);
+        if (entry) {
+            keepLod(entry);
+        }
+    }
+    if (!entry) {
+        return false;
+    }
+    _stroke_entry = std::move(entry);
+    _stroke_mesh.clear();
+    strokeBuilt();
+    return true;
+}
+
+bool IPath::keepsLods() {
+    // without a tolerance every scale gets the same geometry
+    return getContext().getTessellationLodBudget() > 0 &&
+           getContext().getTessellationTolerance() > 0;
+}
+
+std::shared_ptr<tess_cache_entry_t>
+IPath::findLod(const tess_cache_key_t &key) {
+    for (auto it = _lods.begin(); it != _lods.end(); ++it) {
+        if ((*it)->key == key) {
+            std::rotate(_lods.begin(), it, it + 1);
+            getContext().countLodHit();
+            return _lods.front();
+        }
+    }
+    return nullptr;
+}
+
+void IPath::keepLod(const std::shared_ptr<tess_cache_entry_t> &entry) {
+    if (!keepsLods()) {
+        return;
+    }
+    auto it = std::find(_lods.begin(), _lods.end(), entry);
+    if (it == _lods.end()) {
+        _lods.insert(_lods.begin(), entry);
+    } else {
+        std::rotate(_lods.begin(), it, it + 1);
+    }
+
+    // the newest level always stays
+    const size_t budget = getContext().getTessellationLodBudget();
+    size_t       bytes  = 0;
+    size_t       keep   = 0;
+    for (; keep < _lods.size(); keep++) {
+        bytes += _lods[keep]->bytes();
+        if (keep > 0 && bytes > budget) {
+            break;
+        }
+    }
+    // may run on a thread pool thread. the GPU buffers go on the context
+    // thread.
+    TessellationCache &cache = getContext().getTessellationCache();
+    for (size_t i = keep; i < _lods.size(); i++) {
+        cache.retire(std::move(_lods[i]));
+    }
+    _lods.resize(keep);
+}
+
+void IPath::fillBuilt() {
+    _built_modes |= VG_FILL_PATH;
+    _upload_modes |= VG_FILL_PATH;
+    _fill_rewritten   = false;
+    _fill_shape_steps = 0;
+    _fill_modified.clear();
+
+    // newer than anything still waiting in the background
+    _async_modes &= ~VG_FILL_PATH;
+    if (_async_build) {
+        _async_superseded |= VG_FILL_PATH;
+    }
+}
+
+void IPath::strokeBuilt(const bool scaling) {
+    _built_modes |= VG_STROKE_PATH;
+    _upload_modes |= VG_STROKE_PATH;
+    _stroke_width_dirty = false;
+    _stroke_rescaled    = false;
+    _stroke_scaling     = scaling;
+    if (!scaling) {
+        _stroke_offsets.clear();
+    }
+
+    _async_modes &= ~VG_STROKE_PATH;
+    if (_async_build) {
+        _async_superseded |= VG_STROKE_PATH;
+    }
+}
+
+void IPath::buildFillIfDirty(ITessellator &tessellator) {
+    if (needsFillBuild()) {
+        tessellateFill(tessellator);
+    }
+    setFillDirty(false);
+}
+
+void IPath::buildStrokeIfDirty(ITessellator &tessellator) {
+    if (needsStrokeBuild()) {
+        tessellateStroke(tessellator);
+    }
+    setStrokeDirty(false);
+}
+
+VGbitfield IPath::tessellateInBudget(VGbitfield    modes,
+                                     ITessellator &tessellator) {
+    TessellationScheduler &scheduler = getContext().getTessellationScheduler();
+    if (!scheduler.isEnabled() || getContext().currentBatch()) {
+        if (modes & VG_FILL_PATH) {
+            tessellateFill(tessellator);
+        }
+        if (modes & VG_STROKE_PATH) {
+            tessellateStroke(tessellator);
+        }
+        return 0;
+    }
+
+    // cached geometry costs next to nothing
+    if ((modes & VG_FILL_PATH) && !_shape.isShape() && !_fill_growing &&
+        !_fill_editing && findCachedFill()) {
+        modes &= ~VG_FILL_PATH;
+    }
+    if ((modes & VG_STROKE_PATH) &&
+        (rescaleStroke(tessellator) || findCachedStroke())) {
+        modes &= ~VG_STROKE_PATH;
+    }
+    if (modes == 0) {
+        return 0;
+    }
+
+    const size_t cost = _segments.size();
+    if (!scheduler.admit(this, cost)) {
+        const bounding_box_t bounds =
+            (_built_modes & VG_FILL_PATH) ? _bounds : controlBounds();
+        const Matrix33 &m    = getContext().getPathUserToSurface();
+        const VGfloat   area = std::max(bounds.width, 0.0f) *
+                             std::max(bounds.height, 0.0f) *
+                             fabsf(m.a * m.d - m.b * m.c);
+        scheduler.defer(this, area, cost);
+        return modes;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    if (modes & VG_FILL_PATH) {
+        buildFill(tessellator);
+    }
+    if (modes & VG_STROKE_PATH) {
+        buildStroke(tessellator);
+    }
+    scheduler.spent(cost, std::chrono::duration<double, std::micro>(
+                              std::chrono::steady_clock::now() - start)
+                              .count());
+    return 0;
+}
+
+bounding_box_t IPath::controlBounds() {
+    bounding_box_t bounds = {VG_MAX_FLOAT, VG_MAX_FLOAT, -VG_MAX_FLOAT,
+                             -VG_MAX_FLOAT};
+    _coords.visit([&](auto coords) {
+        VGfloat x = 0, y = 0, start_x = 0, start_y = 0;
+        for (const VGubyte segment : _segments) {
+            const VGubyte command = segment & ~VG_RELATIVE;
+            const VGfloat ox      = (segment & VG_RELATIVE) ? x : 0;
+            const VGfloat oy      = (segment & VG_RELATIVE) ? y : 0;
+            const uint32_t n =
+                segmentToNumCoordinates(static_cast<VGPathSegment>(segment));
+            switch (command) {
+            case VG_CLOSE_PATH:
+                x = start_x;
+                y = start_y;
+                break;
+            case VG_HLINE_TO:
+                x = ox + coords[0];
+                break;
+            case VG_VLINE_TO:
+                y = oy + coords[0];
+                break;
+            case VG_SCCWARC_TO:
+            case VG_SCWARC_TO:
+            case VG_LCCWARC_TO:
+            case VG_LCWARC_TO: {
+                // the arc stays within its diameter of the end point
+                const VGfloat r =
+                    2 * std::max(fabsf(coords[0]), fabsf(coords[1]));
+                x = ox + coords[3];
+                y = oy + coords[4];
+                bounds.update(x - r, y - r);
+                bounds.update(x + r, y + r);
+                break;
+            }
+            default:
+                for (uint32_t i = 0; i + 2 < n; i += 2) {
+                    bounds.update(ox + coords[i], oy + coords[i + 1]);
+                }
+                x = ox + coords[n - 2];
+                y = oy + coords[n - 1];
+                break;
+            }
+            if (command == VG_MOVE_TO) {
+                start_x = x;
+                start_y = y;
+            }
+            bounds.update(x, y);
+            coords += n;
+        }
+    });
+    return bounds;
+}
+
+void IPath::buildForDraw(const VGbitfield paint_modes) {
+    ITessellator &tessellator = getContext().getTessellator();
+    getContext().getTessellationCache().releaseEvicted();
+
+    // paths deferred by the frame budget stay dirty and draw what they
+    // were built with before, if anything
+    if (!getContext().getTessellationAsync() || getContext().currentBatch()) {
+        VGbitfield modes = 0;
+        if ((paint_modes & VG_FILL_PATH) && needsFillBuild()) {
+            modes |= VG_FILL_PATH;
+        }
+        if ((paint_modes & VG_STROKE_PATH) && needsStrokeBuild()) {
+            modes |= VG_STROKE_PATH;
+        }
+        const VGbitfield deferred = tessellateInBudget(modes, tessellator);
+        if (paint_modes & VG_FILL_PATH) {
+            setFillDirty((deferred & VG_FILL_PATH) != 0);
+        }
+        if (paint_modes & VG_STROKE_PATH) {
+            setStrokeDirty((deferred & VG_STROKE_PATH) != 0);
+        }
+        buildBuffers(paint_modes);
+        return;
+    }
+
+    takeAsyncBuild();
+
+    // rebuild in the background if there is something to draw meanwhile.
+    // the first build has nothing to fall back on so it happens right away.
+    // cached geometry and VGU primitives are picked up right away.
+    VGbitfield now = 0;
+    if ((paint_modes & VG_FILL_PATH) && needsFillBuild()) {
+        if (!(_built_modes & VG_FILL_PATH) || _shape.isShape()) {
+            now |= VG_FILL_PATH;
+        } else if (_fill_editing   ? !modifyFill(tessellator)
+                   : _fill_growing ? !appendFill(tessellator)
+                                   : !findCachedFill()) {
+            _async_modes |= VG_FILL_PATH;
+        }
+    }
+    if ((paint_modes & VG_STROKE_PATH) && needsStrokeBuild()) {
+        if (!(_built_modes & VG_STROKE_PATH) || _stroke_on_gpu) {
+            now |= VG_STROKE_PATH;
+        } else if (!rescaleStroke(tessellator) && !findCachedStroke()) {
+            _async_modes |= VG_STROKE_PATH;
+            _async_stroke_scaling = strokeScales();
+            _stroke_width_dirty   = false;
+        }
+    }
+    // modes not drawn stay dirty for their next draw or vgPathBounds
+    const VGbitfield deferred = tessellateInBudget(now, tessellator);
+    if (paint_modes & VG_FILL_PATH) {
+        setFillDirty((deferred & VG_FILL_PATH) != 0);
+    }
+    if (paint_modes & VG_STROKE_PATH) {
+        setStrokeDirty((deferred & VG_STROKE_PATH) != 0);
+    }
+
+    // one build in flight per path. edits made meanwhile are collected in
+    // _async_modes and queued once it is picked up.
+    if (_async_modes != 0 && !_async_build) {
+        submitAsyncBuild();
+    }
+
+    buildBuffers(paint_modes);
+}
+
+void IPath::submitAsyncBuild() {
+    auto build              = std::make_shared<async_build_t>();
+    build->segments         = _segments;
+    build->coords           = _coords;
+    build->paint_modes      = _async_modes;
+    build->fill_rule        = getContext().getFillRule();
+    build->tess_iterations  = getContext().getTessellationIterations();
+    build->fill_tolerance   = _fill_tolerance;
+    build->stroke_tolerance = _stroke_tolerance;
+    build->stroke_style     = strokeStyle();
+    build->stroke_scaling   = _async_stroke_scaling;
+    build->fill_by_contour  = _fill_editing;
+
+    // modified from here on. See: modifyFill()
+    if (_async_modes & VG_FILL_PATH) {
+        _fill_modified.clear();
+    }
+    _async_modes = 0;
+    _async_build = build;
+    getContext().getTessellationWorker().submit(std::move(build));
+}
+
+void IPath::takeAsyncBuild() {
+    if (!_async_build ||
+        !_async_build->done.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::shared_ptr<async_build_t> build = std::move(_async_build);
+    _async_build                         = nullptr;
+    const VGbitfield modes = build->paint_modes & ~_async_superseded;
+    _async_superseded      = 0;
+    if (build->error) {
+        std::rethrow_exception(build->error);
+    }
+
+    TessellationCache &cache = getContext().getTessellationCache();
+    if (modes & VG_FILL_PATH) {
+        if ((cache.isEnabled() || keepsLods()) && !_fill_growing &&
+            !_fill_editing) {
+            auto entry    = std::make_shared<tess_cache_entry_t>();
+            entry->key    = TessellationCache::fillKey(
+                build->segments, build->coords, build->fill_rule,
+                build->tess_iterations, build->fill_tolerance);
+            entry->bounds = build->bounds;
+            std::swap(entry->fill_mesh, build->fill_mesh);
+            if (cache.isEnabled()) {
+                entry->segments = build->segments;
+                entry->coords   = build->coords;
+                cache.insert(entry);
+            }
+            keepLod(entry);
+            _fill_entry = std::move(entry);
+            _fill_mesh.clear();
+        } else {
+            std::swap(_fill_mesh, build->fill_mesh);
+            _fill_entry = nullptr;
+        }
+        if (_fill_growing) {
+            _fill_built_segments    = build->segments.size();
+            _fill_built_coords      = build->coords.size();
+            _fill_uploaded_vertices = 0;
+            _fill_uploaded_indices  = 0;
+        }
+        std::swap(_fill_contours, build->fill_contours);
+        _bounds           = build->bounds;
+        _fill_rewritten   = false;
+        _fill_shape_steps = 0;
+        _upload_modes |= VG_FILL_PATH;
+    }
+    if (modes & VG_STROKE_PATH) {
+        _stroke_rescaled = false;
+        _stroke_scaling  = build->stroke_scaling;
+        std::swap(_stroke_offsets, build->stroke_offsets);
+        if (build->stroke_scaling) {
+            std::swap(_stroke_mesh, build->stroke_mesh);
+            _stroke_entry = nullptr;
+        } else if (cache.isEnabled() || keepsLods()) {
+            auto entry = std::make_shared<tess_cache_entry_t>();
+            entry->key = TessellationCache::strokeKey(
+                build->segments, build->coords, build->stroke_style,
+                build->tess_iterations, build->stroke_tolerance);
+            std::swap(entry->stroke_mesh, build->stroke_mesh);
+            if (cache.isEnabled()) {
+                entry->segments = std::move(build->segments);
+                entry->coords   = std::move(build->coords);
+                cache.insert(entry);
+            }
+            keepLod(entry);
+            _stroke_entry = std::move(entry);
+            _stroke_mesh.clear();
+        } else {
+            std::swap(_stroke_mesh, build->stroke_mesh);
+            _stroke_entry = nullptr;
+        }
+        _upload_modes |= VG_STROKE_PATH;
     }
 }
 
@@ -130,8 +1279,8 @@ void IPath::setParameter(const VGint p, const VGint v) {
     case VG_PATH_FORMAT:
         setFormat(v);
         break;
-    case VG_PATH_DATATYPE:
-        setDataType(static_cast<VGPathDatatype>(v));
+    case VG_PATH_DATATYPE: // the stored coordinates are encoded with it
+        SetError(VG_ILLEGAL_ARGUMENT_ERROR);
         break;
     case VG_PATH_NUM_SEGMENTS:
         setNumSegments(v);
@@ -146,11 +1295,9 @@ void IPath::setParameter(const VGint p, const VGint v) {
 
 void IPath::setParameter(const VGint p, const VGfloat v) {
     switch (p) {
-    case VG_PATH_SCALE:
-        setScale(v);
-        break;
+    case VG_PATH_SCALE: // the stored coordinates are encoded with them
     case VG_PATH_BIAS:
-        setBias(v);
+        SetError(VG_ILLEGAL_ARGUMENT_ERROR);
         break;
     default:
         break;
@@ -172,6 +1319,10 @@ VG_API_CALL VGPath vgCreatePath(VGint pathFormat, VGPathDatatype datatype,
                                 VGint      segmentCapacityHint,
                                 VGint      coordCapacityHint,
                                 VGbitfield capabilities) {
+    if (path_coords_t::datatypeSize(datatype) == 0 || scale == 0) {
+        SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+        return VG_INVALID_HANDLE;
+    }
     IPath *path = IContext::instance().createPath(
         pathFormat, datatype, scale, bias, segmentCapacityHint,
         coordCapacityHint, capabilities &= VG_PATH_CAPABILITY_ALL);
@@ -184,10 +1335,28 @@ VG_API_CALL void VG_API_ENTRY vgDestroyPath(VGPath path) VG_API_EXIT {
         SetError(VG_BAD_HANDLE_ERROR);
         return;
     }
+    // a new path may get the same address
+    IContext::instance().getTessellationScheduler().forget((IPath *)path);
     IContext::instance().destroyPath((IPath *)path);
     path = VG_INVALID_HANDLE;
 }
 
+namespace {
+// the segments are valid and the coordinates they take are in pathData,
+// aligned to the path datatype
+bool validPathData(const IPath &path, const VGint numSegments,
+                   const VGubyte *pathSegments, const void *pathData,
+                   size_t &numCoords) {
+    if (numSegments <= 0 || pathSegments == nullptr ||
+        !IPath::countCoordinates(numSegments, pathSegments, numCoords)) {
+        return false;
+    }
+    const size_t align = path_coords_t::datatypeSize(path.getDataType());
+    return numCoords == 0 ||
+           (pathData != nullptr && (uintptr_t)pathData % align == 0);
+}
+} // namespace
+
 VG_API_CALL void vgAppendPathData(VGPath dstPath, VGint numSegments,
                                   const VGubyte *pathSegments,
                                   const void    *pathData) {
@@ -195,13 +1364,57 @@ VG_API_CALL void vgAppendPathData(VGPath dstPath, VGint numSegments,
         SetError(VG_BAD_HANDLE_ERROR);
         return;
     }
-    if (numSegments <= 0) {
+    IPath *path       = (IPath *)dstPath;
+    size_t num_coords = 0;
+    if (!validPathData(*path, numSegments, pathSegments, pathData,
+                       num_coords)) {
         SetError(VG_ILLEGAL_ARGUMENT_ERROR);
         return;
     }
+    path->appendData(numSegments, pathSegments, pathData, num_coords);
+}
 
-    IPath *path = (IPath *)dstPath;
-    path->appendData(numSegments, pathSegments, pathData);
+VG_API_CALL void VG_API_ENTRY vgAppendPathDataNoCopyMNK(
+    VGPath dstPath, VGint numSegments, const VGubyte *pathSegments,
+    const void *pathData, VGPathDataReleaseMNK release,
+    void *userData) VG_API_EXIT {
+    // released with the last copy of the coordinates, or right away if
+    // they are copied or rejected
+    std::shared_ptr<const uint8_t> data(
+        static_cast<const uint8_t *>(pathData),
+        [release, userData](const uint8_t *) {
+            if (release) {
+                release(userData);
+            }
+        });
+    if (dstPath == VG_INVALID_HANDLE) {
+        SetError(VG_BAD_HANDLE_ERROR);
+        return;
+    }
+    IPath *path       = (IPath *)dstPath;
+    size_t num_coords = 0;
+    if (!validPathData(*path, numSegments, pathSegments, pathData,
+                       num_coords)) {
+        SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+        return;
+    }
+    path->appendData(numSegments, pathSegments, std::move(data), num_coords);
+}
+
+VG_API_CALL void VG_API_ENTRY vgModifyPathCoords(
+    VGPath dstPath, VGint startIndex, VGint numSegments,
+    const void *pathData) VG_API_EXIT {
+    if (dstPath == VG_INVALID_HANDLE) {
+        SetError(VG_BAD_HANDLE_ERROR);
+        return;
+    }
+    IPath       *path  = (IPath *)dstPath;
+    const size_t align = path_coords_t::datatypeSize(path->getDataType());
+    if (startIndex < 0 || numSegments <= 0 || pathData == nullptr ||
+        (uintptr_t)pathData % align != 0 ||
+        !path->modifyCoords(startIndex, numSegments, pathData)) {
+        SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+    }
 }
 
 VG_API_CALL void vgDrawPath(VGPath path, VGbitfield paintModes) {
@@ -221,6 +1434,42 @@ VG_API_CALL void vgDrawPath(VGPath path, VGbitfield paintModes) {
     p->draw(paintModes);
 }
 
+VG_API_CALL void VG_API_ENTRY vgPrepareDrawPathsMNK(
+    VGint count, const VGPath *paths, VGbitfield paintModes) VG_API_EXIT {
+    if (count < 0 || (count > 0 && paths == nullptr) ||
+        (paintModes & ~(VG_FILL_PATH | VG_STROKE_PATH)) != 0) {
+        SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+        return;
+    }
+
+    std::vector<IPath *> prepare(count);
+    for (VGint i = 0; i < count; i++) {
+        if (paths[i] == VG_INVALID_HANDLE) {
+            SetError(VG_BAD_HANDLE_ERROR);
+            return;
+        }
+        prepare[i] = (IPath *)paths[i];
+    }
+
+    IContext::instance().prepareDrawPaths(prepare.data(), prepare.size(),
+                                          paintModes);
+}
+
+VG_API_CALL void VG_API_ENTRY vgPreparePathMNK(
+    VGPath path, VGbitfield paintModes) VG_API_EXIT {
+    if (path == VG_INVALID_HANDLE) {
+        SetError(VG_BAD_HANDLE_ERROR);
+        return;
+    }
+    if ((paintModes & ~(VG_FILL_PATH | VG_STROKE_PATH)) != 0) {
+        SetError(VG_ILLEGAL_ARGUMENT_ERROR);
+        return;
+    }
+
+    IPath *p = (IPath *)path;
+    IContext::instance().prepareDrawPaths(&p, 1, paintModes);
+}
+
 VG_API_CALL void VG_API_ENTRY vgClearPath(VGPath     path,
                                           VGbitfield capabilities) VG_API_EXIT {
     if (path == VG_INVALID_HANDLE) {
@@ -239,7 +1488,8 @@ VG_API_CALL void VG_API_ENTRY vgTransformPath(VGPath dstPath,
         return;
     }
     IPath *dp = (IPath *)dstPath;
-    dp->copy(*(IPath *)srcPath, IContext::instance().getPathUserToSurface());
+    dp->transform(*(IPath *)srcPath,
+                  IContext::instance().getPathUserToSurface());
 }
 
 VG_API_CALL void VG_API_ENTRY vgPathBounds(VGPath path, VGfloat *minX,
@@ -251,8 +1501,9 @@ VG_API_CALL void VG_API_ENTRY vgPathBounds(VGPath path, VGfloat *minX,
         return;
     }
     IPath *p = (IPath *)path;
-    p->buildFillIfDirty(); // NOTE: according to the OpenVG specs we only care
-                           // about the fill bounds, NOT the fill + stroke
+    // NOTE: according to the OpenVG specs we only care about the fill bounds,
+    // NOT the fill + stroke
+    p->buildFillIfDirty(IContext::instance().getTessellator());
     *minX   = p->getMinX();
     *minY   = p->getMinY();
     *width  = p->getWidth();
@@ -268,8 +1519,9 @@ vgPathTransformedBounds(VGPath path, VGfloat *minX, VGfloat *minY,
         return;
     }
     IPath *p = (IPath *)path;
-    p->buildFillIfDirty(); // NOTE: according to the OpenVG specs we only care
-                           // about the fill bounds, NOT the fill + stroke
+    // NOTE: according to the OpenVG specs we only care about the fill bounds,
+    // NOT the fill + stroke
+    p->buildFillIfDirty(IContext::instance().getTessellator());
     float x = p->getMinX();
     float y = p->getMinX();
     float w = p->getWidth();
@@ -13,6 +13,10 @@
 #include "mkBaseObject.h"
 #include "mkMath.h"
 #include "mkTessellator.h"
+#include "mkTessellationCache.h"
+#include "mkTessellationWorker.h"
+#include <algorithm>
+#include <memory>
 #include <vector>
 
 namespace MonkVG {
@@ -34,23 +38,28 @@ class IPath : public BaseObject {
     /// @param caps VGbitfield of VG_PATH_CAPABILITY
     virtual void clear(VGbitfield caps);
 
-    /// @brief Build the fill if the path is dirty
-    virtual void buildFillIfDirty() = 0;
+    /// @brief Build the fill if the path is dirty. Only touches this path, so
+    /// different paths can be built on different threads each with their
+    /// own tessellator.
+    /// @param tessellator the tessellator to build with
+    void buildFillIfDirty(ITessellator &tessellator);
 
-    /// @brief Build the stroke if the path is dirty
-    virtual void buildStrokeIfDirty() = 0;
+    /// @brief Build the stroke if the path is dirty. See: buildFillIfDirty()
+    /// @param tessellator the tessellator to build with
+    void buildStrokeIfDirty(ITessellator &tessellator);
+
+    /// @brief Upload the fill and stroke built by buildFillIfDirty() and
+    /// buildStrokeIfDirty() to the GPU. Must run on the context thread.
+    /// @param paintModes VGbitfield of VG_FILL_PATH and/or VG_STROKE_PATH
+    virtual void buildBuffers(VGbitfield paintModes) = 0;
 
     inline VGint getFormat() const { return _format; }
     inline void  setFormat(const VGint format) { _format = format; }
 
-    inline VGPathDatatype getDataType() const { return _datatype; }
-    inline void           setDataType(const VGPathDatatype d) { _datatype = d; }
-
-    inline VGfloat getScale() const { return _scale; }
-    inline void    setScale(const VGfloat scale) { _scale = scale; }
-
-    inline VGfloat getBias() const { return _bias; }
-    inline void    setBias(const VGfloat bias) { _bias = bias; }
+    // fixed at creation. the stored coordinates are encoded with them.
+    inline VGPathDatatype getDataType() const { return _coords.datatype; }
+    inline VGfloat        getScale() const { return _coords.scale; }
+    inline VGfloat        getBias() const { return _coords.bias; }
 
     inline VGint getNumSegments() const { return _num_segments; }
     inline void  setNumSegments(const VGint num_segments) {
@@ -89,33 +98,123 @@ class IPath : public BaseObject {
 
     //// internal data manipulators ////
 
-    /// @brief Append data to the path
+    /// @brief Append data to the path. The coordinates are stored as they
+    /// are in the path datatype, in one copy.
     /// @param numSegments the number of segments
     /// @param pathSegments the segments
-    /// @param pathData the path data
-    void appendData(const VGint numSegments, const VGubyte *pathSegments,
-                    const void *pathData);
+    /// @param pathData the path data in the path datatype
+    /// @param numCoords the coordinates the segments take. See:
+    /// countCoordinates()
+    void appendData(VGint numSegments, const VGubyte *pathSegments,
+                    const void *pathData, size_t numCoords);
+
+    /// @brief Append data to the path, reading the coordinates out of
+    /// pathData in place if the path has none yet. pathData is released
+    /// once the path and every copy of its coordinates, cached or in a
+    /// background build, are done with it. Copied otherwise.
+    void appendData(VGint numSegments, const VGubyte *pathSegments,
+                    std::shared_ptr<const uint8_t> pathData,
+                    size_t numCoords);
+
+    /// @brief Count the coordinates numSegments segments take. Returns
+    /// false if one of them is not a VGPathSegment.
+    static bool countCoordinates(VGint numSegments, const VGubyte *pathSegments,
+                                 size_t &numCoords);
+
+    /// @brief Overwrite the coordinates of numSegments segments from segment
+    /// startIndex on. See: vgModifyPathCoords. A fill that was built is then
+    /// tessellated again only for the contours holding those segments where
+    /// possible. See: modifyFill()
+    /// @param startIndex the first segment
+    /// @param numSegments the number of segments
+    /// @param pathData the new coordinates in the path datatype
+    /// @return false if the segments are not all in the path
+    bool modifyCoords(VGint startIndex, VGint numSegments,
+                      const void *pathData);
+
+    /// @brief Record the VGU primitive that was just appended as
+    /// num_segments segments so its fill is generated from the shape. Does
+    /// nothing if the path holds more than the primitive. Any later change
+    /// to the path data drops it. See: ITessellator::tessellateShape
+    void setShape(const shape_descriptor_t &shape, size_t num_segments);
+    inline const shape_descriptor_t &getShape() const { return _shape; }
 
     /// @brief Get the number of coordinates for a segment type.
     /// different segments have different number of coordinates.
     /// @param segment
     /// @return
-    uint32_t segmentToNumCoordinates(VGPathSegment segment);
+    static uint32_t segmentToNumCoordinates(VGPathSegment segment);
 
-    /// @brief Copy the path data from src to this path
-    /// with a transformation matrix.
+    /// @brief Append the path data of src, which may be this path,
+    /// transformed by a matrix. See: vgTransformPath. Horizontal and
+    /// vertical lines become lines, relative coordinates take only the
+    /// linear part of the matrix and arcs get new radii and rotation, and
+    /// the other direction if the matrix mirrors. The coordinates are
+    /// written into this path's datatype, scale and bias in one pass
+    /// after a single allocation.
     /// @param src the source path
     /// @param transform the transformation matrix
-    void copy(const IPath &src, const Matrix33 &transform);
+    void transform(const IPath &src, const Matrix33 &transform);
 
   protected:
+    /// @brief Build what paintModes needs and upload it. With
+    /// VG_TESSELLATION_ASYNC_MNK on, rebuilds of geometry that was already
+    /// built run on the context's TessellationWorker and the last built
+    /// geometry is drawn until they are done.
+    /// @param paintModes VGbitfield of VG_FILL_PATH and/or VG_STROKE_PATH
+    void buildForDraw(VGbitfield paintModes);
+
+    /// @brief true if the path keeps the levels of detail it was drawn at,
+    /// GPU buffers included. See: VG_TESSELLATION_LOD_BUDGET_MNK
+    bool keepsLods();
+
+    /// @brief The fill geometry waiting for buildBuffers()
+    inline const indexed_mesh_t &getFillMesh() const {
+        return _fill_entry ? _fill_entry->fill_mesh : _fill_mesh;
+    }
+
+    /// @brief The stroke geometry waiting for buildBuffers()
+    inline const indexed_mesh_t &getStrokeMesh() const {
+        return _stroke_entry ? _stroke_entry->stroke_mesh : _stroke_mesh;
+    }
+
+    /// @brief The segments of a stroke expanded on the GPU waiting for
+    /// buildBuffers(). See: expandsStrokeOnGpu()
+    inline const std::vector<stroke_segment_t> &getStrokeSegments() const {
+        return _stroke_segments;
+    }
+
+    /// @brief true if the stroke is drawn from its line segments with the
+    /// stroke expanded on the GPU for the current context settings. The
+    /// stroke is then built with ITessellator::buildStrokeSegments, which
+    /// stroke style changes do not invalidate, and skips the caches.
+    virtual bool expandsStrokeOnGpu() { return false; }
+
+    /// @brief true if the backend draws line list stroke meshes. See:
+    /// VG_STROKE_HAIRLINE_WIDTH_MNK
+    virtual bool drawsHairlines() { return false; }
+
+    /// @brief true if the backend draws round rects and ellipses from a
+    /// shared mesh of rounded corners for the current context settings. The
+    /// fill is then only measured, with ITessellator::measureShape, and
+    /// drawn from _fill_shape and _fill_shape_steps.
+    virtual bool drawsRoundShapes() { return false; }
+
+    /// @brief Pick up the current fill paint. Returns true if it changed
+    /// and the fill has to be rebuilt.
+    virtual bool updateFillPaint() = 0;
+
+    /// @brief Pick up the current stroke paint. Returns true if it changed
+    /// and the stroke has to be rebuilt.
+    virtual bool updateStrokePaint() = 0;
+
     /// @brief Constructor
     /// @param format VG_PATH_FORMAT
     /// @param datatype VG_PATH_DATATYPE
     /// @param scale VG_PATH_SCALE
     /// @param bias VG_PATH_BIAS
-    /// @param num_segments VG_PATH_NUM_SEGMENTS
-    /// @param num_coords VG_PATH_NUM_COORDS
+    /// @param num_segments segments to reserve room for
+    /// @param num_coords coordinates to reserve room for
     /// @param capabilities VG_PATH_CAPABILITY
     /// @param context the MonkVG context
     explicit IPath(VGint format, VGPathDatatype datatype, VGfloat scale,
@@ -123,45 +222,232 @@ class IPath : public BaseObject {
                    VGbitfield capabilities, IContext &context)
         : BaseObject(context),
           _format(format),
-          _datatype(datatype),
-          _scale(scale),
-          _bias(bias),
-          _num_segments(num_segments),
-          _num_coords(num_coords),
+          _num_segments(0),
+          _num_coords(0),
           _capabilities(capabilities),
           _is_fill_dirty(true),
           _is_stroke_dirty(true) {
-        switch (_datatype) {
-        case VG_PATH_DATATYPE_F:
-            _fcoords = std::vector<float>(_num_coords);
-            break;
-        default:
-            // error
-            throw std::runtime_error(
-                "Unsupported path data type. Currently only VG_PATH_DATATYPE_F "
-                "is supported.");
-            break;
+        if (path_coords_t::datatypeSize(datatype) == 0) {
+            throw std::runtime_error("Unsupported path data type.");
         }
+        _coords.datatype = datatype;
+        _coords.scale    = scale;
+        _coords.bias     = bias;
+        _segments.reserve(std::max(num_segments, 0));
+        _coords.data.reserve(std::max(num_coords, 0) * _coords.coordSize());
         _bounds.min_x = _bounds.min_y = VG_MAX_FLOAT;
         _bounds.width = _bounds.height = -VG_MAX_FLOAT;
     }
 
   protected:
-    VGint          _format;       // VG_PATH_FORMAT
-    VGPathDatatype _datatype;     // VG_PATH_DATATYPE
-    VGfloat        _scale;        // VG_PATH_SCALE
-    VGfloat        _bias;         // VG_PATH_BIAS
-    VGint          _num_segments; // VG_PATH_NUM_SEGMENTS
-    VGint          _num_coords;   // VG_PATH_NUM_COORDS
-    VGbitfield     _capabilities;
-
-    // data
+    VGint      _format;       // VG_PATH_FORMAT
+    VGint      _num_segments; // VG_PATH_NUM_SEGMENTS
+    VGint      _num_coords;   // VG_PATH_NUM_COORDS
+    VGbitfield _capabilities;
+
+    // data. the coordinates hold VG_PATH_DATATYPE, VG_PATH_SCALE and
+    // VG_PATH_BIAS.
     std::vector<VGubyte> _segments;
-    std::vector<VGfloat> _fcoords;
+    path_coords_t        _coords;
     bool                 _is_fill_dirty;
     bool                 _is_stroke_dirty;
+    shape_descriptor_t   _shape = {}; // See: setShape()
+
+    // the fill is drawn from the shared round shape mesh as _fill_shape
+    // with this many segments per corner. 0 if it was built as a mesh.
+    // See: drawsRoundShapes()
+    bool               _fill_round_shape = false;
+    uint32_t           _fill_shape_steps = 0;
+    shape_descriptor_t _fill_shape       = {};
+
+    // user space flattening tolerance the fill and stroke were built with.
+    // See: IContext::getPathTessellationTolerance()
+    VGfloat _fill_tolerance   = 0;
+    VGfloat _stroke_tolerance = 0;
+
+    // fill rule and stroke style the fill and stroke were built with
+    VGFillRule     _fill_rule    = VG_EVEN_ODD;
+    stroke_style_t _stroke_style = {};
+
+    // tessellated geometry waiting for buildBuffers(). a cache entry is used
+    // instead of the mesh when set. See: getFillMesh()
+    indexed_mesh_t                      _fill_mesh    = {};
+    indexed_mesh_t                      _stroke_mesh  = {};
+    std::shared_ptr<tess_cache_entry_t> _fill_entry   = nullptr;
+    std::shared_ptr<tess_cache_entry_t> _stroke_entry = nullptr;
+
+    // the stroke was built as segments for the GPU to expand. See:
+    // expandsStrokeOnGpu()
+    bool                          _stroke_on_gpu   = false;
+    std::vector<stroke_segment_t> _stroke_segments = {};
+
+    // strokes rebuilt because only their width changed are built privately
+    // with their offsets and stay in _stroke_mesh after buildBuffers(), so
+    // the next width only moves their vertices. See: rescaleStroke()
+    bool             _stroke_width_dirty = false; // nothing else changed
+    bool             _stroke_scaling     = false; // _stroke_offsets are set
+    bool             _stroke_rescaled    = false; // only vertices changed
+    stroke_offsets_t _stroke_offsets     = {};
+
+    VGbitfield _built_modes  = 0; // paint modes built at least once
+    VGbitfield _upload_modes = 0; // paint modes waiting for buildBuffers()
+
+    // paths appended to after their fill was built are growing. their fill
+    // is built privately, stays in _fill_mesh after buildBuffers() and is
+    // extended by the appended contours where possible. See: appendFill()
+    bool     _fill_growing           = false;
+    size_t   _fill_built_segments    = 0; // path data _fill_mesh covers. 0
+    size_t   _fill_built_coords      = 0; // if it is not a growing fill.
+    uint32_t _fill_uploaded_vertices = 0; // _fill_mesh prefix on the GPU
+    uint32_t _fill_uploaded_indices  = 0;
+
+    // paths whose coordinates are modified after their fill was built are
+    // editing. their fill is built contour by contour, stays in _fill_mesh
+    // after buildBuffers() and only the contours holding modified segments
+    // are tessellated again where possible. See: modifyFill()
+    bool _fill_editing = false;
+
+    // first and end segment of each modification since the fill was built
+    std::vector<std::pair<size_t, size_t>> _fill_modified = {};
+
+    // only these ranges of _fill_mesh changed since it was uploaded, with
+    // the same vertex and index counts
+    bool     _fill_rewritten            = false;
+    uint32_t _fill_rewrite_first_vertex = 0;
+    uint32_t _fill_rewrite_end_vertex   = 0;
+    uint32_t _fill_rewrite_first_index  = 0;
+    uint32_t _fill_rewrite_end_index    = 0;
+
+    // background rebuilds. See: buildForDraw()
+    VGbitfield                     _async_modes = 0; // waiting to be queued
+    std::shared_ptr<async_build_t> _async_build = nullptr; // in flight
+    VGbitfield _async_superseded = 0; // rebuilt since _async_build was queued
+    bool _async_stroke_scaling = false; // the queued stroke records offsets
+
+  private:
+    /// @brief update the dirty flag from the paint and tolerance and return
+    /// true if the fill needs a rebuild
+    bool needsFillBuild();
+    bool needsStrokeBuild();
+
+    /// @brief the context's stroke style, or a hairline style that any
+    /// width under the hairline width shares if the backend draws them
+    stroke_style_t strokeStyle();
+
+    /// @brief use cached geometry or build it
+    void tessellateFill(ITessellator &tessellator);
+    void tessellateStroke(ITessellator &tessellator);
+
+    /// @brief build without looking in the caches
+    void buildFill(ITessellator &tessellator);
+    void buildStroke(ITessellator &tessellator);
+
+    /// @brief tessellateFill() and/or tessellateStroke() for the paint
+    /// modes in modes if the frame's tessellation budget allows. Cached
+    /// geometry is picked up either way. Returns the paint modes that were
+    /// deferred. See: TessellationScheduler
+    VGbitfield tessellateInBudget(VGbitfield modes, ITessellator &tessellator);
+
+    /// @brief bounds of the end and control points. Contains the path
+    /// without flattening it, for arcs only roughly.
+    bounding_box_t controlBounds();
+
+    /// @brief the path data flattened for both the fill and the stroke.
+    /// Only flattened again after the path data, the tolerance or the
+    /// tessellation iterations changed, so paint and stroke width changes
+    /// reuse it.
+    const flattened_path_t &getFlattened(ITessellator &tessellator,
+                                         VGfloat       tolerance);
+
+    /// @brief tessellate the contours appended since the growing fill was
+    /// built on their own and add them to _fill_mesh. Returns false if they
+    /// are not complete contours or overlap the fill, which then needs a
+    /// full rebuild.
+    bool appendFill(ITessellator &tessellator);
+
+    /// @brief tessellate the contours of an editing fill holding segments
+    /// modified since it was built again on their own and put them in place
+    /// in _fill_mesh. Returns false if the fill was not built contour by
+    /// contour or a modified contour now overlaps another one, which then
+    /// needs buildFillContours().
+    bool modifyFill(ITessellator &tessellator);
+
+    /// @brief tessellate _fill_contours[index] again for modifyFill().
+    /// Clears rewrite if the contours after it moved. Returns false if it
+    /// now overlaps another contour.
+    bool modifyContour(ITessellator &tessellator, size_t index,
+                       bool &rewrite);
+
+    /// @brief build an editing fill contour by contour, or whole if its
+    /// contours overlap. See: ITessellator::tessellateContours
+    void buildFillContours(ITessellator &tessellator);
+
+    /// @brief use a level of detail the path kept or the context's cached
+    /// geometry if there is any. Returns true if found.
+    bool findCachedFill();
+    bool findCachedStroke();
+
+    /// @brief the kept level of detail built with key or nullptr. Counts a
+    /// hit. See: _lods
+    std::shared_ptr<tess_cache_entry_t> findLod(const tess_cache_key_t &key);
+
+    /// @brief keep a fill or stroke as the most recently used level of
+    /// detail and drop the least recently used ones over the budget
+    void keepLod(const std::shared_ptr<tess_cache_entry_t> &entry);
+    tess_cache_key_t fillCacheKey();
+    tess_cache_key_t strokeCacheKey();
+
+    /// @brief the fill or stroke was rebuilt and waits for buildBuffers().
+    /// scaling if the stroke was built with its offsets.
+    void fillBuilt();
+    void strokeBuilt(bool scaling = false);
+
+    /// @brief true if only the stroke width changed since the stroke was
+    /// built. Such strokes skip the caches.
+    bool strokeScales();
+
+    /// @brief move the vertices of a stroke built with its offsets to the
+    /// new width. Returns false if it has to be stroked again. See:
+    /// ITessellator::rescaleStroke
+    bool rescaleStroke(ITessellator &tessellator);
+
+    /// @brief add the segments of appended data and invalidate what was
+    /// built from the path data before
+    void appendSegments(VGint numSegments, const VGubyte *pathSegments,
+                        size_t numCoords);
+
+    /// @brief invalidate what was built from the path data before
+    /// numSegments segments and numCoords coordinates were added to it
+    void segmentsAppended(VGint numSegments, size_t numCoords);
+
+    /// @brief queue the paint modes in _async_modes on the worker
+    void submitAsyncBuild();
+
+    /// @brief swap in the results of a finished background build
+    void takeAsyncBuild();
 
     bounding_box_t _bounds;
+
+    // See: getFlattened()
+    flattened_path_t _flattened            = {};
+    bool             _flattened_valid      = false;
+    VGfloat          _flattened_tolerance  = 0;
+    uint32_t         _flattened_iterations = 0;
+
+    // fills and strokes built at other tolerances, most recently used
+    // first. their GPU buffers ride along in the entries so zooming back to
+    // a scale the path was drawn at only switches buffers. dropped with the
+    // path data. See: VG_TESSELLATION_LOD_BUDGET_MNK
+    std::vector<std::shared_ptr<tess_cache_entry_t>> _lods = {};
+
+    // appended path data and its fill. See: appendFill()
+    std::vector<VGubyte> _tail_segments = {};
+    path_coords_t        _tail_coords   = {};
+    indexed_mesh_t       _tail_mesh     = {};
+
+    // where each contour of an editing fill is in _fill_mesh. empty if it
+    // was not built contour by contour. See: modifyFill()
+    std::vector<fill_contour_t> _fill_contours = {};
 };
 } // namespace MonkVG
 #endif //__mkPath_h__
\ No newline at end of file
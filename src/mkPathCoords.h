@@ -0,0 +1,257 @@
+/**
+ * @file mkPathCoords.h
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Path coordinates stored in their VGPathDatatype
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __mkPathCoords_h__
+#define __mkPathCoords_h__
+#include <MonkVG/openvg.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace MonkVG {
+
+/**
+ * @brief Reads user space coordinates out of path data of type T, applying
+ * the path scale and bias when Scaled. Walks the data like an iterator:
+ * cursor[i] reads ahead and cursor += n advances.
+ */
+template <typename T, bool Scaled> struct coord_cursor_t {
+    const T *it    = nullptr;
+    VGfloat  scale = 1;
+    VGfloat  bias  = 0;
+
+    inline VGfloat operator[](const size_t i) const {
+        if constexpr (Scaled) {
+            return (VGfloat)it[i] * scale + bias;
+        } else {
+            return (VGfloat)it[i];
+        }
+    }
+    inline coord_cursor_t &operator+=(const size_t n) {
+        it += n;
+        return *this;
+    }
+};
+
+/**
+ * @brief Path coordinates in the datatype they were created with:
+ * VG_PATH_DATATYPE_S_8, S_16, S_32 or F. Nothing is expanded to float when
+ * data is appended. The user space value of a coordinate is
+ * raw * scale + bias, applied where the coordinates are read. See: visit()
+ * The coordinates may instead live in reference counted caller memory,
+ * which copies of the coordinates share. See: share()
+ */
+struct path_coords_t {
+    VGPathDatatype       datatype = VG_PATH_DATATYPE_F;
+    VGfloat              scale    = 1;
+    VGfloat              bias     = 0;
+    std::vector<uint8_t> data     = {}; // packed coordinates of datatype
+
+    // caller memory read instead of data. released with the last copy.
+    std::shared_ptr<const uint8_t> shared      = nullptr;
+    size_t                         shared_size = 0; // bytes
+
+    /// @brief bytes per coordinate of a datatype. 0 if it is not one.
+    static size_t datatypeSize(const VGPathDatatype datatype) {
+        switch (datatype) {
+        case VG_PATH_DATATYPE_S_8:
+            return 1;
+        case VG_PATH_DATATYPE_S_16:
+            return 2;
+        case VG_PATH_DATATYPE_S_32:
+        case VG_PATH_DATATYPE_F:
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+    size_t coordSize() const { return datatypeSize(datatype); }
+    size_t size() const { return byteSize() / coordSize(); }
+    bool   empty() const { return byteSize() == 0; }
+    void   clear() {
+        data.clear();
+        shared      = nullptr;
+        shared_size = 0;
+    }
+
+    /// @brief the packed coordinates, in data or shared
+    const uint8_t *bytes() const {
+        return shared ? shared.get() : data.data();
+    }
+    size_t byteSize() const { return shared ? shared_size : data.size(); }
+
+    /// @brief true if both hold the same values in the same encoding
+    bool operator==(const path_coords_t &o) const {
+        return datatype == o.datatype && scale == o.scale && bias == o.bias &&
+               byteSize() == o.byteSize() &&
+               (empty() || std::memcmp(bytes(), o.bytes(), byteSize()) == 0);
+    }
+
+    /// @brief read count coordinates of datatype from memory that owner
+    /// keeps alive instead of copying them. Replaces any coordinates.
+    void share(std::shared_ptr<const uint8_t> owner, const size_t count) {
+        data.clear();
+        shared      = std::move(owner);
+        shared_size = count * coordSize();
+    }
+
+    /// @brief copy shared coordinates into data before they are changed
+    void own() {
+        if (!shared) {
+            return;
+        }
+        data.assign(shared.get(), shared.get() + shared_size);
+        shared      = nullptr;
+        shared_size = 0;
+    }
+
+    /// @brief overwrite count coordinates of datatype from coordinate first
+    void replace(const size_t first, const void *coords, const size_t count) {
+        own();
+        std::memcpy(data.data() + first * coordSize(), coords,
+                    count * coordSize());
+    }
+
+    /**
+     * @brief Call f with a coord_cursor_t over the coordinates specialized
+     * for the datatype, and for whether scale and bias do anything, so the
+     * loop reading them is compiled once per encoding.
+     */
+    template <typename F> decltype(auto) visit(F &&f) const {
+        const bool scaled = scale != 1 || bias != 0;
+        switch (datatype) {
+        case VG_PATH_DATATYPE_S_8:
+            return scaled ? f(cursor<int8_t, true>())
+                          : f(cursor<int8_t, false>());
+        case VG_PATH_DATATYPE_S_16:
+            return scaled ? f(cursor<int16_t, true>())
+                          : f(cursor<int16_t, false>());
+        case VG_PATH_DATATYPE_S_32:
+            return scaled ? f(cursor<int32_t, true>())
+                          : f(cursor<int32_t, false>());
+        case VG_PATH_DATATYPE_F:
+            return scaled ? f(cursor<VGfloat, true>())
+                          : f(cursor<VGfloat, false>());
+        default:
+            throw std::runtime_error("Unsupported path data type");
+        }
+    }
+
+    /// @brief append count coordinates of datatype in one copy
+    void append(const void *coords, const size_t count) {
+        own();
+        const uint8_t *src = static_cast<const uint8_t *>(coords);
+        data.insert(data.end(), src, src + count * coordSize());
+    }
+
+    /// @brief append count coordinates of src starting at first. Copied as
+    /// is if the encodings match, converted through user space otherwise.
+    void append(const path_coords_t &src, const size_t first,
+                const size_t count) {
+        own();
+        if (src.datatype == datatype && src.scale == scale &&
+            src.bias == bias) {
+            const size_t s = coordSize();
+            data.insert(data.end(), src.bytes() + first * s,
+                        src.bytes() + (first + count) * s);
+            return;
+        }
+        src.visit([&](auto cursor) {
+            cursor += first;
+            for (size_t i = 0; i < count; i++) {
+                appendValue(cursor[i]);
+            }
+        });
+    }
+
+    /// @brief append a user space value rounded into datatype
+    void appendValue(const VGfloat value) {
+        own();
+        const size_t i = size();
+        grow(1);
+        setValue(i, value);
+    }
+
+    /// @brief make room for count more coordinates in one allocation. They
+    /// are written with setValue() or through floats().
+    void grow(const size_t count) {
+        own();
+        data.resize(data.size() + count * coordSize());
+    }
+
+    /// @brief overwrite coordinate i, made room for with grow(), with a
+    /// user space value rounded into datatype
+    void setValue(const size_t i, const VGfloat value) {
+        const VGfloat raw = (value - bias) / scale;
+        switch (datatype) {
+        case VG_PATH_DATATYPE_S_8:
+            setRaw(i, roundRaw<int8_t>(raw));
+            break;
+        case VG_PATH_DATATYPE_S_16:
+            setRaw(i, roundRaw<int16_t>(raw));
+            break;
+        case VG_PATH_DATATYPE_S_32:
+            setRaw(i, roundRaw<int32_t>(raw));
+            break;
+        default:
+            setRaw(i, raw);
+            break;
+        }
+    }
+
+    /// @brief the owned coordinates to write user space values straight
+    /// into, or nullptr unless they are floats without scale and bias
+    VGfloat *floats() {
+        if (datatype != VG_PATH_DATATYPE_F || scale != 1 || bias != 0) {
+            return nullptr;
+        }
+        own();
+        return reinterpret_cast<VGfloat *>(data.data());
+    }
+
+    /// @brief user space value of coordinate i
+    VGfloat get(const size_t i) const {
+        return visit([i](const auto cursor) { return cursor[i]; });
+    }
+
+  private:
+    template <typename T, bool Scaled>
+    coord_cursor_t<T, Scaled> cursor() const {
+        return {reinterpret_cast<const T *>(bytes()), scale, bias};
+    }
+
+    /// @brief raw rounded to the nearest T, saturated to the range of T.
+    /// NaN is 0.
+    template <typename T> static T roundRaw(const VGfloat raw) {
+        if (std::isnan(raw)) {
+            return 0;
+        }
+        const VGfloat rounded = floorf(raw + 0.5f);
+        if (rounded <= (VGfloat)std::numeric_limits<T>::min()) {
+            return std::numeric_limits<T>::min();
+        }
+        if (rounded >= (VGfloat)std::numeric_limits<T>::max()) {
+            return std::numeric_limits<T>::max();
+        }
+        return (T)rounded;
+    }
+
+    template <typename T> void setRaw(const size_t i, const T raw) {
+        std::memcpy(&data[i * sizeof(T)], &raw, sizeof(T));
+    }
+};
+
+} // namespace MonkVG
+#endif // __mkPathCoords_h__
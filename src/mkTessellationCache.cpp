@@ -0,0 +1,241 @@
+/**
+ * @file mkTessellationCache.cpp
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Content addressed cache of tessellated path geometry implementation
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "mkTessellationCache.h"
+#include <cstring>
+
+namespace MonkVG {
+
+namespace {
+inline uint64_t rotl(const uint64_t x, const int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// MurmurHash3 style block mixing, 8 bytes at a time
+inline uint64_t mix(uint64_t h, uint64_t k) {
+    k *= 0x87c37b91114253d5ull;
+    k = rotl(k, 31);
+    k *= 0x4cf5ad432745937full;
+    h ^= k;
+    return rotl(h, 27) * 5 + 0x52dce729;
+}
+
+inline uint64_t finalize(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t hashBytes(uint64_t h, const void *data, const size_t size) {
+    const uint8_t *p = (const uint8_t *)data;
+    size_t         i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t k;
+        std::memcpy(&k, p + i, 8);
+        h = mix(h, k);
+    }
+    uint64_t tail = 0;
+    if (i < size) {
+        std::memcpy(&tail, p + i, size - i);
+    }
+    return mix(h, tail ^ size);
+}
+
+template <typename T> inline uint64_t hashValue(uint64_t h, const T &v) {
+    return hashBytes(h, &v, sizeof(T));
+}
+
+uint64_t hashPath(const std::vector<VGubyte> &segments,
+                  const path_coords_t        &coords) {
+    uint64_t h = hashBytes(0, segments.data(), segments.size());
+    h          = hashValue(h, coords.datatype);
+    h          = hashValue(h, coords.scale);
+    h          = hashValue(h, coords.bias);
+    return hashBytes(h, coords.bytes(), coords.byteSize());
+}
+
+// bitwise so -0 and NaN coordinates compare like they hash
+bool samePath(const tess_cache_entry_t   &entry,
+              const std::vector<VGubyte> &segments,
+              const path_coords_t        &coords) {
+    return entry.segments == segments &&
+           entry.coords.datatype == coords.datatype &&
+           std::memcmp(&entry.coords.scale, &coords.scale,
+                       sizeof(VGfloat)) == 0 &&
+           std::memcmp(&entry.coords.bias, &coords.bias, sizeof(VGfloat)) ==
+               0 &&
+           entry.coords.byteSize() == coords.byteSize() &&
+           (coords.empty() || std::memcmp(entry.coords.bytes(), coords.bytes(),
+                                          coords.byteSize()) == 0);
+}
+} // namespace
+
+bool tess_cache_key_t::operator==(const tess_cache_key_t &o) const {
+    return hash == o.hash && paint_mode == o.paint_mode &&
+           fill_rule == o.fill_rule && tess_iterations == o.tess_iterations &&
+           tolerance == o.tolerance && stroke_style == o.stroke_style;
+}
+
+size_t tess_cache_entry_t::bytes() const {
+    // shared coordinates are the caller's memory
+    return sizeof(tess_cache_entry_t) + segments.size() * sizeof(VGubyte) +
+           coords.data.size() +
+           fill_mesh.vertices.size() * sizeof(VGfloat) +
+           fill_mesh.indices.size() * sizeof(uint32_t) +
+           stroke_mesh.vertices.size() * sizeof(VGfloat) +
+           stroke_mesh.indices.size() * sizeof(uint32_t);
+}
+
+tess_cache_key_t TessellationCache::fillKey(
+    const std::vector<VGubyte> &segments, const path_coords_t &coords,
+    const VGFillRule fill_rule, const uint32_t tess_iterations,
+    const VGfloat tolerance) {
+    tess_cache_key_t key;
+    key.paint_mode      = VG_FILL_PATH;
+    key.fill_rule       = fill_rule;
+    key.tess_iterations = tess_iterations;
+    key.tolerance       = tolerance;
+
+    uint64_t h = hashPath(segments, coords);
+    h          = hashValue(h, key.paint_mode);
+    h          = hashValue(h, key.fill_rule);
+    h          = hashValue(h, key.tess_iterations);
+    h          = hashValue(h, key.tolerance);
+    key.hash   = finalize(h);
+    return key;
+}
+
+tess_cache_key_t TessellationCache::strokeKey(
+    const std::vector<VGubyte> &segments, const path_coords_t &coords,
+    const stroke_style_t &style, const uint32_t tess_iterations,
+    const VGfloat tolerance) {
+    tess_cache_key_t key;
+    key.paint_mode      = VG_STROKE_PATH;
+    key.tess_iterations = tess_iterations;
+    key.tolerance       = tolerance;
+    key.stroke_style    = style;
+
+    uint64_t h = hashPath(segments, coords);
+    h          = hashValue(h, key.paint_mode);
+    h          = hashValue(h, key.tess_iterations);
+    h          = hashValue(h, key.tolerance);
+    h          = hashValue(h, style.width);
+    h          = hashValue(h, style.cap);
+    h          = hashValue(h, style.join);
+    h          = hashValue(h, style.miter_limit);
+    h          = hashBytes(h, style.dash_pattern.data(),
+                           style.dash_pattern.size() * sizeof(VGfloat));
+    h          = hashValue(h, style.dash_phase);
+    h          = hashValue(h, style.dash_phase_reset);
+    h          = hashValue(h, style.hairline);
+    key.hash   = finalize(h);
+    return key;
+}
+
+std::shared_ptr<tess_cache_entry_t>
+TessellationCache::find(const tess_cache_key_t     &key,
+                        const std::vector<VGubyte> &segments,
+                        const path_coords_t        &coords) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto                        range = _index.equal_range(key.hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        const std::shared_ptr<tess_cache_entry_t> &entry = *it->second;
+        if (entry->key == key && samePath(*entry, segments, coords)) {
+            // move to the front of the lru list
+            _lru.splice(_lru.begin(), _lru, it->second);
+            _hits++;
+            return entry;
+        }
+    }
+    _misses++;
+    return nullptr;
+}
+
+void TessellationCache::insert(
+    const std::shared_ptr<tess_cache_entry_t> &entry) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_budget == 0) {
+        return;
+    }
+    _lru.push_front(entry);
+    _index.emplace(entry->key.hash, _lru.begin());
+    _bytes += entry->bytes();
+    evict();
+}
+
+void TessellationCache::evict() {
+    while (_bytes > _budget && !_lru.empty()) {
+        std::shared_ptr<tess_cache_entry_t> &oldest = _lru.back();
+        auto range = _index.equal_range(oldest->key.hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == std::prev(_lru.end())) {
+                _index.erase(it);
+                break;
+            }
+        }
+        _bytes -= oldest->bytes();
+        _evicted.push_back(std::move(oldest));
+        _lru.pop_back();
+    }
+}
+
+void TessellationCache::retire(std::shared_ptr<tess_cache_entry_t> entry) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _evicted.push_back(std::move(entry));
+}
+
+void TessellationCache::releaseEvicted() {
+    std::vector<std::shared_ptr<tess_cache_entry_t>> evicted;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::swap(evicted, _evicted);
+    }
+    // destroyed here, outside the lock
+}
+
+void TessellationCache::clear() {
+    lru_t lru;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::swap(lru, _lru);
+        _index.clear();
+        _bytes = 0;
+    }
+    releaseEvicted();
+}
+
+void TessellationCache::setBudget(const size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _budget = bytes;
+        evict();
+    }
+    releaseEvicted();
+}
+
+size_t TessellationCache::getBytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _bytes;
+}
+
+uint64_t TessellationCache::getHits() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _hits;
+}
+
+uint64_t TessellationCache::getMisses() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _misses;
+}
+
+} // namespace MonkVG
@@ -0,0 +1,140 @@
+/**
+ * @file mkTessellationCache.h
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Content addressed cache of tessellated path geometry
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __mkTessellationCache_h__
+#define __mkTessellationCache_h__
+#include "mkTessellator.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace MonkVG {
+
+/**
+ * @brief Everything besides the path data that the tessellated geometry
+ * depends on, plus a hash of it all.
+ */
+struct tess_cache_key_t {
+    uint64_t       hash            = 0;
+    VGbitfield     paint_mode      = 0; // VG_FILL_PATH or VG_STROKE_PATH
+    VGFillRule     fill_rule       = VG_EVEN_ODD; // fill only
+    uint32_t       tess_iterations = 0;
+    VGfloat        tolerance       = 0;
+    stroke_style_t stroke_style    = {}; // stroke only
+
+    bool operator==(const tess_cache_key_t &o) const;
+};
+
+/**
+ * @brief Backend GPU buffers built from a cache entry. Deleted when the last
+ * path drawing them lets go.
+ */
+struct gpu_buffers_t {
+    virtual ~gpu_buffers_t() = default;
+};
+
+/**
+ * @brief A tessellated fill or stroke. The geometry never changes once the
+ * entry is in the cache.
+ */
+struct tess_cache_entry_t {
+    tess_cache_key_t     key      = {};
+    std::vector<VGubyte> segments = {};
+    path_coords_t        coords   = {};
+
+    indexed_mesh_t fill_mesh   = {};
+    bounding_box_t bounds      = {VG_MAX_FLOAT, VG_MAX_FLOAT, -VG_MAX_FLOAT,
+                                  -VG_MAX_FLOAT};
+    indexed_mesh_t stroke_mesh = {};
+
+    // uploaded by the first path that draws the entry. only touched on the
+    // context thread.
+    std::shared_ptr<gpu_buffers_t> gpu_buffers = nullptr;
+
+    /// @brief bytes of path data and geometry held by the entry
+    size_t bytes() const;
+};
+
+/**
+ * @brief Maps path data and tessellation settings to shared geometry so
+ * identical paths are tessellated and uploaded once. Least recently used
+ * entries are evicted once the cached geometry exceeds the byte budget.
+ * Entries in use by paths stay alive until the paths let go.
+ *
+ * find() and insert() may be called from any thread. Evicted entries are
+ * held until releaseEvicted() is called on the context thread since their
+ * GPU buffers must be deleted there.
+ */
+class TessellationCache {
+  public:
+    static tess_cache_key_t fillKey(const std::vector<VGubyte> &segments,
+                                    const path_coords_t        &coords,
+                                    const VGFillRule            fill_rule,
+                                    const uint32_t tess_iterations,
+                                    const VGfloat  tolerance);
+
+    static tess_cache_key_t strokeKey(const std::vector<VGubyte> &segments,
+                                      const path_coords_t        &coords,
+                                      const stroke_style_t       &style,
+                                      const uint32_t tess_iterations,
+                                      const VGfloat  tolerance);
+
+    /// @brief the entry for key and path data or nullptr. Counts a hit or
+    /// a miss.
+    std::shared_ptr<tess_cache_entry_t>
+    find(const tess_cache_key_t &key, const std::vector<VGubyte> &segments,
+         const path_coords_t &coords);
+
+    /// @brief add a new entry as the most recently used one
+    void insert(const std::shared_ptr<tess_cache_entry_t> &entry);
+
+    /// @brief hold an entry dropped on another thread until the next
+    /// releaseEvicted() so its GPU buffers are deleted on the context thread
+    void retire(std::shared_ptr<tess_cache_entry_t> entry);
+
+    /// @brief drop the evicted entries. Must run on the context thread.
+    void releaseEvicted();
+
+    /// @brief drop every entry. Must run on the context thread.
+    void clear();
+
+    /// @brief bytes of geometry to keep cached. 0 disables the cache. Must
+    /// run on the context thread.
+    void   setBudget(const size_t bytes);
+    size_t getBudget() const { return _budget; }
+    bool   isEnabled() const { return _budget > 0; }
+
+    size_t   getBytes() const;
+    uint64_t getHits() const;
+    uint64_t getMisses() const;
+
+  private:
+    using lru_t = std::list<std::shared_ptr<tess_cache_entry_t>>;
+
+    /// @brief evict until under budget. _mutex must be held.
+    void evict();
+
+    mutable std::mutex _mutex;
+    lru_t              _lru = {}; // most recently used first
+    std::unordered_multimap<uint64_t, lru_t::iterator> _index   = {};
+    std::vector<std::shared_ptr<tess_cache_entry_t>>   _evicted = {};
+    size_t                                             _bytes   = 0;
+    std::atomic<size_t> _budget = 0; // off until the application opts in
+    uint64_t            _hits   = 0;
+    uint64_t            _misses = 0;
+};
+
+} // namespace MonkVG
+#endif // __mkTessellationCache_h__
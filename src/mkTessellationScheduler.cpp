@@ -0,0 +1,104 @@
+/**
+ * @file mkTessellationScheduler.cpp
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Per frame time budget for tessellating paths while drawing
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "mkTessellationScheduler.h"
+#include <algorithm>
+
+namespace MonkVG {
+
+void TessellationScheduler::beginFrame() {
+    _frame_start = clock_t::now();
+    _spent_us    = 0;
+    _reserved_us = 0;
+    _overrun     = false;
+    _reserved.clear();
+
+    // a path drawn more than once is ranked once
+    std::sort(_deferred.begin(), _deferred.end(),
+              [](const deferred_t &a, const deferred_t &b) {
+                  return a.path != b.path ? a.path < b.path : a.area > b.area;
+              });
+    _deferred.erase(std::unique(_deferred.begin(), _deferred.end(),
+                                [](const deferred_t &a, const deferred_t &b) {
+                                    return a.path == b.path;
+                                }),
+                    _deferred.end());
+
+    // largest first. the first always gets in so every frame makes progress.
+    std::sort(_deferred.begin(), _deferred.end(),
+              [](const deferred_t &a, const deferred_t &b) {
+                  return a.area > b.area;
+              });
+    for (const deferred_t &d : _deferred) {
+        const double us = estimate(d.cost);
+        if (!_reserved.empty() && _reserved_us + us > _budget_us) {
+            break;
+        }
+        _reserved.emplace(d.path, us);
+        _reserved_us += us;
+    }
+    _deferred.clear();
+}
+
+void TessellationScheduler::forget(const void *path) {
+    auto it = _reserved.find(path);
+    if (it != _reserved.end()) {
+        _reserved_us = std::max(0.0, _reserved_us - it->second);
+        _reserved.erase(it);
+    }
+    _deferred.erase(std::remove_if(_deferred.begin(), _deferred.end(),
+                                   [path](const deferred_t &d) {
+                                       return d.path == path;
+                                   }),
+                    _deferred.end());
+}
+
+bool TessellationScheduler::admit(const void *path, const size_t cost) {
+    // without a vgClear every frame the budget would never be refilled
+    if (std::chrono::duration<double, std::micro>(clock_t::now() -
+                                                  _frame_start)
+            .count() > kFrameUs) {
+        beginFrame();
+    }
+    auto it = _reserved.find(path);
+    if (it != _reserved.end()) {
+        _reserved_us = std::max(0.0, _reserved_us - it->second);
+        _reserved.erase(it);
+        return true;
+    }
+    // the first build of a frame always fits so every frame makes progress
+    if (_spent_us == 0 && _reserved.empty()) {
+        return true;
+    }
+    return _spent_us + _reserved_us + estimate(cost) <= _budget_us;
+}
+
+void TessellationScheduler::defer(const void *path, const VGfloat area,
+                                  const size_t cost) {
+    _deferred.push_back({path, area, cost});
+    _deferred_count++;
+}
+
+void TessellationScheduler::spent(const size_t cost, const double us) {
+    _spent_us += us;
+    // recent builds weigh more. large paths cost more per segment than
+    // small ones, so the sums are averaged and not the ratios.
+    _history_us   = 0.95 * _history_us + us;
+    _history_cost = 0.95 * _history_cost + cost;
+    if (_history_cost > 0) {
+        _us_per_cost = _history_us / _history_cost;
+    }
+    if (!_overrun && _spent_us > _budget_us) {
+        _overrun = true;
+        _overruns++;
+    }
+}
+
+} // namespace MonkVG
@@ -0,0 +1,107 @@
+/**
+ * @file mkTessellationScheduler.h
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Per frame time budget for tessellating paths while drawing
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __mkTessellationScheduler_h__
+#define __mkTessellationScheduler_h__
+#include <MonkVG/openvg.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace MonkVG {
+
+/**
+ * @brief Spreads the tessellation of paths drawn in a frame over several
+ * frames so a scene appearing at once does not stall the frame it appears
+ * in. A frame starts at beginFrame(), or once kFrameUs have passed since
+ * the last one started for applications that clear only once. Paths ask
+ * admit() before they are tessellated and report the time it took with
+ * spent(). Once the frame's budget is used up paths are refused and
+ * deferred with their on screen area. The next frame reserves its budget
+ * for the deferred paths, largest first, by their estimated cost.
+ *
+ * Paths are only used as keys and never dereferenced. A destroyed path has
+ * to be forgotten so a new path at its address does not inherit its place.
+ * Only used on the context thread.
+ */
+class TessellationScheduler {
+  public:
+    /// @brief microseconds of tessellation per frame. 0 disables the
+    /// budget.
+    void     setBudget(const uint32_t us) { _budget_us = us; }
+    uint32_t getBudget() const { return _budget_us; }
+    bool     isEnabled() const { return _budget_us > 0; }
+
+    /// @brief start a frame. Reserves the budget for the paths deferred in
+    /// the last frame, largest on screen area first.
+    void beginFrame();
+
+    /// @brief drop what was reserved for or deferred of a destroyed path
+    void forget(const void *path);
+
+    /**
+     * @brief may path be tessellated now?
+     *
+     * @param path the path
+     * @param cost its size in segments
+     * @return true if it was reserved for, or its estimated cost fits in
+     * what is left of the frame's budget
+     */
+    bool admit(const void *path, size_t cost);
+
+    /// @brief path was refused. It is ranked by area for the next frame.
+    void defer(const void *path, VGfloat area, size_t cost);
+
+    /// @brief an admitted path of cost segments took us microseconds
+    void spent(size_t cost, double us);
+
+    uint64_t getDeferred() const { return _deferred_count; }
+    uint64_t getOverruns() const { return _overruns; }
+
+  private:
+    struct deferred_t {
+        const void *path;
+        VGfloat     area;
+        size_t      cost;
+    };
+
+    using clock_t = std::chrono::steady_clock;
+
+    /// @brief a frame lasts at most this long without a beginFrame(), 60 Hz
+    static constexpr double kFrameUs = 1e6 / 60;
+
+    double estimate(const size_t cost) const { return cost * _us_per_cost; }
+
+    uint32_t _budget_us = 0;
+
+    // this frame. the reserved paths with their estimated microseconds.
+    clock_t::time_point                      _frame_start = {};
+    double                                   _spent_us    = 0;
+    double                                   _reserved_us = 0;
+    std::unordered_map<const void *, double> _reserved    = {};
+    bool                                     _overrun     = false;
+
+    // refused this frame, ranked in beginFrame()
+    std::vector<deferred_t> _deferred = {};
+
+    // decaying sums of the measured builds and their microseconds per
+    // segment
+    double _history_us   = 0;
+    double _history_cost = 0;
+    double _us_per_cost  = 0.5;
+
+    uint64_t _deferred_count = 0;
+    uint64_t _overruns       = 0;
+};
+
+} // namespace MonkVG
+#endif // __mkTessellationScheduler_h__
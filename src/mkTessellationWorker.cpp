@@ -0,0 +1,94 @@
+/**
+ * @file mkTessellationWorker.cpp
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Background tessellation thread implementation
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "mkTessellationWorker.h"
+
+namespace MonkVG {
+
+TessellationWorker::TessellationWorker(
+    std::unique_ptr<ITessellator> tessellator)
+    : _tessellator(std::move(tessellator)),
+      _thread(&TessellationWorker::run, this) {}
+
+TessellationWorker::~TessellationWorker() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _wake.notify_one();
+    _thread.join();
+}
+
+void TessellationWorker::submit(std::shared_ptr<async_build_t> build) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push_back(std::move(build));
+    }
+    _wake.notify_one();
+}
+
+void TessellationWorker::run() {
+    for (;;) {
+        std::shared_ptr<async_build_t> next;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this] { return _quit || !_queue.empty(); });
+            if (_queue.empty()) {
+                return; // quit once everything queued is done
+            }
+            next = std::move(_queue.front());
+            _queue.pop_front();
+        }
+
+        // nobody is waiting for a build whose path was destroyed
+        if (next.use_count() > 1) {
+            try {
+                build(*next);
+            } catch (...) {
+                next->error = std::current_exception();
+            }
+        }
+        next->done.store(true, std::memory_order_release);
+    }
+}
+
+void TessellationWorker::build(async_build_t &build) {
+    // the fill and the stroke share the flattened path when they can
+    bool flattened = false;
+    if (build.paint_modes & VG_FILL_PATH) {
+        _tessellator->setTolerance(build.fill_tolerance);
+        // editing fills go contour by contour where they can. See:
+        // IPath::modifyFill()
+        if (!build.fill_by_contour ||
+            !_tessellator->tessellateContours(
+                build.segments, build.coords, build.fill_rule,
+                build.tess_iterations, build.fill_mesh, build.bounds,
+                build.fill_contours)) {
+            _tessellator->flatten(build.segments, build.coords,
+                                  build.tess_iterations, _flattened);
+            flattened = true;
+            _tessellator->tessellateIndexed(_flattened, build.fill_rule,
+                                            build.fill_mesh, build.bounds);
+        }
+    }
+    if (build.paint_modes & VG_STROKE_PATH) {
+        if (!flattened || build.stroke_tolerance != build.fill_tolerance) {
+            _tessellator->setTolerance(build.stroke_tolerance);
+            _tessellator->flatten(build.segments, build.coords,
+                                  build.tess_iterations, _flattened);
+        }
+        _tessellator->buildStroke(
+            _flattened, build.stroke_style, build.tess_iterations,
+            build.stroke_mesh,
+            build.stroke_scaling ? &build.stroke_offsets : nullptr);
+    }
+}
+
+} // namespace MonkVG
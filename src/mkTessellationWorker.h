@@ -0,0 +1,89 @@
+/**
+ * @file mkTessellationWorker.h
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Background thread that tessellates paths off the render thread
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __mkTessellationWorker_h__
+#define __mkTessellationWorker_h__
+#include "mkTessellator.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MonkVG {
+
+/**
+ * @brief A fill and/or stroke build handed to the TessellationWorker. The
+ * inputs are a snapshot of the path so the path can keep changing while the
+ * build runs. The outputs may only be read once done is set.
+ */
+struct async_build_t {
+    // inputs
+    std::vector<VGubyte> segments         = {};
+    path_coords_t        coords           = {};
+    VGbitfield           paint_modes      = 0;
+    VGFillRule           fill_rule        = VG_EVEN_ODD;
+    uint32_t             tess_iterations  = 16;
+    VGfloat              fill_tolerance   = 0;
+    VGfloat              stroke_tolerance = 0;
+    stroke_style_t       stroke_style     = {};
+    bool                 stroke_scaling   = false; // record stroke_offsets
+    bool                 fill_by_contour  = false; // record fill_contours
+
+    // outputs
+    indexed_mesh_t              fill_mesh      = {};
+    bounding_box_t              bounds         = {VG_MAX_FLOAT, VG_MAX_FLOAT,
+                                                  -VG_MAX_FLOAT, -VG_MAX_FLOAT};
+    std::vector<fill_contour_t> fill_contours  = {}; // empty if they overlap
+    indexed_mesh_t              stroke_mesh    = {};
+    stroke_offsets_t            stroke_offsets = {};
+    std::exception_ptr          error          = nullptr;
+    std::atomic<bool>           done           = false;
+};
+
+/**
+ * @brief A single background thread with its own tessellator that runs
+ * async_build_t's in submission order.
+ */
+class TessellationWorker {
+  public:
+    explicit TessellationWorker(std::unique_ptr<ITessellator> tessellator);
+
+    /// @brief finishes the queued builds and stops the thread
+    ~TessellationWorker();
+
+    TessellationWorker(const TessellationWorker &)            = delete;
+    TessellationWorker &operator=(const TessellationWorker &) = delete;
+
+    /// @brief queue a build. build->done is set when it finished.
+    void submit(std::shared_ptr<async_build_t> build);
+
+    /// @brief the worker's tessellator. Only its thread safe counters may be
+    /// read while builds are running.
+    const ITessellator &getTessellator() const { return *_tessellator; }
+
+  private:
+    void run();
+    void build(async_build_t &build);
+
+    std::unique_ptr<ITessellator>              _tessellator = nullptr;
+    flattened_path_t                           _flattened   = {}; // build()
+    std::deque<std::shared_ptr<async_build_t>> _queue       = {};
+    std::mutex                                 _mutex;
+    std::condition_variable                    _wake;
+    bool                                       _quit = false;
+    std::thread                                _thread; // started last
+};
+
+} // namespace MonkVG
+#endif // __mkTessellationWorker_h__
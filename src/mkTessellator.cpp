@@ -9,310 +9,1687 @@
  *
  */
 #include "mkTessellator.h"
+#include "mkPath.h"
 #include "mkMath.h"
+#include "mkCurves.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
 namespace MonkVG {
 
-void ITessellator::buildFatLineSegment(std::vector<vertex_2d_t> &vertices,
-                                       const vertex_2d_t        &p0,
-                                       const vertex_2d_t        &p1,
-                                       const float               stroke_width) {
+namespace {
 
-    if ((p0.x == p1.x) && (p0.y == p1.y)) {
+/// @brief drop the last contour if it is a move on its own
+inline void dropLoneMove(flattened_path_t &path) {
+    if (!path.contours.empty() && path.contours.back().count < 2 &&
+        !path.contours.back().has_segments) {
+        path.points.resize(path.contours.back().first);
+        path.contours.pop_back();
+    }
+}
+
+/// @brief start a new contour at p. A move on its own before it is
+/// dropped, a contour whose segments had no length is kept as a dot.
+inline void beginContour(flattened_path_t &path, const vertex_2d_t &p) {
+    dropLoneMove(path);
+    contour_t contour;
+    contour.first = (uint32_t)path.points.size();
+    contour.count = 1;
+    path.contours.push_back(contour);
+    path.points.push_back(p);
+}
+
+/// @brief add a point to the current contour skipping repeated points
+inline void addPoint(flattened_path_t &path, const vertex_2d_t &p) {
+    path.contours.back().has_segments = true;
+    const vertex_2d_t &last = path.points.back();
+    if (last.x == p.x && last.y == p.y) {
+        return;
+    }
+    path.points.push_back(p);
+    path.contours.back().count++;
+}
+
+/// @brief make room for count points after the current contour for a curve
+/// evaluator to write into. See: commitPoints()
+inline vertex_2d_t *reservePoints(flattened_path_t &path,
+                                  const uint32_t    count) {
+    const size_t first = path.points.size();
+    path.points.resize(first + count);
+    return &path.points[first];
+}
+
+/// @brief add the count points written after reservePoints() to the current
+/// contour skipping repeated points
+inline void commitPoints(flattened_path_t &path, const uint32_t count) {
+    const size_t first = path.points.size() - count;
+    size_t       last  = first - 1;
+    for (size_t i = first; i < path.points.size(); i++) {
+        const vertex_2d_t &p = path.points[i];
+        if (p.x != path.points[last].x || p.y != path.points[last].y) {
+            path.points[++last] = p;
+        }
+    }
+    path.contours.back().count += (uint32_t)(last + 1 - first);
+    path.contours.back().has_segments = true;
+    path.points.resize(last + 1);
+}
+
+// upper bound on the line segments a single curve is flattened into
+constexpr uint32_t kMaxFlattenSteps = 1024;
+
+// simple polygons with more vertices go to the general tessellator. the
+// simplicity test and the ear clipping are quadratic.
+constexpr size_t kMaxEarClipVertices = 128;
+
+/// @brief 1 if a, b, c turn counter clockwise, -1 if clockwise, 0 if they
+/// are collinear. In double so the sign is exact for float input.
+inline int orientation(const vertex_2d_t &a, const vertex_2d_t &b,
+                       const vertex_2d_t &c) {
+    const double d = ((double)b.x - a.x) * ((double)c.y - a.y) -
+                     ((double)b.y - a.y) * ((double)c.x - a.x);
+    return d > 0 ? 1 : (d < 0 ? -1 : 0);
+}
+
+/// @brief true if p lies on the segment a b. p must be collinear with it.
+inline bool onSegment(const vertex_2d_t &a, const vertex_2d_t &b,
+                      const vertex_2d_t &p) {
+    return p.x >= std::min(a.x, b.x) && p.x <= std::max(a.x, b.x) &&
+           p.y >= std::min(a.y, b.y) && p.y <= std::max(a.y, b.y);
+}
+
+/// @brief true if the segments a0 a1 and b0 b1 cross or touch
+inline bool segmentsTouch(const vertex_2d_t &a0, const vertex_2d_t &a1,
+                          const vertex_2d_t &b0, const vertex_2d_t &b1) {
+    // most pairs are far apart
+    if (std::max(a0.x, a1.x) < std::min(b0.x, b1.x) ||
+        std::max(b0.x, b1.x) < std::min(a0.x, a1.x) ||
+        std::max(a0.y, a1.y) < std::min(b0.y, b1.y) ||
+        std::max(b0.y, b1.y) < std::min(a0.y, a1.y)) {
+        return false;
+    }
+    const int o0 = orientation(a0, a1, b0);
+    const int o1 = orientation(a0, a1, b1);
+    const int o2 = orientation(b0, b1, a0);
+    const int o3 = orientation(b0, b1, a1);
+    if (o0 != o1 && o2 != o3) {
+        return true;
+    }
+    return (o0 == 0 && onSegment(a0, a1, b0)) ||
+           (o1 == 0 && onSegment(a0, a1, b1)) ||
+           (o2 == 0 && onSegment(b0, b1, a0)) ||
+           (o3 == 0 && onSegment(b0, b1, a1));
+}
+
+/// @brief add steps + 1 points of the ellipse arc around cx, cy from angle
+/// a0 through extent, both ends included
+inline void addEllipsePoints(std::vector<vertex_2d_t> &points,
+                             const VGfloat cx, const VGfloat cy,
+                             const VGfloat rx, const VGfloat ry,
+                             const VGfloat a0, const VGfloat extent,
+                             const uint32_t steps) {
+    const size_t first = points.size();
+    points.resize(first + steps + 1);
+    points[first] = {cx + rx * cosf(a0), cy + ry * sinf(a0)};
+    evalEllipse({cx, cy}, {rx, 0}, {0, ry}, a0, extent, steps,
+                &points[first + 1]);
+}
+
+inline uint32_t clampSteps(const VGfloat n, const VGfloat min_steps) {
+    if (!(n >= min_steps)) { // also catches nan
+        return (uint32_t)min_steps;
+    }
+    return (uint32_t)std::min(n, (VGfloat)kMaxFlattenSteps);
+}
+
+/**
+ * @brief Wang's formula. A degree d bezier stays within tolerance of its
+ * chords when split into sqrt(d(d-1)/8 * dd / tolerance) uniform steps, where
+ * dd is the largest second difference of its control points.
+ */
+inline uint32_t wangSteps(const VGfloat dd, const VGfloat degree_factor,
+                          const VGfloat tolerance) {
+    return clampSteps(ceilf(sqrtf(degree_factor * dd / tolerance)), 1);
+}
+
+/// @brief length of the second difference p0 - 2 p1 + p2
+inline VGfloat secondDifference(const vertex_2d_t &p0, const vertex_2d_t &p1,
+                                const vertex_2d_t &p2) {
+    const VGfloat x = p0.x - 2.0f * p1.x + p2.x;
+    const VGfloat y = p0.y - 2.0f * p1.y + p2.y;
+    return sqrtf(x * x + y * y);
+}
+
+/// @brief line segments for a full ellipse with the given major radius
+inline uint32_t ellipseSteps(const VGfloat radius, const VGfloat tolerance,
+                             const uint32_t tess_iterations) {
+    if (tolerance <= 0) {
+        return std::max<uint32_t>(1, tess_iterations);
+    }
+    if (tolerance >= radius) {
+        return 4;
+    }
+    // a chord spanning the angle a is r * (1 - cos(a / 2)) away from the arc
+    const VGfloat a = 2.0f * acosf(1.0f - tolerance / radius);
+    return clampSteps(ceilf(2.0f * (VGfloat)M_PI / a), 4);
+}
+
+/**
+ * @brief Flatten an elliptical arc from p0 to p1. Uses the center
+ * parameterization described in the OpenVG spec, Appendix A.
+ *
+ * @param tolerance user space flattening tolerance. 0 to use tess_iterations
+ * @param tess_iterations number of line segments for a full ellipse
+ */
+void addArc(flattened_path_t &path, const vertex_2d_t &p0, VGfloat rh,
+            VGfloat rv, const VGfloat rot, const vertex_2d_t &p1,
+            const bool large, const bool ccw, const VGfloat tolerance,
+            const uint32_t tess_iterations) {
+    rh = fabsf(rh);
+    rv = fabsf(rv);
+    if ((p0.x == p1.x && p0.y == p1.y) || rh == 0 || rv == 0) {
+        addPoint(path, p1);
         return;
     }
 
-    float       dx      = p1.y - p0.y;
-    float       dy      = p0.x - p1.x;
-    const float inv_mag = 1.0f / sqrtf(dx * dx + dy * dy);
-    dx                  = dx * inv_mag;
-    dy                  = dy * inv_mag;
+    const VGfloat cos_rot = cosf(radians(rot));
+    const VGfloat sin_rot = sinf(radians(rot));
 
-    vertex_2d_t v0, v1, v2, v3;
-    const float radius = stroke_width * 0.5f;
+    // transform the end points into unit circle space
+    VGfloat x0 = (p0.x * cos_rot + p0.y * sin_rot) / rh;
+    VGfloat y0 = (-p0.x * sin_rot + p0.y * cos_rot) / rv;
+    VGfloat x1 = (p1.x * cos_rot + p1.y * sin_rot) / rh;
+    VGfloat y1 = (-p1.x * sin_rot + p1.y * cos_rot) / rv;
 
-    v0.x = p0.x + radius * dx;
-    v0.y = p0.y + radius * dy;
-    vertices.push_back(v0);
+    const VGfloat dx   = x0 - x1;
+    const VGfloat dy   = y0 - y1;
+    const VGfloat dsq  = dx * dx + dy * dy;
+    const VGfloat disc = 1.0f / dsq - 0.25f;
 
-    v1.x = p0.x - radius * dx;
-    v1.y = p0.y - radius * dy;
-    vertices.push_back(v1);
+    VGfloat cx, cy, sweep;
+    if (disc <= 0) {
+        // radii are too small. scale them up until the end points lie on
+        // a diameter of the ellipse.
+        const VGfloat s = sqrtf(dsq) * 0.5f;
+        rh *= s;
+        rv *= s;
+        x0 /= s;
+        y0 /= s;
+        x1 /= s;
+        y1 /= s;
+        cx    = (x0 + x1) * 0.5f;
+        cy    = (y0 + y1) * 0.5f;
+        sweep = ccw ? (VGfloat)M_PI : -(VGfloat)M_PI;
+    } else {
+        // two candidate centers. pick the one matching the arc flags.
+        const VGfloat s  = sqrtf(disc);
+        const VGfloat xm = (x0 + x1) * 0.5f;
+        const VGfloat ym = (y0 + y1) * 0.5f;
+        cx               = xm + s * dy;
+        cy               = ym - s * dx;
+        VGfloat d_ccw    = atan2f(y1 - cy, x1 - cx) - atan2f(y0 - cy, x0 - cx);
+        if (d_ccw <= 0) {
+            d_ccw += 2.0f * (VGfloat)M_PI;
+        }
+        if ((d_ccw > (VGfloat)M_PI) != (large == ccw)) {
+            cx    = xm - s * dy;
+            cy    = ym + s * dx;
+            d_ccw = 2.0f * (VGfloat)M_PI - d_ccw;
+        }
+        sweep = ccw ? d_ccw : d_ccw - 2.0f * (VGfloat)M_PI;
+    }
+
+    const uint32_t steps =
+        ellipseSteps(std::max(rh, rv), tolerance, tess_iterations);
+    const VGfloat  start = atan2f(y0 - cy, x0 - cx);
+    const uint32_t n     = std::max<uint32_t>(
+        1, (uint32_t)ceilf(fabsf(sweep) / (2.0f * (VGfloat)M_PI) * steps));
+    // back from unit circle space: the center plus the rotated radii
+    const vertex_2d_t center = {cx * rh * cos_rot - cy * rv * sin_rot,
+                                cx * rh * sin_rot + cy * rv * cos_rot};
+    const vertex_2d_t u      = {rh * cos_rot, rh * sin_rot};
+    const vertex_2d_t v      = {-rv * sin_rot, rv * cos_rot};
+    vertex_2d_t      *out    = reservePoints(path, n);
+    evalEllipse(center, u, v, start, sweep, n, out);
+    out[n - 1] = p1;
+    commitPoints(path, n);
+}
+
+/// @brief hash of a vertex position for welding
+inline uint32_t hashVertex(const VGfloat x, const VGfloat y) {
+    uint32_t ix, iy;
+    std::memcpy(&ix, &x, sizeof(ix));
+    std::memcpy(&iy, &y, sizeof(iy));
+    uint32_t h = ix * 0x9e3779b1u ^ (iy + 0x7f4a7c15u) * 0x85ebca6bu;
+    return h ^ (h >> 15);
+}
+
+// vertex cache optimization tuning. See: Tom Forsyth, "Linear-Speed Vertex
+// Cache Optimisation"
+constexpr int32_t kCacheSize        = 16;
+constexpr float   kCacheDecayPower  = 1.5f;
+constexpr float   kLastTriScore     = 0.75f;
+constexpr float   kValenceBoostScale = 2.0f;
+constexpr float   kValenceBoostPower = 0.5f;
+
+constexpr uint32_t kMaxValence        = 32; // valence boost table size
+
+// fills come out of the tessellators as strips and fans with about one
+// vertex cache miss per triangle, which reordering improves by a few
+// percent for about 0.15us per triangle on the CPU. only meshes big enough
+// for their vertex work to matter are reordered.
+constexpr uint32_t kMinCacheOptimizeTris = 4096;
+
+/// @brief score tables so scoring does not call powf
+struct score_tables_t {
+    std::array<float, kCacheSize>      cache   = {};
+    std::array<float, kMaxValence + 1> valence = {};
+
+    score_tables_t() {
+        for (int32_t i = 0; i < kCacheSize; i++) {
+            if (i < 3) {
+                // used by the last triangle. fixed score so a strip like
+                // order is not preferred over a fan.
+                cache[i] = kLastTriScore;
+            } else {
+                const float scaler = 1.0f / (kCacheSize - 3);
+                cache[i] = powf(1.0f - (i - 3) * scaler, kCacheDecayPower);
+            }
+        }
+        for (uint32_t i = 1; i <= kMaxValence; i++) {
+            valence[i] = kValenceBoostScale * powf((float)i, -kValenceBoostPower);
+        }
+    }
+};
+
+inline float vertexScore(const int32_t cache_pos, const uint32_t live_tris) {
+    static const score_tables_t tables;
+    if (live_tris == 0) {
+        // no triangles left to use this vertex
+        return -1.0f;
+    }
+    // boost vertices with few triangles left so they are finished off. the
+    // boost is flat for fan centers so their triangles need no rescoring.
+    float score = tables.valence[std::min(live_tris, kMaxValence)];
+    if (cache_pos >= 0) {
+        score += tables.cache[cache_pos];
+    }
+    return score;
+}
+
+// a join whose shared vertices stick out at most this fraction of the half
+// width past a round or bevel join is drawn as a miter when no tolerance is
+// set. See: ITessellator::strokeJoin
+constexpr VGfloat kSmoothJoinError = 0.02f;
+
+// 1 + cos of the turn below which two segments are taken to reverse
+constexpr VGfloat kReversalEpsilon = 1e-4f;
 
-    v2.x = p1.x + radius * dx;
-    v2.y = p1.y + radius * dy;
-    vertices.push_back(v2);
+// strokes recorded for rescaling share the vertices of joins that would
+// also share them at this many times the width, so growing widths rescale
+// longer. See: ITessellator::rescaleStroke
+constexpr VGfloat kScaleHeadroom = 2.0f;
 
-    v3.x = p1.x - radius * dx;
-    v3.y = p1.y - radius * dy;
-    vertices.push_back(v3);
+inline uint32_t addVertex(indexed_mesh_t &mesh, const VGfloat x,
+                          const VGfloat y) {
+    mesh.vertices.push_back(x);
+    mesh.vertices.push_back(y);
+    return mesh.vertexCount() - 1;
 }
 
+inline void addTriangle(indexed_mesh_t &mesh, const uint32_t a,
+                        const uint32_t b, const uint32_t c) {
+    mesh.indices.push_back(a);
+    mesh.indices.push_back(b);
+    mesh.indices.push_back(c);
+}
+
+/// @brief a stroke vertex hw times the offset o away from p. Recorded in
+/// offsets if set. See: stroke_offsets_t
+inline uint32_t addStrokeVertex(indexed_mesh_t    &mesh,
+                                stroke_offsets_t  *offsets,
+                                const vertex_2d_t &p, const VGfloat ox,
+                                const VGfloat oy, const VGfloat hw) {
+    if (offsets) {
+        offsets->centers.push_back(p.x);
+        offsets->centers.push_back(p.y);
+        offsets->offsets.push_back(ox);
+        offsets->offsets.push_back(oy);
+    }
+    return addVertex(mesh, p.x + hw * ox, p.y + hw * oy);
+}
+
+/// @brief the two triangles of a stroked segment from the left and right
+/// vertices at its start to those at its end
+inline void addQuad(indexed_mesh_t &mesh, const uint32_t start[2],
+                    const uint32_t end[2]) {
+    addTriangle(mesh, start[0], start[1], end[0]);
+    addTriangle(mesh, start[1], end[1], end[0]);
+}
+
+/// @brief fan around center from vertex from, along the circle of radius r
+/// starting in the unit direction o and turning by angle, to vertex to
+inline void addRoundFan(indexed_mesh_t &mesh, stroke_offsets_t *offsets,
+                        const vertex_2d_t &center, const VGfloat r,
+                        const vertex_2d_t &o, const VGfloat angle,
+                        const uint32_t steps, const uint32_t from,
+                        const uint32_t to) {
+    const uint32_t c    = addStrokeVertex(mesh, offsets, center, 0, 0, r);
+    uint32_t       prev = from;
+    for (uint32_t k = 1; k < steps; k++) {
+        const VGfloat  a   = angle * k / steps;
+        const VGfloat  cs  = cosf(a);
+        const VGfloat  sn  = sinf(a);
+        const uint32_t cur = addStrokeVertex(mesh, offsets, center,
+                                             o.x * cs - o.y * sn,
+                                             o.x * sn + o.y * cs, r);
+        addTriangle(mesh, c, prev, cur);
+        prev = cur;
+    }
+    addTriangle(mesh, c, prev, to);
+}
+
+} // namespace
+
 void ITessellator::buildStroke(const std::vector<VGubyte> &segments,
-                               const std::vector<VGfloat> &fcoords,
-                               const float                 stroke_width,
+                               const path_coords_t        &coords,
+                               const stroke_style_t       &style,
                                const uint32_t              tess_iterations,
-                               std::vector<vertex_2d_t>   &vertices) {
-
-    vertices.clear();
-
-    auto        coords_it = fcoords.begin();
-    VGbyte      segment   = VG_CLOSE_PATH;
-    vertex_2d_t coords    = {0, 0};
-    vertex_2d_t prev      = {0, 0};
-    vertex_2d_t closeTo   = {0, 0};
-    for (const auto &segment : segments) {
-
-        // todo: deal with relative move
-        bool isRelative = segment & VG_RELATIVE;
-        switch (segment >> 1) {
-        case (VG_CLOSE_PATH >> 1): {
-            buildFatLineSegment(vertices, coords, closeTo, stroke_width);
-        } break;
-        case (VG_MOVE_TO >> 1): {
-            prev.x = closeTo.x = coords.x = *coords_it;
-            coords_it++;
-            prev.y = closeTo.y = coords.y = *coords_it;
-            coords_it++;
+                               indexed_mesh_t             &mesh) {
+    flatten(segments, coords, tess_iterations, _flattened);
+    buildStroke(_flattened, style, tess_iterations, mesh);
+}
 
-        } break;
-        case (VG_LINE_TO >> 1): {
-            prev     = coords;
-            coords.x = *coords_it;
-            coords_it++;
-            coords.y = *coords_it;
-            coords_it++;
-            if (isRelative) {
-                coords.x += prev.x;
-                coords.y += prev.y;
+void ITessellator::buildStroke(const flattened_path_t &path,
+                               const stroke_style_t   &style,
+                               const uint32_t          tess_iterations,
+                               indexed_mesh_t         &mesh,
+                               stroke_offsets_t       *offsets) {
+    mesh.clear();
+    if (offsets) {
+        offsets->clear();
+    }
+    // hairlines are drawn one pixel wide whatever the width
+    mesh.lines = style.hairline;
+    if (style.width <= 0 && !style.hairline) {
+        return;
+    }
+    _stroke_offsets = offsets;
+    const bool   dashed = prepareDashes(style);
+    dash_state_t dash   = {};
+    bool         first  = true;
+    for (const contour_t &contour : path.contours) {
+        strokePoints(path, contour);
+        if (!dashed) {
+            strokeContour(_stroke_points.data(),
+                          (uint32_t)_stroke_points.size(), contour.closed,
+                          style, tess_iterations, mesh);
+            continue;
+        }
+        // without the reset the pattern carries on from the last contour
+        if (first || style.dash_phase_reset) {
+            dash  = dashStart(style);
+            first = false;
+        }
+        dashContour(contour.closed, dash, style, tess_iterations, mesh);
+    }
+    _stroke_offsets = nullptr;
+}
+
+bool ITessellator::rescaleStroke(const stroke_offsets_t &offsets,
+                                 const stroke_style_t   &style,
+                                 const uint32_t          tess_iterations,
+                                 indexed_mesh_t         &mesh) const {
+    const VGfloat hw = style.width * 0.5f;
+    if (hw <= 0 || hw > offsets.max_half_width ||
+        offsets.centers.size() != mesh.vertices.size()) {
+        return false;
+    }
+    // finer round joins and caps than the tolerance needs are fine
+    if (offsets.arc_steps != 0 &&
+        arcSteps(hw, tess_iterations) > offsets.arc_steps) {
+        return false;
+    }
+    // one multiply add per coordinate, which the compiler vectorizes
+    const VGfloat *c = offsets.centers.data();
+    const VGfloat *o = offsets.offsets.data();
+    VGfloat       *v = mesh.vertices.data();
+    const size_t   n = mesh.vertices.size();
+    for (size_t i = 0; i < n; i++) {
+        v[i] = c[i] + hw * o[i];
+    }
+    return true;
+}
+
+void ITessellator::buildStrokeSegments(
+    const flattened_path_t &path, std::vector<stroke_segment_t> &segments) {
+    segments.clear();
+    for (const contour_t &contour : path.contours) {
+        strokePoints(path, contour);
+        const vertex_2d_t *points = _stroke_points.data();
+        const uint32_t     n      = (uint32_t)_stroke_points.size();
+        if (n == 1) {
+            segments.push_back({points[0], points[0], points[0], points[0]});
+            continue;
+        }
+        const uint32_t count = contour.closed ? n : n - 1;
+        for (uint32_t i = 0; i < count; i++) {
+            const vertex_2d_t &p0 = points[i];
+            const vertex_2d_t &p1 = points[(i + 1) % n];
+            // open contours end in caps
+            const bool first = !contour.closed && i == 0;
+            const bool last  = !contour.closed && i == count - 1;
+            segments.push_back({first ? p0 : points[(i + n - 1) % n], p0, p1,
+                                last ? p1 : points[(i + 2) % n]});
+        }
+    }
+}
+
+void ITessellator::strokePoints(const flattened_path_t &path,
+                                const contour_t        &contour) {
+    // repeated points have no direction to stroke along
+    _stroke_points.clear();
+    const vertex_2d_t *points = &path.points[contour.first];
+    for (uint32_t i = 0; i < contour.count; i++) {
+        if (_stroke_points.empty() || points[i].x != _stroke_points.back().x ||
+            points[i].y != _stroke_points.back().y) {
+            _stroke_points.push_back(points[i]);
+        }
+    }
+    if (contour.closed && _stroke_points.size() > 1 &&
+        _stroke_points.front().x == _stroke_points.back().x &&
+        _stroke_points.front().y == _stroke_points.back().y) {
+        _stroke_points.pop_back();
+    }
+}
+
+bool ITessellator::prepareDashes(const stroke_style_t &style) {
+    // the last of an odd number of values is ignored and negative values
+    // are 0
+    const size_t count = style.dash_pattern.size() & ~(size_t)1;
+    _dash_lengths.clear();
+    _dash_total = 0;
+    for (size_t i = 0; i < count; i++) {
+        _dash_lengths.push_back(std::max(style.dash_pattern[i], 0.0f));
+        _dash_total += _dash_lengths.back();
+    }
+    return _dash_total > 0;
+}
+
+ITessellator::dash_state_t
+ITessellator::dashStart(const stroke_style_t &style) const {
+    VGfloat phase = fmodf(style.dash_phase, _dash_total);
+    if (phase < 0) {
+        phase += _dash_total;
+    }
+    uint32_t index = 0;
+    while (phase >= _dash_lengths[index]) {
+        phase -= _dash_lengths[index];
+        index = (index + 1) % _dash_lengths.size();
+    }
+    return {index, _dash_lengths[index] - phase};
+}
+
+void ITessellator::dashContour(const bool closed, dash_state_t &state,
+                               const stroke_style_t &style,
+                               const uint32_t        tess_iterations,
+                               indexed_mesh_t       &mesh) {
+    const vertex_2d_t *points = _stroke_points.data();
+    const uint32_t     n      = (uint32_t)_stroke_points.size();
+    bool               on     = (state.index & 1) == 0;
+    if (n == 0) {
+        return;
+    }
+    if (n == 1) {
+        if (on) {
+            strokeContour(points, 1, false, style, tess_iterations, mesh);
+        }
+        return;
+    }
+
+    const auto addDashPoint = [this](const vertex_2d_t &p) {
+        if (_dash_points.empty() || p.x != _dash_points.back().x ||
+            p.y != _dash_points.back().y) {
+            _dash_points.push_back(p);
+        }
+    };
+    const auto strokeDash = [&]() {
+        strokeContour(_dash_points.data(), (uint32_t)_dash_points.size(),
+                      false, style, tess_iterations, mesh);
+        _dash_points.clear();
+    };
+
+    // a closed contour starting in a dash continues that dash when it comes
+    // around. the first dash is only remembered by where it ends and is
+    // walked again at the end.
+    const bool  started_first     = closed && on;
+    bool        first_open        = started_first;
+    uint32_t    first_end_segment = 0;
+    vertex_2d_t first_end         = {0, 0};
+    _dash_points.clear();
+    if (on && !first_open) {
+        _dash_points.push_back(points[0]);
+    }
+
+    const uint32_t segments = closed ? n : n - 1;
+    for (uint32_t i = 0; i < segments; i++) {
+        const vertex_2d_t &a   = points[i];
+        const vertex_2d_t &b   = points[(i + 1) % n];
+        const VGfloat      dx  = b.x - a.x;
+        const VGfloat      dy  = b.y - a.y;
+        const VGfloat      len = sqrtf(dx * dx + dy * dy);
+
+        // every dash element ending on the segment
+        VGfloat t = 0;
+        while (len - t > state.left) {
+            if (t + state.left == t && state.left > 0) {
+                // dashes below the float precision of the segment
+                break;
+            }
+            t += state.left;
+            const vertex_2d_t p = {a.x + dx * (t / len), a.y + dy * (t / len)};
+            if (!on) {
+                _dash_points.clear();
+                _dash_points.push_back(p);
+            } else if (first_open) {
+                first_open        = false;
+                first_end_segment = i;
+                first_end         = p;
+            } else {
+                addDashPoint(p);
+                strokeDash();
+            }
+            on          = !on;
+            state.index = (state.index + 1) % _dash_lengths.size();
+            state.left  = _dash_lengths[state.index];
+        }
+        state.left = std::max(state.left - (len - t), 0.0f);
+        if (on && !first_open) {
+            addDashPoint(b);
+        }
+    }
+
+    if (first_open) {
+        // one dash all the way around
+        strokeContour(points, n, true, style, tess_iterations, mesh);
+        return;
+    }
+    if (started_first) {
+        // the last dash runs on into the first one, or the first one is
+        // stroked on its own
+        if (!on) {
+            _dash_points.clear();
+        }
+        for (uint32_t i = 0; i <= first_end_segment; i++) {
+            addDashPoint(points[i]);
+        }
+        addDashPoint(first_end);
+        strokeDash();
+    } else if (on) {
+        strokeDash();
+    }
+}
+
+void ITessellator::strokeContour(const vertex_2d_t *points, const uint32_t n,
+                                 const bool            closed,
+                                 const stroke_style_t &style,
+                                 const uint32_t        tess_iterations,
+                                 indexed_mesh_t       &mesh) {
+    if (n == 0) {
+        return;
+    }
+    if (style.hairline) {
+        addHairlines(points, n, closed, mesh);
+        return;
+    }
+
+    // a zero length contour is a dot in the shape of the caps, squares
+    // aligned with the axes
+    if (n == 1) {
+        if (style.cap == VG_CAP_BUTT) {
+            return;
+        }
+        uint32_t start[2], end[2];
+        strokeCap(points[0], {-1, 0}, style, tess_iterations, mesh, start);
+        strokeCap(points[0], {1, 0}, style, tess_iterations, mesh, end);
+        if (style.cap == VG_CAP_SQUARE) {
+            const uint32_t left_to_right[2] = {start[1], start[0]};
+            addQuad(mesh, left_to_right, end);
+        }
+        return;
+    }
+
+    // unit direction and length of the segment from point i to the next
+    const auto segment = [&](const uint32_t i, VGfloat &len) {
+        const vertex_2d_t &p0 = points[i];
+        const vertex_2d_t &p1 = points[(i + 1) % n];
+        const VGfloat      dx = p1.x - p0.x;
+        const VGfloat      dy = p1.y - p0.y;
+        len                   = sqrtf(dx * dx + dy * dy);
+        return vertex_2d_t{dx / len, dy / len};
+    };
+
+    VGfloat     len0, len1;
+    vertex_2d_t d0 = segment(0, len0);
+    vertex_2d_t d1;
+    uint32_t    prev[2], end[2], start[2];
+    uint32_t    close[2]; // end of the closing segment
+    if (closed) {
+        VGfloat           len_last;
+        const vertex_2d_t d_last = segment(n - 1, len_last);
+        strokeJoin(points[0], d_last, len_last, d0, len0, style,
+                   tess_iterations, mesh, close, prev);
+    } else {
+        uint32_t side[2];
+        strokeCap(points[0], {-d0.x, -d0.y}, style, tess_iterations, mesh,
+                  side);
+        prev[0] = side[1];
+        prev[1] = side[0];
+    }
+
+    const uint32_t joins = closed ? n : n - 1;
+    for (uint32_t j = 1; j < joins; j++) {
+        d1 = segment(j, len1);
+        strokeJoin(points[j], d0, len0, d1, len1, style, tess_iterations,
+                   mesh, end, start);
+        addQuad(mesh, prev, end);
+        prev[0] = start[0];
+        prev[1] = start[1];
+        d0      = d1;
+        len0    = len1;
+    }
+
+    if (closed) {
+        addQuad(mesh, prev, close);
+    } else {
+        strokeCap(points[n - 1], d0, style, tess_iterations, mesh, end);
+        addQuad(mesh, prev, end);
+    }
+}
+
+void ITessellator::addHairlines(const vertex_2d_t *points, const uint32_t n,
+                                const bool closed, indexed_mesh_t &mesh) {
+    // a dot has no line to draw
+    if (n < 2) {
+        return;
+    }
+    const uint32_t base  = mesh.vertexCount();
+    const uint32_t lines = closed && n > 2 ? n : n - 1;
+    mesh.vertices.reserve(mesh.vertices.size() + 2 * n);
+    mesh.indices.reserve(mesh.indices.size() + 2 * lines);
+    for (uint32_t i = 0; i < n; i++) {
+        mesh.vertices.push_back(points[i].x);
+        mesh.vertices.push_back(points[i].y);
+    }
+    for (uint32_t i = 0; i < lines; i++) {
+        mesh.indices.push_back(base + i);
+        mesh.indices.push_back(base + (i + 1) % n);
+    }
+}
+
+void ITessellator::strokeJoin(const vertex_2d_t &p, const vertex_2d_t &d0,
+                              const VGfloat len0, const vertex_2d_t &d1,
+                              const VGfloat len1, const stroke_style_t &style,
+                              const uint32_t tess_iterations,
+                              indexed_mesh_t &mesh, uint32_t end[2],
+                              uint32_t start[2]) {
+    const VGfloat     hw    = style.width * 0.5f;
+    const vertex_2d_t n0    = {-d0.y, d0.x}; // left normals
+    const vertex_2d_t n1    = {-d1.y, d1.x};
+    const VGfloat     dot   = d0.x * d1.x + d0.y * d1.y;
+    const VGfloat     cross = d0.x * d1.y - d0.y * d1.x;
+
+    // the miter: where the offset edges of the two segments meet is hw * m
+    // from p, and |m| is the miter length over the stroke width
+    const bool  reverses = 1 + dot <= kReversalEpsilon;
+    vertex_2d_t m        = {0, 0};
+    VGfloat     m_len    = VG_MAX_FLOAT;
+    if (!reverses) {
+        m     = {(n0.x + n1.x) / (1 + dot), (n0.y + n1.y) / (1 + dot)};
+        m_len = sqrtf(m.x * m.x + m.y * m.y);
+    }
+
+    // both segments share the miter vertices when the outer one is the
+    // join, or close enough to the round or bevel join, and the inner one
+    // stays on the near half of both segments, so the segments still cover
+    // each other's corners and the next join does not cross this one. the
+    // inner vertex moves hw * tan(turn / 2) along the segments and the
+    // corners reach hw * sin(turn) into them.
+    //
+    // joins that do not share their vertices suit any width. strokes
+    // recorded for rescaling share only joins that still would at
+    // kScaleHeadroom times the width and keep the widest half width all of
+    // them suit. See: rescaleStroke()
+    stroke_offsets_t *offsets = _stroke_offsets;
+    if (!reverses) {
+        const VGfloat inner  = std::min(1.0f, 1 + dot) * std::min(len0, len1);
+        const VGfloat reach  = offsets ? hw * kScaleHeadroom : hw;
+        const bool    fits   = 2 * reach * fabsf(cross) <= inner;
+        bool          shared = false;
+        VGfloat       widest = VG_MAX_FLOAT;
+        if (fits && style.join == VG_JOIN_MITER) {
+            shared = m_len <= style.miter_limit;
+        } else if (fits && _tolerance > 0) {
+            shared = hw * (m_len - 1) <= _tolerance;
+            if (m_len > 1) {
+                widest = _tolerance / (m_len - 1);
             }
+        } else if (fits) {
+            shared = m_len - 1 <= kSmoothJoinError;
+        }
+        if (shared) {
+            if (offsets) {
+                if (fabsf(cross) > 0) {
+                    widest = std::min(widest, inner / (2 * fabsf(cross)));
+                }
+                offsets->max_half_width =
+                    std::min(offsets->max_half_width, widest);
+            }
+            end[0] = start[0] =
+                addStrokeVertex(mesh, offsets, p, m.x, m.y, hw);
+            end[1] = start[1] =
+                addStrokeVertex(mesh, offsets, p, -m.x, -m.y, hw);
+            return;
+        }
+    }
+
+    end[0]   = addStrokeVertex(mesh, offsets, p, n0.x, n0.y, hw);
+    end[1]   = addStrokeVertex(mesh, offsets, p, -n0.x, -n0.y, hw);
+    start[0] = addStrokeVertex(mesh, offsets, p, n1.x, n1.y, hw);
+    start[1] = addStrokeVertex(mesh, offsets, p, -n1.x, -n1.y, hw);
+
+    // the segments overlap on the inner side of the turn. the join fills
+    // the wedge between them on the outer side, the right when turning
+    // left. a reversal turns left.
+    const VGfloat  s    = cross >= 0 ? -1.0f : 1.0f;
+    const uint32_t from = cross >= 0 ? end[1] : end[0];
+    const uint32_t to   = cross >= 0 ? start[1] : start[0];
+
+    if (style.join == VG_JOIN_ROUND) {
+        const VGfloat  turn  = atan2f(fabsf(cross), dot);
+        const uint32_t arc   = arcSteps(hw, tess_iterations);
+        const uint32_t steps = (uint32_t)std::max(
+            1.0f, ceilf(turn / (2 * (VGfloat)M_PI) * arc));
+        if (offsets) {
+            offsets->arc_steps = arc;
+        }
+        addRoundFan(mesh, offsets, p, hw, {s * n0.x, s * n0.y}, -s * turn,
+                    steps, from, to);
+        return;
+    }
+    if (reverses) {
+        // a bevel across a reversal has no area and its miter no end
+        return;
+    }
+    const uint32_t c = addStrokeVertex(mesh, offsets, p, 0, 0, hw);
+    if (style.join == VG_JOIN_MITER && m_len <= style.miter_limit) {
+        const uint32_t tip =
+            addStrokeVertex(mesh, offsets, p, s * m.x, s * m.y, hw);
+        addTriangle(mesh, c, from, tip);
+        addTriangle(mesh, c, tip, to);
+    } else {
+        addTriangle(mesh, c, from, to);
+    }
+}
+
+void ITessellator::strokeCap(const vertex_2d_t &p, const vertex_2d_t &d,
+                             const stroke_style_t &style,
+                             const uint32_t        tess_iterations,
+                             indexed_mesh_t &mesh, uint32_t side[2]) {
+    const VGfloat     hw = style.width * 0.5f;
+    const vertex_2d_t n  = {-d.y, d.x}; // left normal
+
+    // a square cap moves the end of the segment out by half the width
+    vertex_2d_t out = {0, 0};
+    if (style.cap == VG_CAP_SQUARE) {
+        out = d;
+    }
+    stroke_offsets_t *offsets = _stroke_offsets;
+    side[0] = addStrokeVertex(mesh, offsets, p, out.x + n.x, out.y + n.y, hw);
+    side[1] = addStrokeVertex(mesh, offsets, p, out.x - n.x, out.y - n.y, hw);
+
+    if (style.cap == VG_CAP_ROUND) {
+        // half a circle from the left through d to the right
+        const uint32_t arc   = arcSteps(hw, tess_iterations);
+        const uint32_t steps = std::max<uint32_t>(2, (arc + 1) / 2);
+        if (offsets) {
+            offsets->arc_steps = arc;
+        }
+        addRoundFan(mesh, offsets, p, hw, n, -(VGfloat)M_PI, steps, side[0],
+                    side[1]);
+    }
+}
+
+uint32_t ITessellator::quadSteps(const vertex_2d_t &p0, const vertex_2d_t &p1,
+                                 const vertex_2d_t &p2,
+                                 const uint32_t     tess_iterations) const {
+    if (_tolerance <= 0) {
+        return std::max<uint32_t>(1, tess_iterations);
+    }
+    return wangSteps(secondDifference(p0, p1, p2), 2.0f / 8.0f, _tolerance);
+}
+
+uint32_t ITessellator::cubicSteps(const vertex_2d_t &p0, const vertex_2d_t &p1,
+                                  const vertex_2d_t &p2, const vertex_2d_t &p3,
+                                  const uint32_t tess_iterations) const {
+    if (_tolerance <= 0) {
+        return std::max<uint32_t>(1, tess_iterations);
+    }
+    const VGfloat dd = std::max(secondDifference(p0, p1, p2),
+                                secondDifference(p1, p2, p3));
+    return wangSteps(dd, 6.0f / 8.0f, _tolerance);
+}
+
+uint32_t ITessellator::arcSteps(const VGfloat  radius,
+                                const uint32_t tess_iterations) const {
+    return ellipseSteps(radius, _tolerance, tess_iterations);
+}
+
+void ITessellator::flatten(const std::vector<VGubyte> &segments,
+                           const path_coords_t        &coords,
+                           const uint32_t              tess_iterations,
+                           flattened_path_t           &path) {
+    flatten(segments.data(), segments.size(), coords, 0, tess_iterations,
+            path);
+}
+
+void ITessellator::flatten(const VGubyte *segments, const size_t num_segments,
+                           const path_coords_t &coords,
+                           const size_t first_coord,
+                           const uint32_t tess_iterations,
+                           flattened_path_t &path) {
+    coords.visit([&](auto cursor) {
+        cursor += first_coord;
+        flattenCoords(segments, num_segments, cursor, tess_iterations, path);
+    });
+}
 
-            buildFatLineSegment(vertices, prev, coords, stroke_width);
+template <typename Cursor>
+void ITessellator::flattenCoords(const VGubyte *segments,
+                                 const size_t   num_segments,
+                                 Cursor         coords_it,
+                                 const uint32_t tess_iterations,
+                                 flattened_path_t &path) {
+    path.clear();
 
+    vertex_2d_t    coords    = {0, 0}; // current point
+    vertex_2d_t    closeTo   = {0, 0}; // start of the current contour
+    vertex_2d_t    ctrl      = {0, 0}; // last control point (smooth curves)
+    bool           in_contour = false;
+
+    for (size_t i = 0; i < num_segments; i++) {
+        const VGubyte segment    = segments[i];
+        const bool    isRelative = segment & VG_RELATIVE;
+        const VGubyte type       = segment & ~VG_RELATIVE;
+        const VGfloat ox         = isRelative ? coords.x : 0;
+        const VGfloat oy         = isRelative ? coords.y : 0;
+
+        // segments following a close without a move start a new contour at
+        // the current point
+        if (type != VG_CLOSE_PATH && type != VG_MOVE_TO && !in_contour) {
+            beginContour(path, coords);
+            in_contour = true;
+        }
+
+        switch (type) {
+        case VG_CLOSE_PATH: {
+            if (in_contour) {
+                path.contours.back().closed       = true;
+                path.contours.back().has_segments = true;
+                in_contour                        = false;
+            }
+            coords = ctrl = closeTo;
+        } break;
+        case VG_MOVE_TO: {
+            coords.x = ox + coords_it[0];
+            coords.y = oy + coords_it[1];
+            coords_it += 2;
+            closeTo = ctrl = coords;
+            beginContour(path, coords);
+            in_contour = true;
         } break;
-        case (VG_HLINE_TO >> 1): {
-            prev     = coords;
-            coords.x = *coords_it;
-            coords_it++;
-            if (isRelative) {
-                coords.x += prev.x;
+        case VG_LINE_TO: {
+            coords.x = ox + coords_it[0];
+            coords.y = oy + coords_it[1];
+            coords_it += 2;
+            ctrl = coords;
+            addPoint(path, coords);
+        } break;
+        case VG_HLINE_TO: {
+            coords.x = ox + coords_it[0];
+            coords_it += 1;
+            ctrl = coords;
+            addPoint(path, coords);
+        } break;
+        case VG_VLINE_TO: {
+            coords.y = oy + coords_it[0];
+            coords_it += 1;
+            ctrl = coords;
+            addPoint(path, coords);
+        } break;
+        case VG_QUAD_TO:
+        case VG_SQUAD_TO: {
+            vertex_2d_t cp;
+            if (type == VG_QUAD_TO) {
+                cp.x = ox + coords_it[0];
+                cp.y = oy + coords_it[1];
+                coords_it += 2;
+            } else {
+                // reflect the previous control point about the current point
+                cp.x = 2.0f * coords.x - ctrl.x;
+                cp.y = 2.0f * coords.y - ctrl.y;
             }
+            vertex_2d_t p;
+            p.x = ox + coords_it[0];
+            p.y = oy + coords_it[1];
+            coords_it += 2;
 
-            buildFatLineSegment(vertices, prev, coords, stroke_width);
+            const uint32_t steps = quadSteps(coords, cp, p, tess_iterations);
+            evalQuadBezier(coords, cp, p, steps, reservePoints(path, steps));
+            commitPoints(path, steps);
+            coords = p;
+            ctrl   = cp;
         } break;
-        case (VG_VLINE_TO >> 1): {
-            prev     = coords;
-            coords.y = *coords_it;
-            coords_it++;
-            if (isRelative) {
-                coords.y += prev.y;
+        case VG_CUBIC_TO:
+        case VG_SCUBIC_TO: {
+            vertex_2d_t cp1;
+            if (type == VG_CUBIC_TO) {
+                cp1.x = ox + coords_it[0];
+                cp1.y = oy + coords_it[1];
+                coords_it += 2;
+            } else {
+                // reflect the previous control point about the current point
+                cp1.x = 2.0f * coords.x - ctrl.x;
+                cp1.y = 2.0f * coords.y - ctrl.y;
             }
+            vertex_2d_t cp2, p;
+            cp2.x = ox + coords_it[0];
+            cp2.y = oy + coords_it[1];
+            p.x   = ox + coords_it[2];
+            p.y   = oy + coords_it[3];
+            coords_it += 4;
 
-            buildFatLineSegment(vertices, prev, coords, stroke_width);
+            const uint32_t steps =
+                cubicSteps(coords, cp1, cp2, p, tess_iterations);
+            evalCubicBezier(coords, cp1, cp2, p, steps,
+                            reservePoints(path, steps));
+            commitPoints(path, steps);
+            coords = p;
+            ctrl   = cp2;
+        } break;
+        case VG_SCCWARC_TO:
+        case VG_SCWARC_TO:
+        case VG_LCCWARC_TO:
+        case VG_LCWARC_TO: {
+            const VGfloat rh  = coords_it[0];
+            const VGfloat rv  = coords_it[1];
+            const VGfloat rot = coords_it[2];
+            vertex_2d_t   p;
+            p.x = ox + coords_it[3];
+            p.y = oy + coords_it[4];
+            coords_it += 5;
 
+            addArc(path, coords, rh, rv, rot, p,
+                   type == VG_LCCWARC_TO || type == VG_LCWARC_TO,
+                   type == VG_SCCWARC_TO || type == VG_LCCWARC_TO, _tolerance,
+                   tess_iterations);
+            coords = ctrl = p;
         } break;
-        case (VG_SCUBIC_TO >> 1): {
-            prev         = coords;
-            VGfloat cp2x = *coords_it;
-            coords_it++;
-            VGfloat cp2y = *coords_it;
-            coords_it++;
-            VGfloat p3x = *coords_it;
-            coords_it++;
-            VGfloat p3y = *coords_it;
-            coords_it++;
-
-            if (isRelative) {
-                cp2x += prev.x;
-                cp2y += prev.y;
-                p3x += prev.x;
-                p3y += prev.y;
+
+        default:
+            throw std::runtime_error("Unknown segment type");
+            break;
+        }
+    } // foreach segment
+
+    dropLoneMove(path);
+}
+
+void ITessellator::tessellate(const std::vector<VGubyte> &segments,
+                              const path_coords_t        &coords,
+                              const VGFillRule            fill_rule,
+                              const uint32_t              tess_iterations,
+                              std::vector<VGfloat>       &vertices,
+                              bounding_box_t             &bounding_box) {
+    flatten(segments, coords, tess_iterations, _flattened);
+    tessellate(_flattened, fill_rule, vertices, bounding_box);
+}
+
+void ITessellator::tessellateIndexed(const std::vector<VGubyte> &segments,
+                                     const path_coords_t        &coords,
+                                     const VGFillRule            fill_rule,
+                                     const uint32_t              tess_iterations,
+                                     indexed_mesh_t             &mesh,
+                                     bounding_box_t             &bounding_box) {
+    flatten(segments, coords, tess_iterations, _flattened);
+    tessellateIndexed(_flattened, fill_rule, mesh, bounding_box);
+}
+
+size_t ITessellator::maxEarClipVertices() const {
+    return kMaxEarClipVertices;
+}
+
+void ITessellator::tessellateIndexed(const flattened_path_t &path,
+                                     const VGFillRule        fill_rule,
+                                     indexed_mesh_t         &mesh,
+                                     bounding_box_t         &bounding_box) {
+    // a single convex or simple contour fills the same with either fill
+    // rule and does not need the general tessellator
+    if (singleContour(path)) {
+        if (isConvexPolygon()) {
+            triangulateFan(mesh, bounding_box);
+            _fill_routes[(size_t)FillRoute::Convex]++;
+            return;
+        }
+        if (_polygon.size() <= maxEarClipVertices() && isSimplePolygon() &&
+            triangulateEars(mesh, bounding_box)) {
+            _fill_routes[(size_t)FillRoute::Simple]++;
+            return;
+        }
+    }
+
+    _soup.clear();
+    tessellate(path, fill_rule, _soup, bounding_box);
+    weldVertices(_soup, mesh);
+    optimizeVertexCache(mesh);
+    _fill_routes[(size_t)FillRoute::General]++;
+}
+
+bool ITessellator::tessellateContours(
+    const std::vector<VGubyte> &segments, const path_coords_t &coords,
+    const VGFillRule fill_rule, const uint32_t tess_iterations,
+    indexed_mesh_t &mesh, bounding_box_t &bounding_box,
+    std::vector<fill_contour_t> &contours) {
+    // a contour starts at every move. a relative move or segments before
+    // the first move would depend on the contour before.
+    contours.clear();
+    size_t coord = 0;
+    for (size_t i = 0; i < segments.size(); i++) {
+        if ((segments[i] & ~VG_RELATIVE) == VG_MOVE_TO) {
+            if (segments[i] & VG_RELATIVE) {
+                contours.clear();
+                return false;
             }
+            fill_contour_t contour = {};
+            contour.first_segment  = i;
+            contour.first_coord    = coord;
+            contours.push_back(contour);
+        } else if (contours.empty()) {
+            return false;
+        }
+        contours.back().num_segments++;
+        coord += IPath::segmentToNumCoordinates(
+            static_cast<VGPathSegment>(segments[i]));
+    }
 
-            VGfloat cp1x = 2.0f * cp2x - p3x;
-            VGfloat cp1y = 2.0f * cp2y - p3y;
-
-            VGfloat increment = 1.0f / float(tess_iterations);
-            // printf("\tcubic: ");
-            for (VGfloat t = increment; t < 1.0f + increment; t += increment) {
-                vertex_2d_t c;
-                c.x = calcCubicBezier1d(coords.x, cp1x, cp2x, p3x, t);
-                c.y = calcCubicBezier1d(coords.y, cp1y, cp2y, p3y, t);
-                buildFatLineSegment(vertices, prev, c, stroke_width);
-                prev = c;
+    // flattening is cheap next to tessellating, so the contours are checked
+    // for overlaps before any of them is tessellated
+    for (fill_contour_t &contour : contours) {
+        flatten(&segments[contour.first_segment], contour.num_segments,
+                coords, contour.first_coord, tess_iterations, _flattened);
+        contour.bounds = {VG_MAX_FLOAT, VG_MAX_FLOAT, -VG_MAX_FLOAT,
+                          -VG_MAX_FLOAT};
+        for (const vertex_2d_t &p : _flattened.points) {
+            contour.bounds.update(p.x, p.y);
+        }
+    }
+    _contour_order.resize(contours.size());
+    for (uint32_t i = 0; i < _contour_order.size(); i++) {
+        _contour_order[i] = i;
+    }
+    std::sort(_contour_order.begin(), _contour_order.end(),
+              [&contours](const uint32_t a, const uint32_t b) {
+                  return contours[a].bounds.min_x < contours[b].bounds.min_x;
+              });
+    // sweep along x. empty boxes sort last and overlap nothing.
+    for (size_t a = 0; a < _contour_order.size(); a++) {
+        const bounding_box_t &box = contours[_contour_order[a]].bounds;
+        for (size_t b = a + 1;
+             b < _contour_order.size() &&
+             contours[_contour_order[b]].bounds.min_x <= box.min_x + box.width;
+             b++) {
+            if (box.overlaps(contours[_contour_order[b]].bounds)) {
+                contours.clear();
+                return false;
             }
-            coords.x = p3x;
-            coords.y = p3y;
+        }
+    }
 
-        } break;
+    mesh.clear();
+    for (fill_contour_t &contour : contours) {
+        contour.bounds = {VG_MAX_FLOAT, VG_MAX_FLOAT, -VG_MAX_FLOAT,
+                          -VG_MAX_FLOAT};
+        tessellateContour(&segments[contour.first_segment],
+                          contour.num_segments, coords, contour.first_coord,
+                          fill_rule, tess_iterations, _contour_mesh,
+                          contour.bounds);
+        contour.first_vertex = mesh.vertexCount();
+        contour.num_vertices = _contour_mesh.vertexCount();
+        contour.first_index  = (uint32_t)mesh.indices.size();
+        contour.num_indices  = (uint32_t)_contour_mesh.indices.size();
+        mesh.vertices.insert(mesh.vertices.end(),
+                             _contour_mesh.vertices.begin(),
+                             _contour_mesh.vertices.end());
+        for (const uint32_t index : _contour_mesh.indices) {
+            mesh.indices.push_back(contour.first_vertex + index);
+        }
+        if (contour.bounds.width >= 0) {
+            bounding_box.update(contour.bounds.min_x, contour.bounds.min_y);
+            bounding_box.update(contour.bounds.min_x + contour.bounds.width,
+                                contour.bounds.min_y + contour.bounds.height);
+        }
+    }
+    return true;
+}
+
+void ITessellator::tessellateContour(const VGubyte       *segments,
+                                     const size_t         num_segments,
+                                     const path_coords_t &coords,
+                                     const size_t         first_coord,
+                                     const VGFillRule     fill_rule,
+                                     const uint32_t       tess_iterations,
+                                     indexed_mesh_t      &mesh,
+                                     bounding_box_t      &bounding_box) {
+    flatten(segments, num_segments, coords, first_coord, tess_iterations,
+            _flattened);
+    tessellateIndexed(_flattened, fill_rule, mesh, bounding_box);
+}
+
+void ITessellator::tessellateShape(const shape_descriptor_t &shape,
+                                   const uint32_t            tess_iterations,
+                                   indexed_mesh_t           &mesh,
+                                   bounding_box_t           &bounding_box) {
+    using Type           = shape_descriptor_t::Type;
+    const VGfloat two_pi = 2.0f * (VGfloat)M_PI;
+    // the corner ellipse of round rects, the ellipse otherwise
+    const bool    round  = shape.type == Type::RoundRect;
+    const VGfloat rx     = (round ? shape.arc_width : shape.width) / 2;
+    const VGfloat ry     = (round ? shape.arc_height : shape.height) / 2;
+    _polygon.clear();
+
+    switch (shape.type) {
+    case Type::RoundRect:
+        if (rx > 0 && ry > 0) {
+            // a quarter of the segments of the corner ellipse per corner
+            const uint32_t steps =
+                (arcSteps(std::max(rx, ry), tess_iterations) + 3) / 4;
+            const VGfloat quarter = (VGfloat)M_PI / 2;
+            const VGfloat x0      = shape.x + rx;
+            const VGfloat x1      = shape.x + shape.width - rx;
+            const VGfloat y0      = shape.y + ry;
+            const VGfloat y1      = shape.y + shape.height - ry;
+            addEllipsePoints(_polygon, x1, y0, rx, ry, -quarter, quarter,
+                             steps);
+            addEllipsePoints(_polygon, x1, y1, rx, ry, 0, quarter, steps);
+            addEllipsePoints(_polygon, x0, y1, rx, ry, quarter, quarter,
+                             steps);
+            addEllipsePoints(_polygon, x0, y0, rx, ry, 2 * quarter, quarter,
+                             steps);
+            break;
+        }
+        [[fallthrough]]; // square corners
+    case Type::Rect:
+        _polygon.push_back({shape.x, shape.y});
+        _polygon.push_back({shape.x + shape.width, shape.y});
+        _polygon.push_back({shape.x + shape.width, shape.y + shape.height});
+        _polygon.push_back({shape.x, shape.y + shape.height});
+        break;
+    case Type::Ellipse: {
+        const uint32_t steps =
+            std::max<uint32_t>(3, arcSteps(std::max(rx, ry), tess_iterations));
+        addEllipsePoints(_polygon, shape.x, shape.y, rx, ry, 0, two_pi,
+                         steps);
+        _polygon.pop_back(); // same as the first
+        break;
+    }
+    case Type::Arc: {
+        const VGfloat  turns = fabsf(shape.angle_extent) / two_pi;
+        const uint32_t steps = std::max<uint32_t>(
+            1, (uint32_t)ceilf(
+                   arcSteps(std::max(rx, ry), tess_iterations) * turns));
+        // a pie fans from its center, which sees every point of the arc.
+        // open and chord arcs fill the same: the arc and its chord.
+        if (shape.pie) {
+            _polygon.push_back({shape.x, shape.y});
+        }
+        addEllipsePoints(_polygon, shape.x, shape.y, rx, ry,
+                         shape.start_angle, shape.angle_extent, steps);
+        break;
+    }
+    default:
+        throw std::runtime_error("Unknown shape type");
+    }
+
+    if (_polygon.size() < 3) {
+        mesh.clear();
+    } else {
+        triangulateFan(mesh, bounding_box);
+    }
+    _fill_routes[(size_t)FillRoute::Shape]++;
+}
+
+uint32_t ITessellator::measureShape(const shape_descriptor_t &shape,
+                                    const uint32_t            tess_iterations,
+                                    bounding_box_t           &bounding_box) {
+    VGfloat rect[4], radius[2];
+    shape.roundRect(rect, radius);
+    bounding_box = {rect[0], rect[1], rect[2], rect[3]};
+
+    // tessellateShape() gives an ellipse at least a triangle
+    uint32_t steps = arcSteps(std::max(radius[0], radius[1]), tess_iterations);
+    if (shape.type == shape_descriptor_t::Type::Ellipse) {
+        steps = std::max<uint32_t>(3, steps);
+    }
+    _fill_routes[(size_t)FillRoute::Shape]++;
+    return (steps + 3) / 4;
+}
+
+bool ITessellator::singleContour(const flattened_path_t &path) {
+    const contour_t *single = nullptr;
+    for (const contour_t &contour : path.contours) {
+        if (contour.count < 3) {
+            continue; // encloses nothing
+        }
+        if (single) {
+            return false;
+        }
+        single = &contour;
+    }
+    if (!single) {
+        return false;
+    }
+
+    const vertex_2d_t *points = &path.points[single->first];
+    _polygon.assign(points, points + single->count);
+    while (_polygon.size() > 1 && _polygon.back().x == _polygon[0].x &&
+           _polygon.back().y == _polygon[0].y) {
+        _polygon.pop_back();
+    }
+    for (const vertex_2d_t &p : _polygon) {
+        if (!std::isfinite(p.x) || !std::isfinite(p.y)) {
+            return false;
+        }
+    }
+    return _polygon.size() >= 3;
+}
 
-        case (VG_QUAD_TO >> 1): // added by rhcad
-        {
-            prev        = coords;
-            VGfloat cpx = *coords_it;
-            coords_it++;
-            VGfloat cpy = *coords_it;
-            coords_it++;
-            VGfloat px = *coords_it;
-            coords_it++;
-            VGfloat py = *coords_it;
-            coords_it++;
-
-            if (isRelative) {
-                cpx += prev.x;
-                cpy += prev.y;
-                px += prev.x;
-                py += prev.y;
+bool ITessellator::isConvexPolygon() const {
+    const size_t n = _polygon.size();
+
+    // every turn has the same direction and the edges change direction in x
+    // and in y at most twice, so the contour does not go around more than
+    // once like a pentagram would
+    int turn = 0;
+    int x_sign = 0, x_first = 0, x_flips = 0;
+    int y_sign = 0, y_first = 0, y_flips = 0;
+    auto track = [](const double d, int &sign, int &first, int &flips) {
+        const int s = d > 0 ? 1 : (d < 0 ? -1 : 0);
+        if (s == 0) {
+            return;
+        }
+        if (first == 0) {
+            first = s;
+        } else if (s != sign) {
+            flips++;
+        }
+        sign = s;
+    };
+
+    for (size_t i = 0; i < n; i++) {
+        const vertex_2d_t &a = _polygon[i];
+        const vertex_2d_t &b = _polygon[(i + 1) % n];
+        const vertex_2d_t &c = _polygon[(i + 2) % n];
+        const int          t = orientation(a, b, c);
+        if (t != 0) {
+            if (turn != 0 && t != turn) {
+                return false;
             }
+            turn = t;
+        }
+        track((double)b.x - a.x, x_sign, x_first, x_flips);
+        track((double)b.y - a.y, y_sign, y_first, y_flips);
+    }
+    // the flip from the last edge back around to the first
+    x_flips += x_sign != x_first;
+    y_flips += y_sign != y_first;
+    return turn != 0 && x_flips <= 2 && y_flips <= 2;
+}
+
+bool ITessellator::isSimplePolygon() const {
+    const size_t n = _polygon.size();
+    for (size_t i = 0; i < n; i++) {
+        const vertex_2d_t &a0 = _polygon[i];
+        const vertex_2d_t &a1 = _polygon[(i + 1) % n];
 
-            VGfloat increment = 1.0f / float(tess_iterations);
+        // the next edge may only share the vertex between them
+        const vertex_2d_t &a2 = _polygon[(i + 2) % n];
+        if (orientation(a0, a1, a2) == 0 &&
+            ((double)a1.x - a0.x) * ((double)a2.x - a1.x) +
+                    ((double)a1.y - a0.y) * ((double)a2.y - a1.y) <
+                0) {
+            return false; // folds back onto itself
+        }
 
-            for (VGfloat t = increment; t < 1.0f + increment; t += increment) {
-                vertex_2d_t c;
-                c.x = calcQuadBezier1d(coords.x, cpx, px, t);
-                c.y = calcQuadBezier1d(coords.y, cpy, py, t);
-                buildFatLineSegment(vertices, prev, c, stroke_width);
-                prev = c;
+        for (size_t j = i + 2; j < n; j++) {
+            if (i == 0 && j == n - 1) {
+                continue; // neighbors across the wrap
+            }
+            if (segmentsTouch(a0, a1, _polygon[j], _polygon[(j + 1) % n])) {
+                return false;
             }
-            coords.x = px;
-            coords.y = py;
+        }
+    }
+    return true;
+}
 
-        } break;
+void ITessellator::triangulateFan(indexed_mesh_t &mesh,
+                                  bounding_box_t &bounding_box) {
+    mesh.clear();
+    const uint32_t n = (uint32_t)_polygon.size();
+    mesh.vertices.reserve(n * 2);
+    for (const vertex_2d_t &p : _polygon) {
+        mesh.vertices.push_back(p.x);
+        mesh.vertices.push_back(p.y);
+        bounding_box.update(p.x, p.y);
+    }
 
-        case (VG_CUBIC_TO >> 1): // todo
-        {
-            prev         = coords;
-            VGfloat cp1x = *coords_it;
-            coords_it++;
-            VGfloat cp1y = *coords_it;
-            coords_it++;
-            VGfloat cp2x = *coords_it;
-            coords_it++;
-            VGfloat cp2y = *coords_it;
-            coords_it++;
-            VGfloat p3x = *coords_it;
-            coords_it++;
-            VGfloat p3y = *coords_it;
-            coords_it++;
-
-            if (isRelative) {
-                cp1x += prev.x;
-                cp1y += prev.y;
-                cp2x += prev.x;
-                cp2y += prev.y;
-                p3x += prev.x;
-                p3y += prev.y;
+    // consecutive triangles share two vertices, which is already the best
+    // order for the vertex cache
+    mesh.indices.reserve((n - 2) * 3);
+    for (uint32_t i = 1; i + 1 < n; i++) {
+        if (orientation(_polygon[0], _polygon[i], _polygon[i + 1]) != 0) {
+            mesh.indices.push_back(0);
+            mesh.indices.push_back(i);
+            mesh.indices.push_back(i + 1);
+        }
+    }
+}
+
+bool ITessellator::triangulateEars(indexed_mesh_t &mesh,
+                                   bounding_box_t &bounding_box) {
+    mesh.clear();
+    const uint32_t n = (uint32_t)_polygon.size();
+
+    // the winding of the polygon decides which turns are convex
+    double area = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        const vertex_2d_t &a = _polygon[i];
+        const vertex_2d_t &b = _polygon[(i + 1) % n];
+        area += (double)a.x * b.y - (double)b.x * a.y;
+    }
+    const int convex = area > 0 ? 1 : -1;
+
+    _ear_prev.resize(n);
+    _ear_next.resize(n);
+    for (uint32_t i = 0; i < n; i++) {
+        _ear_prev[i] = (i + n - 1) % n;
+        _ear_next[i] = (i + 1) % n;
+    }
+
+    auto is_ear = [&](const uint32_t i) {
+        const uint32_t     ip = _ear_prev[i];
+        const uint32_t     in = _ear_next[i];
+        const vertex_2d_t &a  = _polygon[ip];
+        const vertex_2d_t &b  = _polygon[i];
+        const vertex_2d_t &c  = _polygon[in];
+        if (orientation(a, b, c) != convex) {
+            return false;
+        }
+        // no other remaining vertex may lie in the triangle
+        const VGfloat min_x = std::min(a.x, std::min(b.x, c.x));
+        const VGfloat max_x = std::max(a.x, std::max(b.x, c.x));
+        const VGfloat min_y = std::min(a.y, std::min(b.y, c.y));
+        const VGfloat max_y = std::max(a.y, std::max(b.y, c.y));
+        for (uint32_t j = _ear_next[in]; j != ip; j = _ear_next[j]) {
+            const vertex_2d_t &p = _polygon[j];
+            if (p.x < min_x || p.x > max_x || p.y < min_y || p.y > max_y) {
+                continue;
+            }
+            if ((p.x == a.x && p.y == a.y) || (p.x == c.x && p.y == c.y)) {
+                continue;
+            }
+            if (orientation(a, b, p) != -convex &&
+                orientation(b, c, p) != -convex &&
+                orientation(c, a, p) != -convex) {
+                return false;
             }
+        }
+        return true;
+    };
+
+    mesh.indices.reserve((n - 2) * 3);
+    uint32_t remaining = n;
+    uint32_t i         = 0;
+    uint32_t misses    = 0; // vertices tried since the last clipped ear
+    while (remaining > 3) {
+        const uint32_t ip = _ear_prev[i];
+        const uint32_t in = _ear_next[i];
+        const bool     collinear =
+            orientation(_polygon[ip], _polygon[i], _polygon[in]) == 0;
+        if (collinear || is_ear(i)) {
+            if (!collinear) {
+                mesh.indices.push_back(ip);
+                mesh.indices.push_back(i);
+                mesh.indices.push_back(in);
+            }
+            _ear_next[ip] = in;
+            _ear_prev[in] = ip;
+            remaining--;
+            misses = 0;
+            i      = ip; // the neighbors may have become ears
+            continue;
+        }
+        if (++misses > remaining) {
+            return false; // went around without finding an ear
+        }
+        i = in;
+    }
+    const uint32_t ip = _ear_prev[i];
+    const uint32_t in = _ear_next[i];
+    if (orientation(_polygon[ip], _polygon[i], _polygon[in]) != 0) {
+        mesh.indices.push_back(ip);
+        mesh.indices.push_back(i);
+        mesh.indices.push_back(in);
+    }
+
+    mesh.vertices.reserve(n * 2);
+    for (const vertex_2d_t &p : _polygon) {
+        mesh.vertices.push_back(p.x);
+        mesh.vertices.push_back(p.y);
+        bounding_box.update(p.x, p.y);
+    }
+    return true;
+}
 
-            VGfloat increment = 1.0f / float(tess_iterations);
+void ITessellator::weldVertices(const std::vector<VGfloat> &soup,
+                                indexed_mesh_t             &mesh) {
+    mesh.clear();
+    const size_t soup_count = soup.size() / 2;
+    if (soup_count < 3) {
+        return;
+    }
+
+    // open addressing table at most half full
+    size_t table_size = 16;
+    while (table_size < soup_count * 2) {
+        table_size *= 2;
+    }
+    const uint32_t kEmpty = ~0u;
+    const size_t   mask   = table_size - 1;
+    _weld_table.assign(table_size, kEmpty);
 
-            for (VGfloat t = increment; t < 1.0f + increment; t += increment) {
-                vertex_2d_t c;
-                c.x = calcCubicBezier1d(coords.x, cp1x, cp2x, p3x, t);
-                c.y = calcCubicBezier1d(coords.y, cp1y, cp2y, p3y, t);
-                buildFatLineSegment(vertices, prev, c, stroke_width);
-                prev = c;
+    auto find_or_add = [&](VGfloat x, VGfloat y) -> uint32_t {
+        // -0 and +0 are the same vertex
+        x             = x == 0 ? 0.0f : x;
+        y             = y == 0 ? 0.0f : y;
+        size_t slot   = hashVertex(x, y) & mask;
+        while (_weld_table[slot] != kEmpty) {
+            const uint32_t i = _weld_table[slot];
+            if (mesh.vertices[i * 2] == x && mesh.vertices[i * 2 + 1] == y) {
+                return i;
             }
-            coords.x = p3x;
-            coords.y = p3y;
+            slot = (slot + 1) & mask;
+        }
+        const uint32_t i  = mesh.vertexCount();
+        _weld_table[slot] = i;
+        mesh.vertices.push_back(x);
+        mesh.vertices.push_back(y);
+        return i;
+    };
 
-        } break;
-        case (VG_SCCWARC_TO >> 1):
-        case (VG_SCWARC_TO >> 1):
-        case (VG_LCCWARC_TO >> 1):
-        case (VG_LCWARC_TO >> 1):
-
-        {
-            VGfloat rh = *coords_it;
-            coords_it++;
-            VGfloat rv = *coords_it;
-            coords_it++;
-            VGfloat rot = *coords_it;
-            coords_it++;
-            VGfloat cp1x = *coords_it;
-            coords_it++;
-            VGfloat cp1y = *coords_it;
-            coords_it++;
-            if (isRelative) {
-                cp1x += prev.x;
-                cp1y += prev.y;
+    mesh.indices.reserve(soup_count - soup_count % 3);
+    for (size_t v = 0; v + 2 < soup_count; v += 3) {
+        const uint32_t a = find_or_add(soup[v * 2], soup[v * 2 + 1]);
+        const uint32_t b = find_or_add(soup[v * 2 + 2], soup[v * 2 + 3]);
+        const uint32_t c = find_or_add(soup[v * 2 + 4], soup[v * 2 + 5]);
+        if (a == b || b == c || a == c) {
+            continue;
+        }
+        mesh.indices.push_back(a);
+        mesh.indices.push_back(b);
+        mesh.indices.push_back(c);
+    }
+}
+
+void ITessellator::optimizeVertexCache(indexed_mesh_t &mesh) {
+    const uint32_t vertex_count = mesh.vertexCount();
+    const uint32_t tri_count    = (uint32_t)(mesh.indices.size() / 3);
+    if (tri_count < kMinCacheOptimizeTris) {
+        return;
+    }
+    const std::vector<uint32_t> &indices = mesh.indices;
+
+    // vertex to triangle adjacency
+    _live_tris.assign(vertex_count, 0);
+    for (const uint32_t i : indices) {
+        _live_tris[i]++;
+    }
+    _adj_offsets.resize(vertex_count + 1);
+    _adj_offsets[0] = 0;
+    for (uint32_t v = 0; v < vertex_count; v++) {
+        _adj_offsets[v + 1] = _adj_offsets[v] + _live_tris[v];
+    }
+    _adj_tris.resize(indices.size());
+    _remap.assign(_adj_offsets.begin(), _adj_offsets.end() - 1); // cursors
+    for (uint32_t t = 0; t < tri_count; t++) {
+        for (uint32_t k = 0; k < 3; k++) {
+            _adj_tris[_remap[indices[t * 3 + k]]++] = t;
+        }
+    }
+
+    // initial scores
+    _cache_pos.assign(vertex_count, -1);
+    _vertex_scores.resize(vertex_count);
+    for (uint32_t v = 0; v < vertex_count; v++) {
+        _vertex_scores[v] = vertexScore(-1, _live_tris[v]);
+    }
+    _tri_scores.resize(tri_count);
+    _tri_emitted.assign(tri_count, 0);
+    int32_t best       = -1;
+    float   best_score = -1.0f;
+    for (uint32_t t = 0; t < tri_count; t++) {
+        _tri_scores[t] = _vertex_scores[indices[t * 3]] +
+                         _vertex_scores[indices[t * 3 + 1]] +
+                         _vertex_scores[indices[t * 3 + 2]];
+        if (_tri_scores[t] > best_score) {
+            best_score = _tri_scores[t];
+            best       = (int32_t)t;
+        }
+    }
+
+    std::array<uint32_t, kCacheSize + 3> cache, next_cache;
+    int32_t                              cache_count = 0;
+    uint32_t                             cursor      = 0;
+
+    _reordered.clear();
+    _reordered.reserve(indices.size());
+    for (uint32_t emitted = 0; emitted < tri_count; emitted++) {
+        if (best < 0) {
+            // nothing in the cache is useful. continue with the next triangle
+            // that has not been emitted.
+            while (_tri_emitted[cursor]) {
+                cursor++;
             }
+            best = (int32_t)cursor;
+        }
 
-            // convert to Center Parameterization (see OpenVG Spec Apendix A)
-            VGfloat   cx0[2];
-            VGfloat   cx1[2];
-            VGboolean success =
-                findEllipses(rh, rv, rot, coords.x, coords.y, cp1x, cp1y,
-                             &cx0[0], &cx0[1], &cx1[0], &cx1[1]);
-
-            if (success) {
-                // see:
-                // http://en.wikipedia.org/wiki/Ellipse#Ellipses_in_computer_graphics
-                const int steps   = float(tess_iterations);
-                VGfloat   beta    = 0; // angle. todo
-                VGfloat   sinbeta = sinf(beta);
-                VGfloat   cosbeta = cosf(beta);
-
-                // calculate the start and end angles
-                vertex_2d_t center;
-                center.x = cx0[0]; //(cx0[0] + cx1[0])*0.5f;
-                center.y = cx0[1]; //(cx0[1] + cx1[1])*0.5f;
-                vertex_2d_t norm[2];
-                norm[0].x           = center.x - coords.x;
-                norm[0].y           = center.y - coords.y;
-                VGfloat inverse_len = 1.0f / sqrtf((norm[0].x * norm[0].x) +
-                                                   (norm[0].y * norm[0].y));
-                norm[0].x *= inverse_len;
-                norm[0].y *= inverse_len;
-
-                norm[1].x   = center.x - cp1x;
-                norm[1].y   = center.y - cp1y;
-                inverse_len = 1.0f / sqrtf((norm[1].x * norm[1].x) +
-                                           (norm[1].y * norm[1].y));
-                norm[1].x *= inverse_len;
-                norm[1].y *= inverse_len;
-                VGfloat startAngle = degrees(acosf(-norm[0].x));
-                VGfloat endAngle   = degrees(acosf(-norm[1].x));
-                VGfloat cross      = norm[0].x;
-                if (cross >= 0) {
-                    startAngle = 360 - startAngle;
-                    endAngle   = 360 - endAngle;
-                }
-                if (startAngle > endAngle) {
-                    VGfloat tmp = startAngle;
-                    startAngle  = endAngle;
-                    endAngle    = tmp;
-                    startAngle  = startAngle - 90;
-                    endAngle    = endAngle - 90;
-                }
+        // emit the triangle and retire it from its vertices
+        const uint32_t *tri = &indices[best * 3];
+        _tri_emitted[best]  = 1;
+        int32_t next_count  = 0;
+        for (uint32_t k = 0; k < 3; k++) {
+            const uint32_t v = tri[k];
+            _reordered.push_back(v);
+            uint32_t *adj = &_adj_tris[_adj_offsets[v]];
+            uint32_t  j   = 0;
+            while (adj[j] != (uint32_t)best) {
+                j++;
+            }
+            adj[j] = adj[--_live_tris[v]];
+            next_cache[next_count++] = v;
+        }
 
-                prev = coords;
-                for (VGfloat g = startAngle; g < endAngle + (360 / steps);
-                     g += 360 / steps) {
-                    vertex_2d_t c;
-
-                    VGfloat alpha    = g * (M_PI / 180.0f);
-                    VGfloat sinalpha = sinf(alpha);
-                    VGfloat cosalpha = cosf(alpha);
-                    c.x              = cx0[0] +
-                          (rh * cosalpha * cosbeta - rv * sinalpha * sinbeta);
-                    c.y = cx0[1] +
-                          (rh * cosalpha * sinbeta + rv * sinalpha * cosbeta);
-                    // printf( "(%f, %f)\n", c[0], c[1] );
-                    buildFatLineSegment(vertices, prev, c, stroke_width);
-                    prev = c;
-                }
+        // the triangle's vertices move to the front of the cache
+        for (int32_t i = 0; i < cache_count; i++) {
+            const uint32_t v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                next_cache[next_count++] = v;
             }
+        }
 
-            coords.x = cp1x;
-            coords.y = cp1y;
+        // rescore everything that moved in or out of the cache
+        for (int32_t i = 0; i < next_count; i++) {
+            const uint32_t v   = next_cache[i];
+            _cache_pos[v]      = i < kCacheSize ? i : -1;
+            const float score  = vertexScore(_cache_pos[v], _live_tris[v]);
+            const float delta  = score - _vertex_scores[v];
+            if (delta == 0) {
+                continue;
+            }
+            _vertex_scores[v]  = score;
+            const uint32_t *adj = &_adj_tris[_adj_offsets[v]];
+            for (uint32_t j = 0; j < _live_tris[v]; j++) {
+                _tri_scores[adj[j]] += delta;
+            }
+        }
+        // bounded for the compiler too, next_count is at most kCacheSize + 3
+        cache_count = std::min(next_count, kCacheSize);
+        std::copy_n(next_cache.begin(),
+                    std::min<size_t>(cache_count, kCacheSize), cache.begin());
 
-        } break;
+        // the best next triangle uses a cached vertex. only a few triangles
+        // of a fan center are looked at to keep this linear.
+        best       = -1;
+        best_score = -1.0f;
+        for (int32_t i = 0; i < cache_count; i++) {
+            const uint32_t  v   = cache[i];
+            const uint32_t *adj = &_adj_tris[_adj_offsets[v]];
+            const uint32_t  n   = std::min(_live_tris[v], kMaxValence);
+            for (uint32_t j = 0; j < n; j++) {
+                if (_tri_scores[adj[j]] > best_score) {
+                    best_score = _tri_scores[adj[j]];
+                    best       = (int32_t)adj[j];
+                }
+            }
+        }
+    }
 
-        default:
-            throw std::runtime_error("Unknown segment type");
-            break;
+    // renumber the vertices in the order they are first used
+    const uint32_t kUnused = ~0u;
+    _remap.assign(vertex_count, kUnused);
+    _remapped.resize(mesh.vertices.size());
+    uint32_t next_vertex = 0;
+    for (uint32_t &i : _reordered) {
+        if (_remap[i] == kUnused) {
+            _remapped[next_vertex * 2]     = mesh.vertices[i * 2];
+            _remapped[next_vertex * 2 + 1] = mesh.vertices[i * 2 + 1];
+            _remap[i]                      = next_vertex++;
         }
-    } // foreach segment
+        i = _remap[i];
+    }
+    _remapped.resize(next_vertex * 2);
+    std::swap(mesh.indices, _reordered);
+    std::swap(mesh.vertices, _remapped);
 }
 
 } // namespace MonkVG
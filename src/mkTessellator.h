@@ -12,17 +12,212 @@
 #define __MK_TESSELATOR_H__
 #include <MonkVG/openvg.h>
 #include "mkTypes.h"
+#include "mkPathCoords.h"
+#include <array>
+#include <atomic>
 #include <vector>
 #include <cstdint>
 namespace MonkVG {
 class IPath;
 class IContext;
+
+/**
+ * @brief A single contour of a flattened path. Indexes into
+ * flattened_path_t::points. A contour of one point had segments of no
+ * length; it is stroked as a dot and encloses nothing to fill.
+ */
+struct contour_t {
+    uint32_t first        = 0;
+    uint32_t count        = 0;
+    bool     closed       = false;
+    bool     has_segments = false; // more than its move, maybe of no length
+};
+
+/**
+ * @brief A path with all curves and arcs flattened into line segments.
+ */
+struct flattened_path_t {
+    std::vector<vertex_2d_t> points   = {};
+    std::vector<contour_t>   contours = {};
+
+    void clear() {
+        points.clear();
+        contours.clear();
+    }
+};
+
+/**
+ * @brief Where one contour of a fill tessellated contour by contour lives
+ * in the path data and in the mesh. See: ITessellator::tessellateContours
+ */
+struct fill_contour_t {
+    size_t         first_segment = 0;
+    size_t         num_segments  = 0;
+    size_t         first_coord   = 0;
+    uint32_t       first_vertex  = 0;
+    uint32_t       num_vertices  = 0;
+    uint32_t       first_index   = 0;
+    uint32_t       num_indices   = 0;
+    bounding_box_t bounds        = {}; // of its triangles
+};
+
+/**
+ * @brief An indexed triangle list. Every x,y pair in vertices is unique and
+ * indices reference them three per triangle.
+ */
+struct indexed_mesh_t {
+    std::vector<VGfloat>  vertices = {}; // x,y pairs
+    std::vector<uint32_t> indices  = {};
+
+    // the indices are pairs of a line list instead of triangles. See:
+    // stroke_style_t::hairline
+    bool lines = false;
+
+    void clear() {
+        vertices.clear();
+        indices.clear();
+        lines = false;
+    }
+    uint32_t vertexCount() const { return (uint32_t)(vertices.size() / 2); }
+
+    /// @brief true if the indices can be uploaded as 16 bit
+    bool fitsIndex16() const { return vertexCount() <= 0xffff; }
+
+    /// @brief copy the indices narrowed to 16 bit. See: fitsIndex16()
+    void packIndices16(std::vector<uint16_t> &out) const {
+        out.assign(indices.begin(), indices.end());
+    }
+};
+
+/**
+ * @brief How a path is stroked. See: ITessellator::buildStroke
+ */
+struct stroke_style_t {
+    /// @brief dash pattern values kept. VG_MAX_DASH_COUNT
+    static constexpr size_t max_dash_count = 16;
+
+    VGfloat     width       = 1;             // VG_STROKE_LINE_WIDTH
+    VGCapStyle  cap         = VG_CAP_BUTT;   // VG_STROKE_CAP_STYLE
+    VGJoinStyle join        = VG_JOIN_MITER; // VG_STROKE_JOIN_STYLE
+    VGfloat     miter_limit = 4;             // VG_STROKE_MITER_LIMIT
+
+    // alternating on and off lengths starting with on. no pattern strokes
+    // solid lines.
+    std::vector<VGfloat> dash_pattern     = {}; // VG_STROKE_DASH_PATTERN
+    VGfloat              dash_phase       = 0;  // VG_STROKE_DASH_PHASE
+    bool                 dash_phase_reset = false; // VG_STROKE_DASH_PHASE_RESET
+
+    // one pixel wide lines through the flattened points, without width,
+    // joins or caps. See: VG_STROKE_HAIRLINE_WIDTH_MNK
+    bool hairline = false;
+
+    bool operator==(const stroke_style_t &o) const {
+        return width == o.width && cap == o.cap && join == o.join &&
+               miter_limit == o.miter_limit &&
+               dash_pattern == o.dash_pattern && dash_phase == o.dash_phase &&
+               dash_phase_reset == o.dash_phase_reset &&
+               hairline == o.hairline;
+    }
+    bool operator!=(const stroke_style_t &o) const { return !(*this == o); }
+};
+
+/**
+ * @brief A line segment of a flattened path with its neighbours, for
+ * strokes expanded on the GPU. A neighbour equal to its end point is a
+ * contour end that gets a cap. See: ITessellator::buildStrokeSegments
+ */
+struct stroke_segment_t {
+    vertex_2d_t prev; // start of the segment before
+    vertex_2d_t p0;
+    vertex_2d_t p1;
+    vertex_2d_t next; // end of the segment after
+};
+
+/**
+ * @brief Every vertex of a stroke mesh is a point of the flattened path
+ * plus an offset times the half width. Kept with a stroke whose width
+ * changes so a new width moves the vertices instead of stroking the path
+ * again, up to the width its joins and round pieces suit. See:
+ * ITessellator::rescaleStroke
+ */
+struct stroke_offsets_t {
+    std::vector<VGfloat> centers = {}; // x,y pairs, one per mesh vertex
+    std::vector<VGfloat> offsets = {}; // x,y pairs over the half width
+
+    // widest half width the joins sharing their vertices suit
+    VGfloat max_half_width = VG_MAX_FLOAT;
+
+    // ITessellator::arcSteps() of the round joins and caps. 0 if none.
+    uint32_t arc_steps = 0;
+
+    void clear() {
+        centers.clear();
+        offsets.clear();
+        max_half_width = VG_MAX_FLOAT;
+        arc_steps      = 0;
+    }
+};
+
+/**
+ * @brief A path made of a single VGU primitive. Its fill is generated from
+ * the shape instead of rediscovered by flattening and tessellating the arcs
+ * and lines the primitive was lowered into. See: ITessellator::tessellateShape
+ */
+struct shape_descriptor_t {
+    enum class Type { None, Rect, RoundRect, Ellipse, Arc };
+
+    Type    type   = Type::None;
+    VGfloat x      = 0; // lower left corner of rects, center otherwise
+    VGfloat y      = 0;
+    VGfloat width  = 0;
+    VGfloat height = 0;
+
+    VGfloat arc_width  = 0; // round rect corner ellipse
+    VGfloat arc_height = 0;
+
+    VGfloat start_angle  = 0; // arc, radians
+    VGfloat angle_extent = 0; // arc, radians. at most a full turn
+    bool    pie          = false; // arc closed through the center
+
+    bool isShape() const { return type != Type::None; }
+
+    /// a round rect with rounded corners or an ellipse. See:
+    /// ITessellator::measureShape
+    bool isRound() const {
+        return type == Type::Ellipse ||
+               (type == Type::RoundRect && arc_width > 0 && arc_height > 0);
+    }
+
+    /// the rect of a round shape, lower left corner and size, and the radii
+    /// of its corner ellipse
+    void roundRect(VGfloat rect[4], VGfloat radius[2]) const {
+        const bool round = type == Type::RoundRect;
+        radius[0]        = (round ? arc_width : width) / 2;
+        radius[1]        = (round ? arc_height : height) / 2;
+        rect[0]          = round ? x : x - radius[0];
+        rect[1]          = round ? y : y - radius[1];
+        rect[2]          = width;
+        rect[3]          = height;
+    }
+};
+
 class ITessellator {
   public:
     virtual ~ITessellator() = default;
 
     /**
-     * @brief Tesselate the path
+     * @brief How tessellateIndexed() triangulated a fill.
+     */
+    enum class FillRoute {
+        Convex,  // single convex contour. triangle fan.
+        Simple,  // single simple contour. ear clipping.
+        General, // everything else. the full tessellator.
+        Shape,   // analytic VGU primitive. See: tessellateShape()
+        Count
+    };
+
+    /**
+     * @brief Tesselate the path. Flattens it and tessellates the contours.
      * @param segments The segments of the path
      * @param coords The coordinates of the path
      * @param fill_rule The fill rule to use. Either VG_EVEN_ODD or VG_NON_ZERO.
@@ -32,11 +227,24 @@ class ITessellator {
      * @param bounding_box The bounding box of the tessellated path
      */
     virtual void tessellate(const std::vector<VGubyte> &segments,
-                            const std::vector<VGfloat> &coords,
+                            const path_coords_t        &coords,
                             const VGFillRule           fill_rule,
                             const uint32_t              tess_iterations,
                             std::vector<VGfloat>       &vertices,
-                            bounding_box_t             &bounding_box) = 0;
+                            bounding_box_t             &bounding_box);
+
+    /**
+     * @brief Tesselate the contours of an already flattened path. Every
+     * contour is implicitly closed. See: flatten()
+     * @param path The flattened path
+     * @param fill_rule The fill rule to use. Either VG_EVEN_ODD or VG_NON_ZERO.
+     * @param vertices The resulting vertices of the tessellated path
+     * @param bounding_box The bounding box of the tessellated path
+     */
+    virtual void tessellate(const flattened_path_t &path,
+                            const VGFillRule        fill_rule,
+                            std::vector<VGfloat>   &vertices,
+                            bounding_box_t         &bounding_box) = 0;
 
     /**
      * @brief Tesselate the path
@@ -52,26 +260,381 @@ class ITessellator {
                             bounding_box_t       &bounding_box) = 0;
 
     /**
-     * @brief Given a path (segments and coords) build the stroke vertices.
+     * @brief Tesselate the path into an indexed triangle list. Shared
+     * vertices are stored once and the triangles of large meshes are
+     * ordered for the post transform vertex cache. See:
+     * optimizeVertexCache() Paths with a single convex or small simple
+     * contour are triangulated directly, everything else goes through
+     * tessellate(). See: FillRoute
+     *
+     * @param segments The segments of the path
+     * @param coords The coordinates of the path
+     * @param fill_rule The fill rule to use. Either VG_EVEN_ODD or VG_NON_ZERO.
+     * @param tess_iterations The number of iterations to tesselate.
+     * @param mesh The resulting mesh. Cleared before use.
+     * @param bounding_box The bounding box of the tessellated path
+     */
+    void tessellateIndexed(const std::vector<VGubyte> &segments,
+                           const path_coords_t        &coords,
+                           const VGFillRule            fill_rule,
+                           const uint32_t              tess_iterations,
+                           indexed_mesh_t             &mesh,
+                           bounding_box_t             &bounding_box);
+
+    /**
+     * @brief Tesselate an already flattened path into an indexed triangle
+     * list. See: tessellateIndexed() and flatten()
+     */
+    void tessellateIndexed(const flattened_path_t &path,
+                           const VGFillRule        fill_rule,
+                           indexed_mesh_t         &mesh,
+                           bounding_box_t         &bounding_box);
+
+    /**
+     * @brief Tesselate every contour of the path on its own into one
+     * indexed triangle list and record where each went, so one contour can
+     * be tessellated again without the others. Only done if every contour
+     * starts with an absolute move and no two contours overlap, as they
+     * would then affect each other through the fill rule.
+     *
+     * @param segments The segments of the path
+     * @param coords The coordinates of the path
+     * @param fill_rule The fill rule to use. Either VG_EVEN_ODD or VG_NON_ZERO.
+     * @param tess_iterations The number of iterations to tesselate.
+     * @param mesh The resulting mesh. Cleared before use.
+     * @param bounding_box The bounding box of the tessellated path
+     * @param contours The contours in path order. Cleared before use.
+     * @return false, leaving the outputs untouched, if the contours can not
+     * be tessellated on their own
+     */
+    bool tessellateContours(const std::vector<VGubyte>  &segments,
+                            const path_coords_t         &coords,
+                            const VGFillRule             fill_rule,
+                            const uint32_t               tess_iterations,
+                            indexed_mesh_t              &mesh,
+                            bounding_box_t              &bounding_box,
+                            std::vector<fill_contour_t> &contours);
+
+    /**
+     * @brief tessellateIndexed() of the num_segments segments at segments,
+     * whose coordinates start at first_coord in coords
+     */
+    void tessellateContour(const VGubyte *segments, size_t num_segments,
+                           const path_coords_t &coords, size_t first_coord,
+                           const VGFillRule fill_rule,
+                           const uint32_t tess_iterations, indexed_mesh_t &mesh,
+                           bounding_box_t &bounding_box);
+
+    /**
+     * @brief Generate the fill of a VGU primitive directly: a rect is two
+     * triangles and ellipses and rounded corners get as many segments as
+     * their radius needs at the current tolerance. The result is within
+     * the tolerance of the path the primitive was lowered into.
+     *
+     * @param shape the primitive
+     * @param tess_iterations The number of line segments of a full ellipse
+     * when no tolerance is set.
+     * @param mesh The resulting mesh. Cleared before use.
+     * @param bounding_box The bounding box of the shape
+     */
+    void tessellateShape(const shape_descriptor_t &shape,
+                         const uint32_t tess_iterations, indexed_mesh_t &mesh,
+                         bounding_box_t &bounding_box);
+
+    /**
+     * @brief The segments per corner and the bounding box of a round shape,
+     * for backends that draw it from a mesh of four rounded corners shared
+     * by every round rect and ellipse with the same segments. An ellipse is
+     * a round rect as large as its corners. Nothing is generated, but the
+     * fill counts as a FillRoute::Shape.
+     *
+     * @param shape a round rect or ellipse. See: shape_descriptor_t::isRound
+     * @param tess_iterations See: tessellateShape()
+     * @param bounding_box The bounding box of the shape
+     * @return The segments of each quarter of the corner ellipse
+     */
+    uint32_t measureShape(const shape_descriptor_t &shape,
+                          const uint32_t            tess_iterations,
+                          bounding_box_t           &bounding_box);
+
+    /**
+     * @brief Build an indexed mesh from a triangle soup by merging vertices
+     * with identical coordinates. Degenerate triangles are dropped.
+     *
+     * @param soup x,y pairs, three vertices per triangle
+     * @param mesh The resulting mesh. Cleared before use.
+     */
+    void weldVertices(const std::vector<VGfloat> &soup, indexed_mesh_t &mesh);
+
+    /**
+     * @brief Reorder the triangles for post transform vertex cache locality
+     * using Tom Forsyth's "Linear-Speed Vertex Cache Optimisation", then
+     * renumber the vertices in first use order for fetch locality. Meshes
+     * of fewer than kMinCacheOptimizeTris triangles are left as they are.
+     */
+    void optimizeVertexCache(indexed_mesh_t &mesh);
+
+    /**
+     * @brief Set the maximum distance in path user space between a curve and
+     * the line segments it is flattened into. Curves and arcs then get as
+     * many segments as their size needs. 0 flattens every curve into
+     * tess_iterations uniform steps.
+     */
+    void    setTolerance(const VGfloat tolerance) { _tolerance = tolerance; }
+    VGfloat getTolerance() const { return _tolerance; }
+
+    /**
+     * @brief Number of heap allocations the tessellator made for its
+     * internal storage since it was created. Re-tessellating a path of
+     * similar size should not increase it. Tessellators that do not track
+     * their allocations return 0.
+     */
+    virtual uint64_t getHeapAllocations() const { return 0; }
+
+    /**
+     * @brief Number of fills tessellateIndexed() triangulated through the
+     * given route since the tessellator was created. May be read from any
+     * thread.
+     */
+    uint64_t getFillRouteCount(const FillRoute route) const {
+        return _fill_routes[(size_t)route].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Given a path (segments and coords) build the stroke. Flattens
+     * the path and strokes the contours.
      *
      * @param segments The segments of the path
-     * @param fcoords The coordinates of the path
-     * @param stroke_width The width of the stroke
+     * @param coords The coordinates of the path
+     * @param style The width, caps, joins and miter limit of the stroke
      * @param tess_iterations The number of iterations to tesselate. The
      * higher the number the more vertices will be generated.
-     * @param vertices The resulting vertices of the tessellated path.
+     * @param mesh The resulting triangles. Cleared before use.
      */
     void buildStroke(const std::vector<VGubyte> &segments,
-                     const std::vector<VGfloat> &fcoords,
-                     const float stroke_width, const uint32_t tess_iterations,
-                     std::vector<vertex_2d_t> &vertices);
-    void buildFatLineSegment(std::vector<vertex_2d_t> &vertices,
-                             const vertex_2d_t &p0, const vertex_2d_t &p1,
-                             const float stroke_width);
+                     const path_coords_t        &coords,
+                     const stroke_style_t       &style,
+                     const uint32_t tess_iterations, indexed_mesh_t &mesh);
+
+    /**
+     * @brief Stroke an already flattened path into an indexed triangle
+     * list. Open contours get caps and every vertex where a contour turns
+     * gets a join. Consecutive segments share their vertices where they
+     * meet at a join that needs no triangles of its own, which is most
+     * vertices of a flattened curve. With a dash pattern each dash is
+     * stroked as an open contour as the contours are walked, in time
+     * linear in their segments and dashes. See: flatten()
+     *
+     * @param path The flattened path
+     * @param style The width, caps, joins and miter limit of the stroke
+     * @param tess_iterations The number of line segments a full round join
+     * or cap is broken into when no tolerance is set. See: setTolerance()
+     * @param mesh The resulting triangles, or lines for a hairline style.
+     * Cleared before use.
+     * @param offsets If not null, where each vertex of mesh comes from so
+     * rescaleStroke() can change its width. Cleared before use.
+     */
+    void buildStroke(const flattened_path_t &path,
+                     const stroke_style_t   &style,
+                     const uint32_t tess_iterations, indexed_mesh_t &mesh,
+                     stroke_offsets_t *offsets = nullptr);
+
+    /**
+     * @brief Move the vertices of a stroke built by buildStroke() to the
+     * width of style. The triangles stay as they are. Fails if a join
+     * sharing its vertices would reach past its segments at the width, or
+     * the round joins and caps would be coarser than the tolerance. The
+     * tolerance the stroke was built with has to be set.
+     *
+     * @param offsets Where the vertices of mesh come from
+     * @param style The stroke style the stroke was built with but the width
+     * @param tess_iterations The tessellation iterations it was built with
+     * @param mesh The stroke. Only its vertices are written.
+     * @return true if the stroke was rescaled
+     */
+    bool rescaleStroke(const stroke_offsets_t &offsets,
+                       const stroke_style_t &style, uint32_t tess_iterations,
+                       indexed_mesh_t &mesh) const;
+
+    /**
+     * @brief The line segments of an already flattened path for a stroke
+     * expanded on the GPU. Does not depend on the stroke style. A contour
+     * of a single point is one segment of zero length that only gets caps.
+     * See: buildStroke()
+     *
+     * @param path The flattened path
+     * @param segments The resulting segments. Cleared before use.
+     */
+    void buildStrokeSegments(const flattened_path_t        &path,
+                             std::vector<stroke_segment_t> &segments);
+
+    /**
+     * @brief Flatten the path (segments and coords) into contours of line
+     * segments.
+     *
+     * @param segments The segments of the path
+     * @param coords The coordinates of the path. Scale and bias are
+     * applied as they are read.
+     * @param tess_iterations The number of line segments a curve or a full
+     * ellipse is broken into when no tolerance is set. See: setTolerance()
+     * @param path The resulting flattened path. Cleared before use.
+     */
+    void flatten(const std::vector<VGubyte> &segments,
+                 const path_coords_t &coords, const uint32_t tess_iterations,
+                 flattened_path_t &path);
+
+    /**
+     * @brief flatten() the num_segments segments at segments, whose
+     * coordinates start at first_coord in coords
+     */
+    void flatten(const VGubyte *segments, size_t num_segments,
+                 const path_coords_t &coords, size_t first_coord,
+                 const uint32_t tess_iterations, flattened_path_t &path);
 
   protected:
     ITessellator() = default; //: _context(context) {};
 
+    /// @brief number of line segments to flatten a quadratic bezier into.
+    /// See: setTolerance()
+    uint32_t quadSteps(const vertex_2d_t &p0, const vertex_2d_t &p1,
+                       const vertex_2d_t &p2,
+                       const uint32_t     tess_iterations) const;
+
+    /// @brief number of line segments to flatten a cubic bezier into.
+    /// See: setTolerance()
+    uint32_t cubicSteps(const vertex_2d_t &p0, const vertex_2d_t &p1,
+                        const vertex_2d_t &p2, const vertex_2d_t &p3,
+                        const uint32_t tess_iterations) const;
+
+    /// @brief number of line segments to flatten a full ellipse with the
+    /// given major radius into. See: setTolerance()
+    uint32_t arcSteps(const VGfloat  radius,
+                      const uint32_t tess_iterations) const;
+
+    /// @brief simple polygons with more vertices skip ear clipping and go to
+    /// tessellate(). See: tessellateIndexed()
+    virtual size_t maxEarClipVertices() const;
+
+  private:
+    /// @brief flatten() for one coordinate encoding. See: path_coords_t::visit
+    template <typename Cursor>
+    void flattenCoords(const VGubyte *segments, size_t num_segments,
+                       Cursor coords_it, const uint32_t tess_iterations,
+                       flattened_path_t &path);
+
+    /// @brief copy the only contour of path that encloses an area into
+    /// _polygon without a repeated closing point. Returns false if there is
+    /// not exactly one.
+    bool singleContour(const flattened_path_t &path);
+
+    /// @brief true if _polygon turns the same way at every vertex and goes
+    /// around once
+    bool isConvexPolygon() const;
+
+    /// @brief true if no two edges of _polygon touch except neighbors at
+    /// their shared vertex
+    bool isSimplePolygon() const;
+
+    /// @brief triangulate a convex _polygon as a fan
+    void triangulateFan(indexed_mesh_t &mesh, bounding_box_t &bounding_box);
+
+    /// @brief triangulate a simple _polygon by ear clipping. Returns false
+    /// if it got stuck on numerically degenerate input.
+    bool triangulateEars(indexed_mesh_t &mesh, bounding_box_t &bounding_box);
+
+    /// @brief the points of contour without repeats into _stroke_points.
+    /// Closed contours drop the point closing them.
+    void strokePoints(const flattened_path_t &path, const contour_t &contour);
+
+    /// @brief where the dash pattern is: the element index, on if even, and
+    /// the length left of it
+    struct dash_state_t {
+        uint32_t index = 0;
+        VGfloat  left  = 0;
+    };
+
+    /// @brief normalize the style's dash pattern into _dash_lengths. Returns
+    /// false if it does not dash.
+    bool prepareDashes(const stroke_style_t &style);
+
+    /// @brief the dash state at the style's phase. See: prepareDashes()
+    dash_state_t dashStart(const stroke_style_t &style) const;
+
+    /// @brief walk the contour in _stroke_points with a running arc length
+    /// and stroke each dash as an open contour as soon as it ends. A closed
+    /// contour starting and ending in a dash strokes them as one.
+    void dashContour(bool closed, dash_state_t &state,
+                     const stroke_style_t &style, uint32_t tess_iterations,
+                     indexed_mesh_t &mesh);
+
+    /// @brief stroke n points without repeats. See: buildStroke()
+    void strokeContour(const vertex_2d_t *points, uint32_t n, bool closed,
+                       const stroke_style_t &style, uint32_t tess_iterations,
+                       indexed_mesh_t &mesh);
+
+    /// @brief add n points without repeats as a line list, one index pair
+    /// per segment. See: stroke_style_t::hairline
+    static void addHairlines(const vertex_2d_t *points, uint32_t n,
+                             bool closed, indexed_mesh_t &mesh);
+
+    /// @brief the join between two segments of a contour meeting at p, with
+    /// unit directions d0 and d1 and lengths len0 and len1. Returns the
+    /// index of the left and right vertices ending the first segment in
+    /// end and starting the second in start.
+    void strokeJoin(const vertex_2d_t &p, const vertex_2d_t &d0,
+                    VGfloat len0, const vertex_2d_t &d1, VGfloat len1,
+                    const stroke_style_t &style, uint32_t tess_iterations,
+                    indexed_mesh_t &mesh, uint32_t end[2], uint32_t start[2]);
+
+    /// @brief the cap of an open contour ending at p, leaving along the
+    /// unit direction d. Returns the index of its left and right vertices,
+    /// seen looking along d, in side.
+    void strokeCap(const vertex_2d_t &p, const vertex_2d_t &d,
+                   const stroke_style_t &style, uint32_t tess_iterations,
+                   indexed_mesh_t &mesh, uint32_t side[2]);
+
+    VGfloat _tolerance = 0; // user space flattening tolerance
+
+    // paths flattened by the segment based entry points
+    flattened_path_t _flattened = {};
+
+    // a contour tessellated on its own and the contours in the order of
+    // their bounds. See: tessellateContours()
+    indexed_mesh_t        _contour_mesh  = {};
+    std::vector<uint32_t> _contour_order = {};
+
+    // fast path scratch. See: tessellateIndexed()
+    std::vector<vertex_2d_t> _polygon  = {};
+    std::vector<uint32_t>    _ear_prev = {};
+    std::vector<uint32_t>    _ear_next = {};
+
+    // stroke scratch. a contour without repeated points, the dash being
+    // walked, the dash pattern and the offsets being recorded, if any. See:
+    // buildStroke()
+    std::vector<vertex_2d_t> _stroke_points  = {};
+    std::vector<vertex_2d_t> _dash_points    = {};
+    std::vector<VGfloat>     _dash_lengths   = {};
+    VGfloat                  _dash_total     = 0;
+    stroke_offsets_t        *_stroke_offsets = nullptr;
+
+    std::array<std::atomic<uint64_t>, (size_t)FillRoute::Count> _fill_routes =
+        {};
+
+    // scratch storage for the indexed output. kept around so re-tessellating
+    // does not allocate.
+    std::vector<VGfloat>  _soup          = {};
+    std::vector<uint32_t> _weld_table    = {}; // open addressing hash
+    std::vector<uint32_t> _adj_offsets   = {}; // per vertex into _adj_tris
+    std::vector<uint32_t> _adj_tris      = {}; // triangles using a vertex
+    std::vector<uint32_t> _live_tris     = {}; // not yet emitted per vertex
+    std::vector<int32_t>  _cache_pos     = {}; // per vertex, -1 if not cached
+    std::vector<float>    _vertex_scores = {};
+    std::vector<float>    _tri_scores    = {};
+    std::vector<uint8_t>  _tri_emitted   = {};
+    std::vector<uint32_t> _reordered     = {};
+    std::vector<uint32_t> _remap         = {};
+    std::vector<VGfloat>  _remapped      = {};
+
     // IContext &_context;
     // IContext &getContext() { return _context; }
 
@@ -0,0 +1,116 @@
+/**
+ * @file mkThreadPool.cpp
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Fixed size thread pool implementation
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "mkThreadPool.h"
+
+namespace MonkVG {
+
+ThreadPool::ThreadPool(uint32_t num_threads) {
+    if (num_threads == 0) {
+        num_threads = std::thread::hardware_concurrency();
+    }
+    for (uint32_t i = 1; i < num_threads; i++) {
+        _workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _wake.notify_all();
+    for (std::thread &worker : _workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(const size_t count, const task_t &task) {
+    if (count == 0) {
+        return;
+    }
+    if (_workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; i++) {
+            task(i, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _task  = &task;
+        _count = count;
+        _next  = 0;
+        _error = nullptr;
+        _busy  = (uint32_t)_workers.size();
+        _generation++;
+    }
+    _wake.notify_all();
+
+    runTasks(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this] { return _busy == 0; });
+        _task = nullptr;
+        error = _error;
+        _error = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::workerLoop(const uint32_t thread) {
+    uint64_t generation = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [&] {
+                return _quit || _generation != generation;
+            });
+            if (_quit) {
+                return;
+            }
+            generation = _generation;
+        }
+
+        runTasks(thread);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_busy == 0) {
+                _done.notify_one();
+            }
+        }
+    }
+}
+
+void ThreadPool::runTasks(const uint32_t thread) {
+    for (;;) {
+        const size_t i = _next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= _count) {
+            return;
+        }
+        try {
+            (*_task)(i, thread);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_error) {
+                _error = std::current_exception();
+            }
+            // skip whatever is left
+            _next = _count;
+        }
+    }
+}
+
+} // namespace MonkVG
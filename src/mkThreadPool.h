@@ -0,0 +1,75 @@
+/**
+ * @file mkThreadPool.h
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Fixed size thread pool for data parallel work
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __mkThreadPool_h__
+#define __mkThreadPool_h__
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MonkVG {
+
+/**
+ * @brief A fixed set of worker threads that run parallel for loops. The
+ * threads take the next index from a shared counter so a slow item never
+ * holds up the rest of the loop.
+ */
+class ThreadPool {
+  public:
+    /// @brief function run for every index of a parallel for. thread is in
+    /// [0, getThreadCount()) and is 0 for the calling thread.
+    using task_t = std::function<void(size_t index, uint32_t thread)>;
+
+    /// @param num_threads total thread count including the calling thread.
+    /// 0 uses one thread per hardware core.
+    explicit ThreadPool(uint32_t num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &)            = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// @brief the number of threads a parallel for runs on
+    uint32_t getThreadCount() const { return (uint32_t)_workers.size() + 1; }
+
+    /**
+     * @brief Run task for every index in [0, count) and wait for all of
+     * them. The calling thread takes part. If a task throws, the remaining
+     * indices are skipped and the first exception is rethrown here. Must not
+     * be called from inside a task.
+     */
+    void parallelFor(size_t count, const task_t &task);
+
+  private:
+    void workerLoop(uint32_t thread);
+    void runTasks(uint32_t thread);
+
+    std::vector<std::thread> _workers = {};
+    std::mutex               _mutex;
+    std::condition_variable  _wake; // workers wait for a new loop
+    std::condition_variable  _done; // the caller waits for the workers
+    uint64_t                 _generation = 0; // bumped for every loop
+    uint32_t                 _busy       = 0; // workers still in the loop
+    bool                     _quit       = false;
+
+    // the current loop
+    const task_t       *_task  = nullptr;
+    size_t              _count = 0;
+    std::atomic<size_t> _next  = 0;
+    std::exception_ptr  _error = nullptr;
+};
+
+} // namespace MonkVG
+#endif // __mkThreadPool_h__
@@ -65,10 +65,24 @@ struct bounding_box_t {
      * @param y
      */
     void update(float x, float y) {
-        min_x  = std::min(min_x, x);
-        min_y  = std::min(min_y, y);
-        width  = std::max(width, x - min_x);
-        height = std::max(height, y - min_y);
+        // the far edges stay put when the box grows towards the min. an
+        // empty box has a negative size.
+        const float max_x = width < 0 ? x : std::max(min_x + width, x);
+        const float max_y = height < 0 ? y : std::max(min_y + height, y);
+        min_x             = std::min(min_x, x);
+        min_y             = std::min(min_y, y);
+        width             = max_x - min_x;
+        height            = max_y - min_y;
+    }
+
+    /**
+     * @brief true if the boxes overlap or touch. Empty boxes overlap
+     * nothing.
+     */
+    bool overlaps(const bounding_box_t &o) const {
+        return width >= 0 && height >= 0 && o.width >= 0 && o.height >= 0 &&
+               min_x <= o.min_x + o.width && o.min_x <= min_x + width &&
+               min_y <= o.min_y + o.height && o.min_y <= min_y + height;
     }
 };
 
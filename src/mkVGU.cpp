@@ -43,6 +43,7 @@
 #include "MonkVG/openvg.h"
 #include "mkCommon.h"
 #include "mkMath.h"
+#include "mkPath.h"
 
 
 /// @brief append a path segment to a path
@@ -102,6 +103,19 @@ static void append(VGPath path, int numSegments, const VGubyte* segments, int nu
 	}
 }
 
+/// @brief record the VGU primitive just appended to path so its fill can be
+/// generated from the shape. See: MonkVG::IPath::setShape
+/// @param path the path appended to
+/// @param numSegments number of segments the primitive was appended as
+/// @param shape the primitive in user space
+static void setShape(VGPath path, int numSegments, const MonkVG::shape_descriptor_t& shape)
+{
+	//the shape is in user space. integer path data was rounded to the path scale.
+	if(vgGetParameteri(path, VG_PATH_DATATYPE) != VG_PATH_DATATYPE_F)
+		return;
+	((MonkVG::IPath*)path)->setShape(shape, numSegments);
+}
+
 /*-------------------------------------------------------------------*//*!
  * \brief	
  * \param	
@@ -183,6 +197,16 @@ VGUErrorCode vguRect(VGPath path, VGfloat x, VGfloat y, VGfloat width, VGfloat h
 	append(path, 5, segments, 5, data);
 	
 	error = vgGetError();
+	if(error == VG_NO_ERROR)
+	{
+		MonkVG::shape_descriptor_t shape;
+		shape.type = MonkVG::shape_descriptor_t::Type::Rect;
+		shape.x = x;
+		shape.y = y;
+		shape.width = width;
+		shape.height = height;
+		setShape(path, 5, shape);
+	}
 	if(error == VG_BAD_HANDLE_ERROR)
 		return VGU_BAD_HANDLE_ERROR;
 	else if(error == VG_PATH_CAPABILITY_ERROR)
@@ -208,6 +232,16 @@ VGUErrorCode vguEllipse(VGPath path, VGfloat cx, VGfloat cy, VGfloat width, VGfl
 	append(path, 4, segments, 12, data);
 	
 	error = vgGetError();
+	if(error == VG_NO_ERROR)
+	{
+		MonkVG::shape_descriptor_t shape;
+		shape.type = MonkVG::shape_descriptor_t::Type::Ellipse;
+		shape.x = cx;
+		shape.y = cy;
+		shape.width = width;
+		shape.height = height;
+		setShape(path, 4, shape);
+	}
 	if(error == VG_BAD_HANDLE_ERROR)
 		return VGU_BAD_HANDLE_ERROR;
 	else if(error == VG_PATH_CAPABILITY_ERROR)
@@ -253,6 +287,18 @@ VGUErrorCode vguRoundRect(VGPath path, VGfloat x, VGfloat y, VGfloat width, VGfl
 	append(path, 10, segments, 26, data);
 	
 	error = vgGetError();
+	if(error == VG_NO_ERROR)
+	{
+		MonkVG::shape_descriptor_t shape;
+		shape.type = MonkVG::shape_descriptor_t::Type::RoundRect;
+		shape.x = x;
+		shape.y = y;
+		shape.width = width;
+		shape.height = height;
+		shape.arc_width = arcWidth;
+		shape.arc_height = arcHeight;
+		setShape(path, 10, shape);
+	}
 	if(error == VG_BAD_HANDLE_ERROR)
 		return VGU_BAD_HANDLE_ERROR;
 	else if(error == VG_PATH_CAPABILITY_ERROR)
@@ -282,11 +328,13 @@ VGUErrorCode vguArc(VGPath path, VGfloat x, VGfloat y, VGfloat width, VGfloat he
 	
 	VGubyte segments[1];
 	VGfloat data[5];
+	int numSegments = 0;
 	
 	segments[0] = VG_MOVE_TO | VG_ABSOLUTE;
 	data[0] = x + w * (VGfloat)cos(startAngle);
 	data[1] = y + h * (VGfloat)sin(startAngle);
 	append(path, 1, segments, 2, data);
+	numSegments++;
 	
 	data[0] = w;
 	data[1] = h;
@@ -300,6 +348,7 @@ VGUErrorCode vguArc(VGPath path, VGfloat x, VGfloat y, VGfloat width, VGfloat he
 			data[3] = x + w * (VGfloat)cos(a);
 			data[4] = y + h * (VGfloat)sin(a);
 			append(path, 1, segments, 5, data);
+			numSegments++;
 		}
 	}
 	else
@@ -310,16 +359,19 @@ VGUErrorCode vguArc(VGPath path, VGfloat x, VGfloat y, VGfloat width, VGfloat he
 			data[3] = x + w * (VGfloat)cos(a);
 			data[4] = y + h * (VGfloat)sin(a);
 			append(path, 1, segments, 5, data);
+			numSegments++;
 		}
 	}
 	data[3] = x + w * (VGfloat)cos(endAngle);
 	data[4] = y + h * (VGfloat)sin(endAngle);
 	append(path, 1, segments, 5, data);
+	numSegments++;
 	
 	if(arcType == VGU_ARC_CHORD)
 	{
 		segments[0] = VG_CLOSE_PATH;
 		append(path, 1, segments, 0, data);
+		numSegments++;
 	}
 	else if(arcType == VGU_ARC_PIE)
 	{
@@ -327,11 +379,27 @@ VGUErrorCode vguArc(VGPath path, VGfloat x, VGfloat y, VGfloat width, VGfloat he
 		data[0] = x;
 		data[1] = y;
 		append(path, 1, segments, 2, data);
+		numSegments++;
 		segments[0] = VG_CLOSE_PATH;
 		append(path, 1, segments, 0, data);
+		numSegments++;
 	}
 	
 	error = vgGetError();
+	//more than a full turn overlaps itself and depends on the fill rule
+	if(error == VG_NO_ERROR && fabsf(angleExtent) <= 2.0f * (VGfloat)M_PI)
+	{
+		MonkVG::shape_descriptor_t shape;
+		shape.type = MonkVG::shape_descriptor_t::Type::Arc;
+		shape.x = x;
+		shape.y = y;
+		shape.width = width;
+		shape.height = height;
+		shape.start_angle = startAngle;
+		shape.angle_extent = angleExtent;
+		shape.pie = arcType == VGU_ARC_PIE;
+		setShape(path, numSegments, shape);
+	}
 	if(error == VG_BAD_HANDLE_ERROR)
 		return VGU_BAD_HANDLE_ERROR;
 	else if(error == VG_PATH_CAPABILITY_ERROR)
@@ -22,79 +22,39 @@ OpenGLBatch::~OpenGLBatch() {
     }
 }
 
-void OpenGLBatch::addPathVertexData(GLfloat *fill_verts, size_t fill_vert_cnt,
-                                    GLfloat   *stroke_verts,
-                                    size_t     stroke_vert_cnt,
-                                    VGbitfield paint_modes) {
+void OpenGLBatch::addPathVertexData(const indexed_mesh_t &fill,
+                                    const indexed_mesh_t &stroke,
+                                    VGbitfield            paint_modes) {
+    if (paint_modes & VG_FILL_PATH) {
+        addMesh(fill, IContext::instance().getFillPaint());
+    }
+    if (paint_modes & VG_STROKE_PATH) {
+        addMesh(stroke, IContext::instance().getStrokePaint());
+    }
+}
 
+void OpenGLBatch::addMesh(const indexed_mesh_t &mesh, IPaint *paint) {
     // get the current transform
     Matrix33 &transform = IContext::instance().getActiveMatrix();
 
-    if (paint_modes & VG_FILL_PATH) {
-        vertex_t vert;
-
-        // get the paint color
-        IPaint *paint                   = IContext::instance().getFillPaint();
-        const std::array<VGfloat, 4> fc = paint->getPaintColor();
-
-        vert.color = (uint32_t(fc[3] * 255.0f) << 24)   // a
-                     | (uint32_t(fc[2] * 255.0f) << 16) // b
-                     | (uint32_t(fc[1] * 255.0f) << 8)  // g
-                     | (uint32_t(fc[0] * 255.0f) << 0); // r
-
-        // get vertices and transform them
-        VGfloat v[2];
-        for (int i = 0; i < fill_vert_cnt * 2; i += 2) {
-            v[0] = fill_verts[i];
-            v[1] = fill_verts[i + 1];
-            affineTransform(vert.v, transform, v);
-            _vertices.push_back(vert);
-        }
-    }
+    vertex_t vert;
 
-    if (paint_modes & VG_STROKE_PATH) {
-        vertex_t vert, start_vert, last_vert;
-
-        // get the paint color
-        IPaint *paint                   = IContext::instance().getStrokePaint();
-        const std::array<VGfloat, 4> fc = paint->getPaintColor();
-
-        vert.color = (uint32_t(fc[3] * 255.0f) << 24)   // a
-                     | (uint32_t(fc[2] * 255.0f) << 16) // b
-                     | (uint32_t(fc[1] * 255.0f) << 8)  // g
-                     | (uint32_t(fc[0] * 255.0f) << 0); // r
-
-        // get vertices and transform them
-        VGfloat v[2];
-        int     vertcnt = 0;
-        for (int i = 0; i < stroke_vert_cnt * 2; i += 2, vertcnt++) {
-            v[0] = stroke_verts[i];
-            v[1] = stroke_verts[i + 1];
-            affineTransform(vert.v, transform, v);
-
-            // for stroke we need to convert from a strip to triangle
-            switch (vertcnt) {
-            case 0:
-                _vertices.push_back(vert);
-                break;
-            case 1:
-                start_vert = vert;
-                _vertices.push_back(vert);
-                break;
-            case 2:
-                last_vert = vert;
-                _vertices.push_back(vert);
-                break;
-
-            default:
-                _vertices.push_back(start_vert);
-                _vertices.push_back(last_vert);
-                _vertices.push_back(vert);
-                start_vert = last_vert;
-                last_vert  = vert;
-                break;
-            }
-        }
+    // get the paint color
+    const std::array<VGfloat, 4> fc = paint->getPaintColor();
+
+    vert.color = (uint32_t(fc[3] * 255.0f) << 24)   // a
+                 | (uint32_t(fc[2] * 255.0f) << 16) // b
+                 | (uint32_t(fc[1] * 255.0f) << 8)  // g
+                 | (uint32_t(fc[0] * 255.0f) << 0); // r
+
+    // get vertices and transform them. the batch is a plain triangle list so
+    // the indexed mesh is expanded.
+    VGfloat v[2];
+    for (const uint32_t index : mesh.indices) {
+        v[0] = mesh.vertices[index * 2];
+        v[1] = mesh.vertices[index * 2 + 1];
+        affineTransform(vert.v, transform, v);
+        _vertices.push_back(vert);
     }
 }
 
@@ -9,12 +9,15 @@
 #define __glBatch_h__
 
 #include "mkBatch.h"
+#include "mkTessellator.h"
 
 #include "glPlatform.h"
 
 #include <vector>
 
 namespace MonkVG {
+class IPaint;
+
 class OpenGLBatch : public IBatch {
   public:
     OpenGLBatch(IContext &context);
@@ -24,9 +27,11 @@ class OpenGLBatch : public IBatch {
     virtual void dump(void **vertices, size_t *size);
     virtual void finalize();
 
-    void addPathVertexData(GLfloat *fill_verts, size_t fill_vert_cnt,
-                           GLfloat *stroke_verts, size_t stroke_vert_cnt,
-                           VGbitfield paint_modes);
+    /// @brief add the fill and/or the stroke of a path in the current paints
+    /// and transform
+    void addPathVertexData(const indexed_mesh_t &fill,
+                           const indexed_mesh_t &stroke,
+                           VGbitfield            paint_modes);
 
   public:
     struct vertex_t {
@@ -35,6 +40,8 @@ class OpenGLBatch : public IBatch {
     };
 
   private:
+    void addMesh(const indexed_mesh_t &mesh, IPaint *paint);
+
     std::vector<vertex_t> _vertices;
     size_t                _vertexCount;
     GLuint                _vbo;
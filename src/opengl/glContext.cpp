@@ -25,6 +25,9 @@
 #include "shaders/color_frag.glsl"
 #include "shaders/texture_vert.glsl"
 #include "shaders/texture_frag.glsl"
+#include "shaders/stroke_vert.glsl"
+#include "shaders/stroke_frag.glsl"
+#include "shaders/shape_vert.glsl"
 
 namespace MonkVG {
 
@@ -94,6 +97,18 @@ bool OpenGLContext::Initialize() {
         throw std::runtime_error("failed to compile texture shader");
         return false;
     }
+    _stroke_shader = std::make_unique<OpenGLShader>();
+    status = _stroke_shader->compile(stroke_vert.c_str(), stroke_frag.c_str());
+    if (!status) {
+        throw std::runtime_error("failed to compile stroke shader");
+        return false;
+    }
+    _shape_shader = std::make_unique<OpenGLShader>();
+    status = _shape_shader->compile(shape_vert.c_str(), color_frag.c_str());
+    if (!status) {
+        throw std::runtime_error("failed to compile shape shader");
+        return false;
+    }
 
     // get viewport to restore back when we are done
     glGetIntegerv(GL_VIEWPORT, _restore_viewport);
@@ -119,6 +134,10 @@ void OpenGLContext::resize() {
 }
 
 bool OpenGLContext::Terminate() {
+    // cached path buffers need the GL context
+    _tessellation_cache.clear();
+    _round_shapes.clear();
+
     _stroke_paint = nullptr;
     _fill_paint   = nullptr;
     return true;
@@ -209,9 +228,19 @@ void OpenGLContext::stroke() {
     if (getStrokePaint() &&
         getStrokePaint()->getPaintType() == VG_PAINT_TYPE_COLOR) {
         const std::array<VGfloat, 4> color = getStrokePaint()->getPaintColor();
-        _color_shader->setColor({color[0], color[1], color[2], color[3]});
+        getCurrentShader().setColor({color[0], color[1], color[2], color[3]});
         CHECK_GL_ERROR;
 
+        // strokes expanded on the GPU take the stroke style as uniforms
+        if (_current_shader == StrokeShader) {
+            const stroke_style_t &style = getStrokeStyle();
+            _stroke_shader->setUniform1f("u_half_width", style.width * 0.5f);
+            _stroke_shader->setUniform1i("u_cap", style.cap - VG_CAP_BUTT);
+            _stroke_shader->setUniform1i("u_join", style.join - VG_JOIN_MITER);
+            _stroke_shader->setUniform1f("u_miter_limit", style.miter_limit);
+            CHECK_GL_ERROR;
+        }
+
         getStrokePaint()->setIsDirty(false);
         // set the fill paint to dirty
         if (getFillPaint()) {
@@ -228,7 +257,7 @@ void OpenGLContext::fill() {
 
     if (_fill_paint->getPaintType() == VG_PAINT_TYPE_COLOR) {
         const std::array<VGfloat, 4> color = getFillPaint()->getPaintColor();
-        _color_shader->setColor({color[0], color[1], color[2], color[3]});
+        getCurrentShader().setColor({color[0], color[1], color[2], color[3]});
         // set the stroke paint to dirty
         if (getStrokePaint()) {
             getStrokePaint()->setIsDirty(true);
@@ -288,6 +317,12 @@ void OpenGLContext::bindShader(ShaderType shader) {
         case GradientShader:
             _gradient_shader->bind();
             break;
+        case StrokeShader:
+            _stroke_shader->bind();
+            break;
+        case ShapeShader:
+            _shape_shader->bind();
+            break;
         case None:
             glUseProgram(0);
             break;
@@ -312,10 +347,63 @@ OpenGLShader &OpenGLContext::getCurrentShader() {
         return *_texture_shader;
     case GradientShader:
         return *_gradient_shader;
+    case StrokeShader:
+        return *_stroke_shader;
+    case ShapeShader:
+        return *_shape_shader;
     default:
         throw std::runtime_error(
             "OpenGLContext::getCurrentShader: invalid shader type");
     }
 }
 
+gl_round_shape_t::~gl_round_shape_t() {
+    if (vbo != GL_UNDEFINED) {
+        glDeleteBuffers(1, &vbo);
+    }
+    if (vao != GL_UNDEFINED) {
+        glDeleteVertexArrays(1, &vao);
+    }
+}
+
+const gl_round_shape_t &OpenGLContext::roundShape(const uint32_t steps) {
+    std::unique_ptr<gl_round_shape_t> &shape = _round_shapes[steps];
+    if (shape) {
+        return *shape;
+    }
+
+    // a quarter of the corner ellipse per corner, counterclockwise from the
+    // lower right like ITessellator::tessellateShape. corner x, y then
+    // direction x, y per vertex.
+    const VGfloat        corners[4][2] = {{1, 0}, {1, 1}, {0, 1}, {0, 0}};
+    std::vector<VGfloat> vertices;
+    for (int c = 0; c < 4; ++c) {
+        for (uint32_t i = 0; i <= steps; ++i) {
+            const double a = M_PI / 2 * (c - 1 + (double)i / steps);
+            vertices.insert(vertices.end(), {corners[c][0], corners[c][1],
+                                             (VGfloat)cos(a),
+                                             (VGfloat)sin(a)});
+        }
+    }
+
+    shape           = std::make_unique<gl_round_shape_t>();
+    shape->vertices = (GLsizei)(vertices.size() / 4);
+    glGenVertexArrays(1, &shape->vao);
+    glGenBuffers(1, &shape->vbo);
+    glBindVertexArray(shape->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, shape->vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(VGfloat),
+                 vertices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(VGfloat),
+                          (GLvoid *)0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(VGfloat),
+                          (GLvoid *)(2 * sizeof(VGfloat)));
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    CHECK_GL_ERROR;
+    return *shape;
+}
+
 } // namespace MonkVG
@@ -15,6 +15,7 @@
 #include "glShader.h"
 #include <glm/glm.hpp>
 #include <stack>
+#include <unordered_map>
 namespace MonkVG {
 
 // turn on GL error checking if debug
@@ -24,6 +25,24 @@ namespace MonkVG {
 #define CHECK_GL_ERROR
 #endif
 
+/**
+ * @brief A round rect mesh drawn as a triangle fan, shared by every round
+ * rect and ellipse with the same segments per corner. Each vertex holds the
+ * corner of the rect it belongs to and its direction from the center of the
+ * corner ellipse, so shape_vert.glsl places it for any rect and radii. See:
+ * ITessellator::measureShape
+ */
+struct gl_round_shape_t {
+    GLuint  vao      = GL_UNDEFINED;
+    GLuint  vbo      = GL_UNDEFINED;
+    GLsizei vertices = 0;
+
+    gl_round_shape_t() = default;
+    gl_round_shape_t(const gl_round_shape_t &) = delete;
+    gl_round_shape_t &operator=(const gl_round_shape_t &) = delete;
+    ~gl_round_shape_t();
+};
+
 /**
  * @brief Context implementation for OpenGL. Contains OpenGL specific
  * implementations for the IContext interface, as well as OpenGL specific
@@ -81,7 +100,14 @@ class OpenGLContext : public IContext {
 
 
     /// shader management
-    enum ShaderType { ColorShader, TextureShader, GradientShader, None };
+    enum ShaderType {
+        ColorShader,
+        TextureShader,
+        GradientShader,
+        StrokeShader, // strokes expanded on the GPU. See: stroke_vert.glsl
+        ShapeShader,  // round rects and ellipses. See: shape_vert.glsl
+        None
+    };
 
     /**
      * @brief bind the shader for the given type.  This will also setup
@@ -93,6 +119,10 @@ class OpenGLContext : public IContext {
     ShaderType    getCurrentShaderType() const { return _current_shader; }
     OpenGLShader &getCurrentShader();
 
+    /// @brief the round shape mesh with steps segments per corner, made on
+    /// first use and kept until Terminate()
+    const gl_round_shape_t &roundShape(uint32_t steps);
+
     static void checkGLError();
 
   private:
@@ -102,7 +132,11 @@ class OpenGLContext : public IContext {
     std::unique_ptr<OpenGLShader> _color_shader;
     std::unique_ptr<OpenGLShader> _texture_shader;
     std::unique_ptr<OpenGLShader> _gradient_shader;
+    std::unique_ptr<OpenGLShader> _stroke_shader;
+    std::unique_ptr<OpenGLShader> _shape_shader;
 
+    std::unordered_map<uint32_t, std::unique_ptr<gl_round_shape_t>>
+        _round_shapes;
 
     ShaderType _current_shader = ShaderType::None;
 };
@@ -22,76 +22,86 @@ OpenGLPath::OpenGLPath(VGint pathFormat, VGPathDatatype datatype, VGfloat scale,
             coordCapacityHint, capabilities, context) {}
 
 OpenGLPath::~OpenGLPath() {
-    CHECK_GL_ERROR;
+    // the buffers go with the last path drawing them
+}
 
-    if (_fill_vbo != GL_UNDEFINED) {
-        glDeleteBuffers(1, &_fill_vbo);
-        _fill_vbo = GL_UNDEFINED;
+gl_fill_buffers_t::~gl_fill_buffers_t() {
+    if (vbo != GL_UNDEFINED) {
+        glDeleteBuffers(1, &vbo);
     }
-
-    if (_fill_vao != GL_UNDEFINED) {
-        glDeleteVertexArrays(1, &_fill_vao);
-        _fill_vao = GL_UNDEFINED;
+    if (ibo != GL_UNDEFINED) {
+        glDeleteBuffers(1, &ibo);
+    }
+    if (vao != GL_UNDEFINED) {
+        glDeleteVertexArrays(1, &vao);
     }
+}
 
-    if (_stroke_vbo != GL_UNDEFINED) {
-        glDeleteBuffers(1, &_stroke_vbo);
-        _stroke_vbo = GL_UNDEFINED;
+gl_stroke_buffers_t::~gl_stroke_buffers_t() {
+    if (vbo != GL_UNDEFINED) {
+        glDeleteBuffers(1, &vbo);
+    }
+    if (ibo != GL_UNDEFINED) {
+        glDeleteBuffers(1, &ibo);
+    }
+    if (vao != GL_UNDEFINED) {
+        glDeleteVertexArrays(1, &vao);
     }
+}
 
-    if (_stroke_vao != GL_UNDEFINED) {
-        glDeleteVertexArrays(1, &_stroke_vao);
-        _stroke_vao = GL_UNDEFINED;
+gl_path_buffers_t::~gl_path_buffers_t() {
+    if (vbo != GL_UNDEFINED) {
+        glDeleteBuffers(1, &vbo);
+    }
+    if (ibo != GL_UNDEFINED) {
+        glDeleteBuffers(1, &ibo);
+    }
+    if (vao != GL_UNDEFINED) {
+        glDeleteVertexArrays(1, &vao);
     }
-    CHECK_GL_ERROR;
 }
 
 void OpenGLPath::clear(VGbitfield caps) {
     IPath::clear(caps);
 
-    _fill_vertices.clear();
-
-    // delete vbo buffers
-    if (_stroke_vbo != GL_UNDEFINED) {
-        glDeleteBuffers(1, &_stroke_vbo);
-        _stroke_vbo = GL_UNDEFINED;
+    // async paths keep drawing the old buffers until the rebuild arrives
+    if (getContext().getTessellationAsync()) {
+        return;
     }
 
-    if (_fill_vbo != GL_UNDEFINED) {
-        glDeleteBuffers(1, &_fill_vbo);
-        _fill_vbo = GL_UNDEFINED;
-    }
+    _fill_buffers   = nullptr;
+    _stroke_buffers = nullptr;
+    _path_buffers   = nullptr;
 }
 
-void OpenGLPath::buildFillIfDirty() {
+bool OpenGLPath::updateFillPaint() {
     IPaint *current_fill_paint = getContext().getFillPaint();
-    if (current_fill_paint != _fill_paint) {
-        _fill_paint = (OpenGLPaint *)current_fill_paint;
-        setFillDirty(true);
-    }
-    // only build the fill if dirty or we are in batch build mode
-    if (getIsFillDirty() || getContext().currentBatch()) {
-        // tessellate the path
-        getContext().getTessellator().tessellate(
-            _segments, _fcoords, getContext().getFillRule(),
-            getContext().getTessellationIterations(), _fill_vertices, _bounds);
-    }
-    setFillDirty(false);
+    if (current_fill_paint == _fill_paint) {
+        return false;
+    }
+    _fill_paint = (OpenGLPaint *)current_fill_paint;
+    return true;
 }
 
-void OpenGLPath::buildStrokeIfDirty() {
+bool OpenGLPath::updateStrokePaint() {
     IPaint *current_stroke_paint = getContext().getStrokePaint();
-    if (current_stroke_paint != _stroke_paint) {
-        _stroke_paint = (OpenGLPaint *)current_stroke_paint;
-        setStrokeDirty(true);
-    }
-    // only build the fill if dirty or we are in batch build mode
-    if (getIsStrokeDirty() || getContext().currentBatch()) {
-        getContext().getTessellator().buildStroke(
-            _segments, _fcoords, getContext().getStrokeLineWidth(),
-            getContext().getTessellationIterations(), _stroke_verts);
+    if (current_stroke_paint == _stroke_paint) {
+        return false;
     }
-    setStrokeDirty(false);
+    _stroke_paint = (OpenGLPaint *)current_stroke_paint;
+    return true;
+}
+
+bool OpenGLPath::expandsStrokeOnGpu() {
+    // batches collect meshes and dashes are cut on the CPU
+    IContext &ctx = getContext();
+    return ctx.getStrokeMode() == VG_STROKE_MODE_GPU_MNK &&
+           ctx.getStrokeDashPattern().empty() && !ctx.currentBatch();
+}
+
+bool OpenGLPath::drawsRoundShapes() {
+    // batches collect meshes
+    return !getContext().currentBatch();
 }
 
 bool OpenGLPath::draw(VGbitfield paint_modes) {
@@ -109,15 +119,7 @@ bool OpenGLPath::draw(VGbitfield paint_modes) {
     // if dirty build the stroke and fill
     // this will take the path data and build the vertex data
     // through tessellation
-    if (paint_modes & VG_FILL_PATH) {
-        buildFillIfDirty();
-    }
-
-    if (paint_modes & VG_STROKE_PATH) {
-        buildStrokeIfDirty();
-    }
-
-    buildOpenGLBuffers(paint_modes);
+    buildForDraw(paint_modes);
 
     if (gl_ctx.currentBatch()) {
         return true; // creating a batch so bail from here
@@ -126,18 +128,57 @@ bool OpenGLPath::draw(VGbitfield paint_modes) {
     // restore image mode later
     VGImageMode old_image_mode = gl_ctx.getImageMode();
 
+    // a fill and stroke uploaded together are drawn with one vao bind
+    const gl_path_buffers_t *shared    = _path_buffers.get();
+    GLuint                   bound_vao = 0;
+    const auto               bindVao   = [&bound_vao](const GLuint vao) {
+        if (vao != bound_vao) {
+            glBindVertexArray(vao);
+            bound_vao = vao;
+        }
+    };
+    bool color_bound = false;
+
     // configure based on paint type
-    if (_fill_paint && _fill_paint->getPaintType() == VG_PAINT_TYPE_COLOR) {
+    if (!(paint_modes & VG_FILL_PATH)) {
+        // only the stroke
+    } else if (_fill_paint &&
+               _fill_paint->getPaintType() == VG_PAINT_TYPE_COLOR &&
+               _fill_shape_steps > 0) {
+        // the shared round rect mesh placed by the shape. See:
+        // shape_vert.glsl
+        gl_ctx.bindShader(OpenGLContext::ShaderType::ShapeShader);
+        getContext().fill();
+
+        VGfloat rect[4], radius[2];
+        _fill_shape.roundRect(rect, radius);
+        OpenGLShader &shader = gl_ctx.getCurrentShader();
+        shader.setUniform4f("u_rect", rect[0], rect[1], rect[2], rect[3]);
+        shader.setUniform2f("u_radius", radius[0], radius[1]);
+
+        const gl_round_shape_t &mesh = gl_ctx.roundShape(_fill_shape_steps);
+        bindVao(mesh.vao);
+        glDrawArrays(GL_TRIANGLE_FAN, 0, mesh.vertices);
+
+    } else if (_fill_paint &&
+               _fill_paint->getPaintType() == VG_PAINT_TYPE_COLOR) {
         // set the shader to a color shader
         gl_ctx.bindShader(OpenGLContext::ShaderType::ColorShader);
+        color_bound = true;
 
         // context will setup any uniforms
         getContext().fill();
 
         // bind the vao & vbo and draw
-        glBindVertexArray(_fill_vao);
-        glDrawArrays(GL_TRIANGLES, 0, _num_fill_verts);
-        glBindVertexArray(0);
+        if (_fill_buffers) {
+            bindVao(_fill_buffers->vao);
+            glDrawElements(GL_TRIANGLES, _fill_buffers->num_indices,
+                           _fill_buffers->index_type, (GLvoid *)0);
+        } else if (shared && shared->fill_indices > 0) {
+            bindVao(shared->vao);
+            glDrawElements(GL_TRIANGLES, shared->fill_indices,
+                           shared->index_type, (GLvoid *)0);
+        }
 
     } else if (_fill_paint &&
                (_fill_paint->getPaintType() == VG_PAINT_TYPE_LINEAR_GRADIENT ||
@@ -156,19 +197,46 @@ bool OpenGLPath::draw(VGbitfield paint_modes) {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     // draw the stroke last so it renders on top of fill
-    if ((paint_modes & VG_STROKE_PATH) && _stroke_vao != GL_UNDEFINED) {
+    const bool shared_stroke =
+        !_stroke_buffers && shared && shared->stroke_indices > 0;
+    if ((paint_modes & VG_STROKE_PATH) && (_stroke_buffers || shared_stroke)) {
+        const bool on_gpu = _stroke_buffers && _stroke_buffers->num_instances;
         if (_stroke_paint &&
             _stroke_paint->getPaintType() == VG_PAINT_TYPE_COLOR) {
-            // set the shader to a color shader
-            gl_ctx.bindShader(OpenGLContext::ShaderType::ColorShader);
-
+            // set the shader to a color shader. the fill left it bound.
+            if (on_gpu) {
+                gl_ctx.bindShader(OpenGLContext::ShaderType::StrokeShader);
+            } else if (!color_bound) {
+                gl_ctx.bindShader(OpenGLContext::ShaderType::ColorShader);
+            }
         } else {
             throw std::runtime_error("Non color stroke paint not implemented");
         }
         // draw
         getContext().stroke();
-        glBindVertexArray(_stroke_vao);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, _num_stroke_verts);
+        if (shared_stroke) {
+            const size_t index_size = shared->index_type == GL_UNSIGNED_SHORT
+                                          ? sizeof(uint16_t)
+                                          : sizeof(uint32_t);
+            bindVao(shared->vao);
+            glDrawElementsBaseVertex(
+                shared->stroke_primitive, shared->stroke_indices,
+                shared->index_type,
+                (GLvoid *)(shared->stroke_first * index_size),
+                shared->stroke_base_vertex);
+        } else if (on_gpu) {
+            // 36 vertices per segment. See: stroke_vert.glsl
+            bindVao(_stroke_buffers->vao);
+            glDrawArraysInstanced(GL_TRIANGLES, 0, 36,
+                                  _stroke_buffers->num_instances);
+        } else {
+            bindVao(_stroke_buffers->vao);
+            glDrawElements(_stroke_buffers->primitive,
+                           _stroke_buffers->num_indices,
+                           _stroke_buffers->index_type, (GLvoid *)0);
+        }
+    }
+    if (bound_vao != 0) {
         glBindVertexArray(0);
     }
 
@@ -177,102 +245,405 @@ bool OpenGLPath::draw(VGbitfield paint_modes) {
     return true;
 }
 
-void OpenGLPath::buildOpenGLBuffers(VGbitfield paint_modes) {
-    /// build fill vao & vbo
-    if (_fill_vertices.size() > 0) {
+void OpenGLPath::buildBuffers(VGbitfield paint_modes) {
+    const bool textured =
+        _fill_paint &&
+        (_fill_paint->getPaintType() == VG_PAINT_TYPE_LINEAR_GRADIENT ||
+         _fill_paint->getPaintType() == VG_PAINT_TYPE_RADIAL_GRADIENT ||
+         _fill_paint->getPaintType() == VG_PAINT_TYPE_RADIAL_2x3_GRADIENT ||
+         _fill_paint->getPaintType() == VG_PAINT_TYPE_LINEAR_2x3_GRADIENT);
+
+    /// build one vao, vbo & ibo for both
+    VGbitfield upload_modes = _upload_modes;
+    if (sharesPathBuffers(textured)) {
+        _path_buffers   = createPathBuffers(getFillMesh(), getStrokeMesh());
+        _fill_buffers   = nullptr;
+        _stroke_buffers = nullptr;
+        upload_modes    = 0;
+    }
 
-        // delete the old vbo
-        if (_fill_vbo != GL_UNDEFINED) {
-            glDeleteBuffers(1, &_fill_vbo);
-            _fill_vbo = GL_UNDEFINED;
+    /// build fill vao, vbo & ibo
+    if (upload_modes & VG_FILL_PATH) {
+        // cached geometry may already be uploaded by another path
+        std::shared_ptr<gl_fill_buffers_t> buffers = nullptr;
+        if (_fill_entry) {
+            buffers = std::static_pointer_cast<gl_fill_buffers_t>(
+                _fill_entry->gpu_buffers);
         }
-
-        // delete the old vao
-        if (_fill_vao != GL_UNDEFINED) {
-            glDeleteVertexArrays(1, &_fill_vao);
-            _fill_vao = GL_UNDEFINED;
+        if (buffers && buffers->textured != textured) {
+            buffers = nullptr;
         }
 
-        glGenVertexArrays(1, &_fill_vao);
-        glGenBuffers(1, &_fill_vbo);
-        glBindVertexArray(_fill_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, _fill_vbo);
-        if (_fill_paint && _fill_paint->getPaintType() == VG_PAINT_TYPE_COLOR) {
-            glBufferData(GL_ARRAY_BUFFER,
-                         _fill_vertices.size() * sizeof(VGfloat),
-                         _fill_vertices.data(), GL_STATIC_DRAW);
-            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
-            glEnableVertexAttribArray(0);
-        } else if (_fill_paint && (_fill_paint->getPaintType() ==
-                                       VG_PAINT_TYPE_LINEAR_GRADIENT ||
-                                   _fill_paint->getPaintType() ==
-                                       VG_PAINT_TYPE_RADIAL_GRADIENT ||
-                                   _fill_paint->getPaintType() ==
-                                       VG_PAINT_TYPE_RADIAL_2x3_GRADIENT ||
-                                   _fill_paint->getPaintType() ==
-                                       VG_PAINT_TYPE_LINEAR_2x3_GRADIENT)) {
-            // throw std::runtime_error("Not implemented");
-            std::vector<textured_vertex_2d_t> texturedVertices;
-            for (std::vector<float>::const_iterator it = _fill_vertices.begin();
-                 it != _fill_vertices.end(); it++) {
-                // build up the textured vertex
-                textured_vertex_2d_t v;
-                v.vert.x = *it;
-                it++;
-                v.vert.y = *it;
-                v.uv[0]  = fabsf(v.vert.x - getMinX()) / getWidth();
-                v.uv[1]  = fabsf(v.vert.x - getMinY()) / getHeight();
-                texturedVertices.push_back(v);
+        // growing fills only upload what was appended
+        const indexed_mesh_t &mesh = getFillMesh();
+        if (!buffers && _fill_growing && _fill_buffers && !textured &&
+            appendFillBuffers(*_fill_buffers, mesh)) {
+            buffers = _fill_buffers;
+        }
+        // editing fills only upload the contours that were modified
+        if (!buffers && _fill_rewritten && _fill_buffers && !textured &&
+            rewriteFillBuffers(*_fill_buffers, mesh)) {
+            buffers = _fill_buffers;
+        }
+        if (!buffers && !mesh.indices.empty()) {
+            buffers = createFillBuffers(mesh, textured);
+            if (_fill_entry) {
+                _fill_entry->gpu_buffers = buffers;
             }
+        }
+        _fill_buffers = std::move(buffers); // releases the old buffers
+        if (_path_buffers) {
+            _path_buffers->fill_indices = 0;
+        }
+        if (_fill_growing) {
+            _fill_uploaded_vertices = mesh.vertexCount();
+            _fill_uploaded_indices  = (uint32_t)mesh.indices.size();
+        }
 
-            glBufferData(GL_ARRAY_BUFFER,
-                         texturedVertices.size() * sizeof(textured_vertex_2d_t),
-                         &texturedVertices[0], GL_STATIC_DRAW);
-
-            texturedVertices.clear();
-
+        if (textured) {
             // setup the paints linear gradient
             _fill_paint->buildGradientImage(getWidth(), getHeight());
         }
-
-        _num_fill_verts = (int)_fill_vertices.size() / 2;
     }
 
     /// build stroke vbo
-    if (_stroke_verts.size() > 0) {
-        // build the vertex buffer object VBO
-        if (_stroke_vbo != GL_UNDEFINED) {
-            glDeleteBuffers(1, &_stroke_vbo);
-            _stroke_vbo = GL_UNDEFINED;
+    if (upload_modes & VG_STROKE_PATH) {
+        std::shared_ptr<gl_stroke_buffers_t> buffers = nullptr;
+        if (_stroke_entry) {
+            buffers = std::static_pointer_cast<gl_stroke_buffers_t>(
+                _stroke_entry->gpu_buffers);
         }
 
-        if (_stroke_vao != GL_UNDEFINED) {
-            glDeleteVertexArrays(1, &_stroke_vao);
-            _stroke_vao = GL_UNDEFINED;
+        const indexed_mesh_t &mesh = getStrokeMesh();
+        if (_stroke_on_gpu) {
+            if (!_stroke_segments.empty()) {
+                buffers = createStrokeSegmentBuffers(_stroke_segments);
+            }
+        } else if (_stroke_rescaled && _stroke_buffers &&
+                   _stroke_buffers->num_instances == 0) {
+            // a new width of a stroke the path built itself. See:
+            // IPath::rescaleStroke()
+            glBindBuffer(GL_ARRAY_BUFFER, _stroke_buffers->vbo);
+            glBufferSubData(GL_ARRAY_BUFFER, 0,
+                            mesh.vertices.size() * sizeof(VGfloat),
+                            mesh.vertices.data());
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            buffers = _stroke_buffers;
+        } else if (!buffers && !mesh.indices.empty()) {
+            buffers = createStrokeBuffers(mesh);
+            if (_stroke_entry) {
+                _stroke_entry->gpu_buffers = buffers;
+            }
         }
-        glGenVertexArrays(1, &_stroke_vao);
-        glGenBuffers(1, &_stroke_vbo);
-        glBindVertexArray(_stroke_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, _stroke_vbo);
-        glBufferData(GL_ARRAY_BUFFER,
-                     _stroke_verts.size() * sizeof(vertex_2d_t),
-                     _stroke_verts.data(), GL_STATIC_DRAW);
+        _stroke_buffers = std::move(buffers);
+        if (_path_buffers) {
+            _path_buffers->stroke_indices = 0;
+        }
+    }
+    if (_path_buffers && _path_buffers->fill_indices == 0 &&
+        _path_buffers->stroke_indices == 0) {
+        _path_buffers = nullptr;
+    }
+
+    OpenGLBatch *glBatch = (OpenGLBatch *)getContext().currentBatch();
+    if (glBatch) { // if in batch mode update the current batch
+        glBatch->addPathVertexData(getFillMesh(), getStrokeMesh(),
+                                   paint_modes);
+    }
+
+    // clear out vertex buffer. growing and editing fills are kept to append
+    // to and modify.
+    if (!_fill_growing && !_fill_editing) {
+        _fill_mesh.clear();
+    }
+    // so are strokes that change width
+    if (!_stroke_scaling) {
+        _stroke_mesh.clear();
+    }
+    _stroke_segments.clear();
+    _fill_entry   = nullptr;
+    _stroke_entry = nullptr;
+    _upload_modes = 0;
+}
+
+std::shared_ptr<gl_fill_buffers_t>
+OpenGLPath::createFillBuffers(const indexed_mesh_t &mesh, const bool textured) {
+    auto buffers      = std::make_shared<gl_fill_buffers_t>();
+    buffers->textured = textured;
+
+    // growing fills get twice the room they need so appends are amortized.
+    // editing fills have their modified contours rewritten.
+    const bool   grow   = _fill_growing && !textured;
+    const GLenum usage  = _fill_editing ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
+    auto         upload = [grow, usage](const GLenum target,
+                                        const GLsizeiptr size, const void *data,
+                                        GLsizeiptr &capacity) {
+        capacity = grow ? size * 2 : size;
+        if (grow) {
+            glBufferData(target, capacity, nullptr, GL_DYNAMIC_DRAW);
+            glBufferSubData(target, 0, size, data);
+        } else {
+            glBufferData(target, size, data, usage);
+        }
+    };
+
+    glGenVertexArrays(1, &buffers->vao);
+    glGenBuffers(1, &buffers->vbo);
+    glBindVertexArray(buffers->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers->vbo);
+    if (!textured) {
+        upload(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(VGfloat),
+               mesh.vertices.data(), buffers->vertex_capacity);
         glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
         glEnableVertexAttribArray(0);
+    } else {
+        std::vector<textured_vertex_2d_t> texturedVertices;
+        for (std::vector<float>::const_iterator it = mesh.vertices.begin();
+             it != mesh.vertices.end(); it++) {
+            // build up the textured vertex
+            textured_vertex_2d_t v;
+            v.vert.x = *it;
+            it++;
+            v.vert.y = *it;
+            v.uv[0]  = fabsf(v.vert.x - getMinX()) / getWidth();
+            v.uv[1]  = fabsf(v.vert.x - getMinY()) / getHeight();
+            texturedVertices.push_back(v);
+        }
 
-        _num_stroke_verts = (int)_stroke_verts.size();
+        glBufferData(GL_ARRAY_BUFFER,
+                     texturedVertices.size() * sizeof(textured_vertex_2d_t),
+                     &texturedVertices[0], GL_STATIC_DRAW);
     }
 
-    OpenGLBatch *glBatch = (OpenGLBatch *)getContext().currentBatch();
-    if (glBatch) { // if in batch mode update the current batch
-        glBatch->addPathVertexData(
-            &_fill_vertices[0], _fill_vertices.size() / 2,
-            (float *)&_stroke_verts[0], _stroke_verts.size(), paint_modes);
+    // the element buffer binding is part of the vao state
+    glGenBuffers(1, &buffers->ibo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers->ibo);
+    if (mesh.fitsIndex16()) {
+        mesh.packIndices16(_indices16);
+        upload(GL_ELEMENT_ARRAY_BUFFER,
+               _indices16.size() * sizeof(uint16_t),
+               _indices16.data(), buffers->index_capacity);
+        buffers->index_type = GL_UNSIGNED_SHORT;
+        _indices16.clear();
+    } else {
+        upload(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(uint32_t),
+               mesh.indices.data(), buffers->index_capacity);
+        buffers->index_type = GL_UNSIGNED_INT;
+    }
+    glBindVertexArray(0);
+
+    buffers->num_indices = (int)mesh.indices.size();
+    return buffers;
+}
+
+bool OpenGLPath::appendFillBuffers(gl_fill_buffers_t    &buffers,
+                                   const indexed_mesh_t &mesh) {
+    const bool   index16    = buffers.index_type == GL_UNSIGNED_SHORT;
+    const size_t index_size = index16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    if (_fill_uploaded_indices == 0 || buffers.textured ||
+        (index16 && !mesh.fitsIndex16()) ||
+        (GLsizeiptr)(mesh.vertices.size() * sizeof(VGfloat)) >
+            buffers.vertex_capacity ||
+        (GLsizeiptr)(mesh.indices.size() * index_size) >
+            buffers.index_capacity) {
+        return false;
+    }
+
+    // only past the end of what earlier draws read
+    const size_t first_vertex = (size_t)_fill_uploaded_vertices * 2;
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, first_vertex * sizeof(VGfloat),
+                    (mesh.vertices.size() - first_vertex) * sizeof(VGfloat),
+                    mesh.vertices.data() + first_vertex);
+
+    // the element buffer binding is part of the vao state
+    glBindVertexArray(buffers.vao);
+    const size_t first_index = _fill_uploaded_indices;
+    const size_t count       = mesh.indices.size() - first_index;
+    if (index16) {
+        _indices16.assign(mesh.indices.begin() + first_index,
+                               mesh.indices.end());
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, first_index * index_size,
+                        count * index_size, _indices16.data());
+        _indices16.clear();
+    } else {
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, first_index * index_size,
+                        count * index_size, mesh.indices.data() + first_index);
+    }
+    glBindVertexArray(0);
+
+    buffers.num_indices = (int)mesh.indices.size();
+    return true;
+}
+
+bool OpenGLPath::rewriteFillBuffers(gl_fill_buffers_t    &buffers,
+                                    const indexed_mesh_t &mesh) {
+    const bool   index16    = buffers.index_type == GL_UNSIGNED_SHORT;
+    const size_t index_size = index16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    if (buffers.textured || buffers.num_indices != (int)mesh.indices.size() ||
+        (GLsizeiptr)(mesh.vertices.size() * sizeof(VGfloat)) >
+            buffers.vertex_capacity ||
+        _fill_rewrite_first_vertex >= _fill_rewrite_end_vertex) {
+        return false;
+    }
+
+    const size_t first_vertex = (size_t)_fill_rewrite_first_vertex * 2;
+    const size_t end_vertex   = (size_t)_fill_rewrite_end_vertex * 2;
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, first_vertex * sizeof(VGfloat),
+                    (end_vertex - first_vertex) * sizeof(VGfloat),
+                    mesh.vertices.data() + first_vertex);
+
+    // the element buffer binding is part of the vao state
+    glBindVertexArray(buffers.vao);
+    const size_t first_index = _fill_rewrite_first_index;
+    const size_t count       = _fill_rewrite_end_index - first_index;
+    if (index16) {
+        _indices16.assign(mesh.indices.begin() + first_index,
+                          mesh.indices.begin() + first_index + count);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, first_index * index_size,
+                        count * index_size, _indices16.data());
+        _indices16.clear();
+    } else {
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, first_index * index_size,
+                        count * index_size, mesh.indices.data() + first_index);
+    }
+    glBindVertexArray(0);
+    return true;
+}
+
+std::shared_ptr<gl_stroke_buffers_t>
+OpenGLPath::createStrokeBuffers(const indexed_mesh_t &mesh) {
+    auto buffers = std::make_shared<gl_stroke_buffers_t>();
+
+    glGenVertexArrays(1, &buffers->vao);
+    glGenBuffers(1, &buffers->vbo);
+    glBindVertexArray(buffers->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers->vbo);
+    // strokes changing width have their vertices rewritten
+    glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(VGfloat),
+                 mesh.vertices.data(),
+                 _stroke_scaling ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
+    glEnableVertexAttribArray(0);
+
+    // the element buffer binding is part of the vao state
+    glGenBuffers(1, &buffers->ibo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers->ibo);
+    if (mesh.fitsIndex16()) {
+        mesh.packIndices16(_indices16);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                     _indices16.size() * sizeof(uint16_t), _indices16.data(),
+                     GL_STATIC_DRAW);
+        buffers->index_type = GL_UNSIGNED_SHORT;
+        _indices16.clear();
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                     mesh.indices.size() * sizeof(uint32_t),
+                     mesh.indices.data(), GL_STATIC_DRAW);
+        buffers->index_type = GL_UNSIGNED_INT;
+    }
+    glBindVertexArray(0);
+
+    buffers->num_indices = (int)mesh.indices.size();
+    buffers->primitive   = mesh.lines ? GL_LINES : GL_TRIANGLES;
+    return buffers;
+}
+
+bool OpenGLPath::sharesPathBuffers(const bool textured) {
+    // buffers that are appended to, rewritten, already uploaded through the
+    // cache or kept with a level of detail stay on their own
+    const VGbitfield both = VG_FILL_PATH | VG_STROKE_PATH;
+    if ((_upload_modes & both) != both || textured || _fill_growing ||
+        _fill_editing || _stroke_on_gpu || _stroke_scaling || keepsLods() ||
+        (_fill_entry && _fill_entry->gpu_buffers) ||
+        (_stroke_entry && _stroke_entry->gpu_buffers)) {
+        return false;
+    }
+    return !getFillMesh().indices.empty() && !getStrokeMesh().indices.empty();
+}
+
+std::shared_ptr<gl_path_buffers_t>
+OpenGLPath::createPathBuffers(const indexed_mesh_t &fill,
+                              const indexed_mesh_t &stroke) {
+    auto buffers = std::make_shared<gl_path_buffers_t>();
+
+    const bool       index16    = fill.fitsIndex16() && stroke.fitsIndex16();
+    const size_t     index_size = index16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    const GLsizeiptr fill_vertex_bytes = fill.vertices.size() * sizeof(VGfloat);
+    const GLsizeiptr fill_index_bytes  = fill.indices.size() * index_size;
+
+    glGenVertexArrays(1, &buffers->vao);
+    glGenBuffers(1, &buffers->vbo);
+    glBindVertexArray(buffers->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers->vbo);
+    glBufferData(GL_ARRAY_BUFFER,
+                 fill_vertex_bytes + stroke.vertices.size() * sizeof(VGfloat),
+                 nullptr, GL_STATIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, fill_vertex_bytes,
+                    fill.vertices.data());
+    glBufferSubData(GL_ARRAY_BUFFER, fill_vertex_bytes,
+                    stroke.vertices.size() * sizeof(VGfloat),
+                    stroke.vertices.data());
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
+    glEnableVertexAttribArray(0);
+
+    // the element buffer binding is part of the vao state. both meshes keep
+    // their own indices, the stroke's are drawn from a base vertex.
+    glGenBuffers(1, &buffers->ibo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers->ibo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 fill_index_bytes + stroke.indices.size() * index_size,
+                 nullptr, GL_STATIC_DRAW);
+    const auto upload = [&](const GLintptr offset, const indexed_mesh_t &mesh) {
+        if (index16) {
+            mesh.packIndices16(_indices16);
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset,
+                            _indices16.size() * sizeof(uint16_t),
+                            _indices16.data());
+        } else {
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset,
+                            mesh.indices.size() * sizeof(uint32_t),
+                            mesh.indices.data());
+        }
+    };
+    upload(0, fill);
+    upload(fill_index_bytes, stroke);
+    _indices16.clear();
+    glBindVertexArray(0);
+
+    buffers->index_type         = index16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    buffers->stroke_primitive   = stroke.lines ? GL_LINES : GL_TRIANGLES;
+    buffers->fill_indices       = (int)fill.indices.size();
+    buffers->stroke_first       = buffers->fill_indices;
+    buffers->stroke_indices     = (int)stroke.indices.size();
+    buffers->stroke_base_vertex = (GLint)fill.vertexCount();
+    return buffers;
+}
+
+std::shared_ptr<gl_stroke_buffers_t> OpenGLPath::createStrokeSegmentBuffers(
+    const std::vector<stroke_segment_t> &segments) {
+    auto buffers = std::make_shared<gl_stroke_buffers_t>();
+
+    glGenVertexArrays(1, &buffers->vao);
+    glGenBuffers(1, &buffers->vbo);
+    glBindVertexArray(buffers->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers->vbo);
+    glBufferData(GL_ARRAY_BUFFER, segments.size() * sizeof(stroke_segment_t),
+                 segments.data(), GL_STATIC_DRAW);
+
+    // prev, p0, p1 and next advance once per instance
+    for (GLuint i = 0; i < 4; i++) {
+        glVertexAttribPointer(i, 2, GL_FLOAT, GL_FALSE,
+                              sizeof(stroke_segment_t),
+                              (GLvoid *)(i * sizeof(vertex_2d_t)));
+        glVertexAttribDivisor(i, 1);
+        glEnableVertexAttribArray(i);
     }
+    glBindVertexArray(0);
 
-    // clear out vertex buffer
-    _fill_vertices.clear();
-    _stroke_verts.clear();
+    buffers->num_instances = (GLsizei)segments.size();
+    return buffers;
 }
 
-} // namespace MonkVG
+} // namespace MonkVG
\ No newline at end of file
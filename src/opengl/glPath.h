@@ -19,6 +19,65 @@
 
 namespace MonkVG {
 
+/**
+ * @brief The vao, vbo and ibo of a fill. Shared through the tessellation
+ * cache by the paths with the same fill geometry.
+ */
+struct gl_fill_buffers_t : public gpu_buffers_t {
+    GLuint vao         = GL_UNDEFINED;
+    GLuint vbo         = GL_UNDEFINED;
+    GLuint ibo         = GL_UNDEFINED;
+    int    num_indices = 0;
+    GLenum index_type  = GL_UNSIGNED_SHORT;
+    bool   textured    = false; // textured_vertex_2d_t vertices for gradients
+
+    // allocated bytes. growing paths leave room to append to.
+    GLsizeiptr vertex_capacity = 0;
+    GLsizeiptr index_capacity  = 0;
+
+    ~gl_fill_buffers_t() override;
+};
+
+/**
+ * @brief The vao, vbo and ibo of a stroke. See: gl_fill_buffers_t. A stroke
+ * expanded on the GPU has no ibo and one stroke_segment_t per instance in
+ * its vbo. A hairline stroke indexes GL_LINES.
+ */
+struct gl_stroke_buffers_t : public gpu_buffers_t {
+    GLuint  vao           = GL_UNDEFINED;
+    GLuint  vbo           = GL_UNDEFINED;
+    GLuint  ibo           = GL_UNDEFINED;
+    int     num_indices   = 0;
+    GLenum  index_type    = GL_UNSIGNED_SHORT;
+    GLenum  primitive     = GL_TRIANGLES;
+    GLsizei num_instances = 0; // segments expanded on the GPU
+
+    ~gl_stroke_buffers_t() override;
+};
+
+/**
+ * @brief One vao, vbo and ibo holding both the fill and the stroke of a
+ * path, fill first. Drawn with one vao bind and a glDrawElements per range.
+ * Only the path that uploaded them draws them, so they are never shared
+ * through the cache. See: OpenGLPath::createPathBuffers
+ */
+struct gl_path_buffers_t : public gpu_buffers_t {
+    GLuint vao              = GL_UNDEFINED;
+    GLuint vbo              = GL_UNDEFINED;
+    GLuint ibo              = GL_UNDEFINED;
+    GLenum index_type       = GL_UNSIGNED_SHORT;
+    GLenum stroke_primitive = GL_TRIANGLES;
+
+    // index ranges. a range uploaded again on its own is set to 0. the
+    // stroke's indices count from its first vertex, past the fill's.
+    int   fill_indices       = 0;
+    int   stroke_first       = 0;
+    int   stroke_indices     = 0;
+    GLint stroke_base_vertex = 0;
+
+    ~gl_path_buffers_t() override;
+};
+
 class OpenGLPath : public IPath {
   public:
     OpenGLPath(VGint pathFormat, VGPathDatatype datatype, VGfloat scale,
@@ -28,8 +87,14 @@ class OpenGLPath : public IPath {
 
     bool draw(VGbitfield paintModes) override;
     void clear(VGbitfield caps) override;
-    void buildFillIfDirty() override;
-    void buildStrokeIfDirty() override;
+    void buildBuffers(VGbitfield paintModes) override;
+
+  protected:
+    bool updateFillPaint() override;
+    bool updateStrokePaint() override;
+    bool expandsStrokeOnGpu() override;
+    bool drawsHairlines() override { return true; }
+    bool drawsRoundShapes() override;
 
   private:
     // struct v2_t {
@@ -42,20 +107,45 @@ class OpenGLPath : public IPath {
     // };
 
   private:
-    std::vector<float>       _fill_vertices = {};
-    std::vector<vertex_2d_t> _stroke_verts  = {};
+    std::vector<uint16_t> _indices16 = {}; // 16 bit upload scratch
+
+    std::shared_ptr<gl_fill_buffers_t>   _fill_buffers   = nullptr;
+    std::shared_ptr<gl_stroke_buffers_t> _stroke_buffers = nullptr;
+    std::shared_ptr<gl_path_buffers_t>   _path_buffers   = nullptr;
+
+    OpenGLPaint *_fill_paint   = nullptr;
+    OpenGLPaint *_stroke_paint = nullptr;
+
+    std::shared_ptr<gl_fill_buffers_t>
+    createFillBuffers(const indexed_mesh_t &mesh, bool textured);
+
+    /// @brief upload the part of a growing fill past _fill_uploaded_vertices
+    /// and _fill_uploaded_indices into the free room of buffers. Returns
+    /// false if it does not fit.
+    bool appendFillBuffers(gl_fill_buffers_t &buffers,
+                           const indexed_mesh_t &mesh);
+
+    /// @brief upload the vertex and index ranges of an editing fill that
+    /// IPath::modifyFill() rewrote in place into buffers. Returns false if
+    /// buffers do not hold the fill it modified.
+    bool rewriteFillBuffers(gl_fill_buffers_t &buffers,
+                            const indexed_mesh_t &mesh);
+    std::shared_ptr<gl_stroke_buffers_t>
+    createStrokeBuffers(const indexed_mesh_t &mesh);
 
-    GLuint _fill_vbo   = GL_UNDEFINED;
-    GLuint _fill_vao   = GL_UNDEFINED;
-    GLuint _stroke_vbo = GL_UNDEFINED;
-    GLuint _stroke_vao = GL_UNDEFINED;
+    /// @brief true if the fill and stroke waiting for buildBuffers() can
+    /// go into one gl_path_buffers_t
+    bool sharesPathBuffers(bool textured);
 
-    int          _num_fill_verts   = 0;
-    int          _num_stroke_verts = 0;
-    OpenGLPaint *_fill_paint       = nullptr;
-    OpenGLPaint *_stroke_paint     = nullptr;
+    /// @brief upload the fill and the stroke into one set of buffers
+    std::shared_ptr<gl_path_buffers_t>
+    createPathBuffers(const indexed_mesh_t &fill,
+                      const indexed_mesh_t &stroke);
 
-    void buildOpenGLBuffers(VGbitfield paintModes);
+    /// @brief upload the segments of a stroke expanded on the GPU as
+    /// instances. See: stroke_vert.glsl
+    std::shared_ptr<gl_stroke_buffers_t>
+    createStrokeSegmentBuffers(const std::vector<stroke_segment_t> &segments);
 };
 } // namespace MonkVG
 
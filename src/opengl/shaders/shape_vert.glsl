@@ -0,0 +1,28 @@
+#ifdef CPP_GLSL_INCLUDE
+std::string shape_vert = R"(
+#version 330 core
+
+// places a vertex of the shared round rect mesh. See: gl_round_shape_t.
+// an ellipse is a round rect as large as its corner ellipse.
+
+uniform mat4 u_model_view;
+uniform mat4 u_projection;
+uniform vec4 u_color;
+
+uniform vec4 u_rect;   // lower left corner and size
+uniform vec2 u_radius; // of the corner ellipse
+
+layout (location = 0) in vec2 corner;    // of the rect, 0 or 1 per axis
+layout (location = 1) in vec2 direction; // from the corner ellipse center
+
+out vec4 out_color;
+void main() {
+    vec2 center = u_rect.xy + corner * u_rect.zw +
+                  (1.0 - 2.0 * corner) * u_radius;
+    gl_Position = u_projection * u_model_view *
+                  vec4(center + direction * u_radius, 1.0, 1.0);
+    out_color = u_color;
+}
+
+)";
+#endif
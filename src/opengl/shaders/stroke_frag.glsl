@@ -0,0 +1,19 @@
+#ifdef CPP_GLSL_INCLUDE
+std::string stroke_frag = R"(
+#version 330 core
+
+layout (location = 0) out vec4 fragmentColor;
+
+in vec4 out_color;
+in vec2 round_coord;
+
+void main() {
+    // outside a round join or cap
+    if (dot(round_coord, round_coord) > 1.0) {
+        discard;
+    }
+    fragmentColor = out_color;
+}
+
+)";
+#endif
@@ -0,0 +1,198 @@
+#ifdef CPP_GLSL_INCLUDE
+std::string stroke_vert = R"(
+#version 330 core
+
+// expands one line segment of a stroke per instance. 36 vertices: the
+// segment's quad, the cap at its start and the join or cap at its end, 5
+// triangles each. triangles a piece does not need collapse to a point.
+
+uniform mat4 u_model_view;
+uniform mat4 u_projection;
+uniform vec4 u_color;
+
+uniform float u_half_width;
+uniform int   u_cap;  // VG_CAP_BUTT, VG_CAP_ROUND, VG_CAP_SQUARE from 0
+uniform int   u_join; // VG_JOIN_MITER, VG_JOIN_ROUND, VG_JOIN_BEVEL from 0
+uniform float u_miter_limit;
+
+// a neighbour equal to the end point it attaches to is a contour end
+layout (location = 0) in vec2 prev;
+layout (location = 1) in vec2 p0;
+layout (location = 2) in vec2 p1;
+layout (location = 3) in vec2 next;
+
+out vec4 out_color;
+out vec2 round_coord; // from the center of a round piece over the half width
+
+const int   CAP_BUTT   = 0;
+const int   CAP_ROUND  = 1;
+const int   JOIN_MITER = 0;
+const int   JOIN_ROUND = 1;
+const float PI         = 3.14159265;
+
+// joins bending less than this share their corners. See: kSmoothJoinError
+const float SMOOTH_JOIN_ERROR = 0.02;
+const float REVERSAL_EPSILON  = 1e-4;
+
+// a join or cap at p. the segments meeting there end and start at the
+// corners. the piece fills the outside of the turn with the triangles
+// (i, oa, p) (i, p, ob) (p, oa, x1) (p, x1, x2) (p, x2, ob).
+struct piece_t {
+    vec2 a_left, a_right; // corners of the segment ending at p
+    vec2 b_left, b_right; // corners of the segment starting at p
+    vec2 i, oa, ob, x1, x2;
+    bool rounded;
+};
+
+vec2 perp(vec2 v) { return vec2(-v.y, v.x); }
+
+vec2 rotate(vec2 v, float a) {
+    float c = cos(a);
+    float s = sin(a);
+    return vec2(v.x * c - v.y * s, v.x * s + v.y * c);
+}
+
+vec2 direction(vec2 from, vec2 to) {
+    vec2 d = to - from;
+    float len = length(d);
+    return len > 0.0 ? d / len : vec2(1.0, 0.0);
+}
+
+piece_t collapsed(vec2 p) {
+    return piece_t(p, p, p, p, p, p, p, p, p, false);
+}
+
+// the same as ITessellator::strokeJoin so both segments at a join agree
+piece_t join(vec2 p, vec2 da, float la, vec2 db, float lb) {
+    float hw       = u_half_width;
+    vec2  na       = perp(da);
+    vec2  nb       = perp(db);
+    float turn     = da.x * db.y - da.y * db.x;
+    float dot_     = dot(da, db);
+    float s        = turn > 0.0 ? -1.0 : 1.0; // outer side, 1 for left
+    bool  reversal = 1.0 + dot_ <= REVERSAL_EPSILON;
+
+    vec2  m         = reversal ? na : (na + nb) / (1.0 + dot_);
+    float miter_len = length(m);
+    bool  inner_ok  = !reversal && 2.0 * hw * abs(turn) <=
+                                       min(1.0, 1.0 + dot_) * min(la, lb);
+    bool  miter_ok  = !reversal && u_join == JOIN_MITER &&
+                     miter_len <= u_miter_limit;
+    bool  gentle    = !reversal && miter_len - 1.0 <= SMOOTH_JOIN_ERROR;
+
+    piece_t j = collapsed(p);
+    if (inner_ok && (miter_ok || gentle)) {
+        j.a_left  = j.b_left = p + m * hw;
+        j.a_right = j.b_right = p - m * hw;
+        return j;
+    }
+
+    vec2 ia = p - s * na * hw;
+    vec2 ib = p - s * nb * hw;
+    if (inner_ok) {
+        j.i = ia = ib = p - s * m * hw;
+    }
+    j.oa = p + s * na * hw;
+    j.ob = p + s * nb * hw;
+    j.a_left  = s > 0.0 ? j.oa : ia;
+    j.a_right = s > 0.0 ? ia : j.oa;
+    j.b_left  = s > 0.0 ? j.ob : ib;
+    j.b_right = s > 0.0 ? ib : j.ob;
+
+    if (miter_ok) {
+        j.x1 = j.x2 = p + s * m * hw;
+    } else if (u_join == JOIN_ROUND) {
+        // three wedges around the outside, towards da at a reversal. the
+        // first and last edges lie on the tangents at oa and ob
+        float a   = acos(clamp(dot_, -1.0, 1.0)) / 3.0;
+        float r   = hw / cos(a);
+        j.x1      = p + rotate(s * na, -s * a) * r;
+        j.x2      = p + rotate(s * na, -s * 2.0 * a) * r;
+        j.rounded = true;
+    } else {
+        j.x1 = j.x2 = j.oa; // bevel
+    }
+    return j;
+}
+
+// the cap at p pointing out along e
+piece_t cap(vec2 p, vec2 e) {
+    float hw = u_half_width;
+    vec2  n  = perp(e);
+
+    piece_t c = collapsed(p);
+    c.a_left  = c.b_right = p + n * hw;
+    c.a_right = c.b_left = p - n * hw;
+    if (u_cap == CAP_BUTT) {
+        return c;
+    }
+    c.oa = p + n * hw;
+    c.ob = p - n * hw;
+    if (u_cap == CAP_ROUND) {
+        float r   = hw / cos(PI / 3.0);
+        c.x1      = p + rotate(n, -PI / 3.0) * r;
+        c.x2      = p + rotate(n, -2.0 * PI / 3.0) * r;
+        c.rounded = true;
+    } else {
+        c.x1 = c.oa + e * hw;
+        c.x2 = c.ob + e * hw;
+    }
+    return c;
+}
+
+// the cap or the join at each end of the segment in direction d
+piece_t startPiece(vec2 d, float len) {
+    return prev == p0 ? cap(p0, -d)
+                      : join(p0, direction(prev, p0), length(p0 - prev), d,
+                             len);
+}
+
+piece_t endPiece(vec2 d, float len) {
+    return next == p1 ? cap(p1, d)
+                      : join(p1, d, len, direction(p1, next),
+                             length(next - p1));
+}
+
+void main() {
+    vec2  d     = direction(p0, p1);
+    float len   = length(p1 - p0);
+    int   v     = gl_VertexID;
+    vec2  pos   = p0;
+    round_coord = vec2(0.0);
+    if (v < 6) {
+        // the quad between the corners the segment starts and ends with
+        const int corner[6] = int[](0, 1, 2, 2, 1, 3);
+        int c = corner[v];
+        if (c < 2) {
+            piece_t start = startPiece(d, len);
+            pos = c == 0 ? start.b_left : start.b_right;
+        } else {
+            piece_t end = endPiece(d, len);
+            pos = c == 2 ? end.a_left : end.a_right;
+        }
+    } else if (v >= 21 || prev == p0) {
+        // joins at the start belong to the segment before
+        bool    at_end = v >= 21;
+        piece_t j      = at_end ? endPiece(d, len) : startPiece(d, len);
+        vec2    p      = at_end ? p1 : p0;
+        int     k      = v - (at_end ? 21 : 6);
+        const int index[15] = int[](0, 1, 5, 0, 5, 2, 5, 1, 3, 5, 3, 4,
+                                    5, 4, 2);
+        int i = index[k];
+        pos = i == 0 ? j.i
+            : i == 1 ? j.oa
+            : i == 2 ? j.ob
+            : i == 3 ? j.x1
+            : i == 4 ? j.x2
+                     : p;
+        if (j.rounded && k >= 6) {
+            round_coord = (pos - p) / u_half_width;
+        }
+    }
+
+    gl_Position = u_projection * u_model_view * vec4(pos, 1.0, 1.0);
+    out_color   = u_color;
+}
+
+)";
+#endif
@@ -0,0 +1,327 @@
+/**
+ * @file sweepTessellator.cpp
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Native single precision sweep-line tessellator implementation
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "sweepTessellator.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace MonkVG {
+
+namespace {
+// ear clipping is quadratic but cheaper per vertex than the sweep. on random
+// simple polygons it is faster below about 48 vertices.
+constexpr size_t kMaxEarClipVertices = 32;
+} // namespace
+
+SweepTessellator::SweepTessellator() : ITessellator() {}
+
+size_t SweepTessellator::maxEarClipVertices() const {
+    return kMaxEarClipVertices;
+}
+
+void SweepTessellator::tessellate(const flattened_path_t &path,
+                                  const VGFillRule        fill_rule,
+                                  std::vector<VGfloat>   &vertices,
+                                  bounding_box_t         &bounding_box) {
+    _out_vertices     = &vertices;
+    _out_bounding_box = &bounding_box;
+
+    buildEdges(path);
+    sweep(fill_rule);
+
+    _out_vertices     = nullptr;
+    _out_bounding_box = nullptr;
+}
+
+void SweepTessellator::tessellate(IPath *path, const uint32_t tess_iterations,
+                                  std::vector<VGfloat> &vertices,
+                                  bounding_box_t       &bounding_box) {
+    throw std::runtime_error("Not implemented");
+}
+
+void SweepTessellator::buildEdges(const flattened_path_t &path) {
+    _edges.clear();
+    _stops.clear();
+
+    for (const contour_t &contour : path.contours) {
+        // every contour is implicitly closed for filling
+        if (contour.count < 3) {
+            continue;
+        }
+        const vertex_2d_t *points = &path.points[contour.first];
+        for (uint32_t i = 0; i < contour.count; i++) {
+            const vertex_2d_t &p = points[i];
+            const vertex_2d_t &q = points[(i + 1) % contour.count];
+
+            // horizontal edges never change the winding of a slab
+            if (p.y == q.y) {
+                continue;
+            }
+
+            edge_t e;
+            if (p.y < q.y) {
+                e.x0      = p.x;
+                e.y0      = p.y;
+                e.x1      = q.x;
+                e.y1      = q.y;
+                e.winding = 1;
+            } else {
+                e.x0      = q.x;
+                e.y0      = q.y;
+                e.x1      = p.x;
+                e.y1      = p.y;
+                e.winding = -1;
+            }
+            e.dxdy = (e.x1 - e.x0) / (e.y1 - e.y0);
+            _edges.push_back(e);
+            _stops.push_back(e.y0);
+            _stops.push_back(e.y1);
+        }
+    }
+
+    std::sort(_edges.begin(), _edges.end(),
+              [](const edge_t &a, const edge_t &b) { return a.y0 < b.y0; });
+    std::sort(_stops.begin(), _stops.end());
+    _stops.erase(std::unique(_stops.begin(), _stops.end()), _stops.end());
+}
+
+void SweepTessellator::sweep(const VGFillRule fill_rule) {
+    _active.clear();
+    size_t next_edge = 0;
+
+    for (size_t s = 0; s + 1 < _stops.size(); s++) {
+        VGfloat       y     = _stops[s];
+        const VGfloat y_end = _stops[s + 1];
+
+        // retire the edges that ended and activate the ones starting here.
+        // edges start and end exactly on stops.
+        _active.erase(std::remove_if(_active.begin(), _active.end(),
+                                     [&](const uint32_t i) {
+                                         return _edges[i].y1 <= y;
+                                     }),
+                      _active.end());
+        while (next_edge < _edges.size() && _edges[next_edge].y0 <= y) {
+            _active.push_back((uint32_t)next_edge++);
+        }
+
+        // a stop interval is split into several slabs when edges cross
+        while (y < y_end) {
+            const size_t n = _active.size();
+            _x_bottom.resize(n);
+            _x_top.resize(n);
+
+            // insertion sort by x at the slab bottom, ties broken by the
+            // slope so the order is valid just above y. the order barely
+            // changes between slabs so this is close to linear.
+            for (size_t i = 0; i < n; i++) {
+                const uint32_t e  = _active[i];
+                const VGfloat  x  = _edges[e].xAt(y);
+                size_t         j  = i;
+                while (j > 0) {
+                    const edge_t &o  = _edges[_active[j - 1]];
+                    const VGfloat ox = _x_bottom[j - 1];
+                    if (ox < x || (ox == x && o.dxdy <= _edges[e].dxdy)) {
+                        break;
+                    }
+                    _active[j]   = _active[j - 1];
+                    _x_bottom[j] = ox;
+                    j--;
+                }
+                _active[j]   = e;
+                _x_bottom[j] = x;
+            }
+
+            // clip the slab at the first crossing of neighboring edges
+            VGfloat y_top = y_end;
+            for (size_t i = 0; i + 1 < n;) {
+                const VGfloat d0 = _x_bottom[i + 1] - _x_bottom[i];
+                const VGfloat d1 = _edges[_active[i + 1]].xAt(y_top) -
+                                   _edges[_active[i]].xAt(y_top);
+                if (d1 >= 0) {
+                    i++;
+                    continue;
+                }
+                const VGfloat yi = y + (y_top - y) * (d0 / (d0 - d1));
+                if (yi > y) {
+                    y_top = std::min(y_top, yi);
+                    i++;
+                } else {
+                    // crossing is below float precision of y. treat the
+                    // edges as already crossed and recheck the new left
+                    // neighbor pair.
+                    std::swap(_active[i], _active[i + 1]);
+                    _x_bottom[i + 1] = _x_bottom[i];
+                    i                = i > 0 ? i - 1 : 0;
+                }
+            }
+
+            for (size_t i = 0; i < n; i++) {
+                _x_top[i] = _edges[_active[i]].xAt(y_top);
+            }
+
+            updateRegions(y, fill_rule);
+            y = y_top;
+        }
+    }
+
+    // everything still growing ends at the last stop
+    for (const region_t &region : _regions) {
+        closeRegion(region, _stops.back());
+    }
+    _regions.clear();
+}
+
+void SweepTessellator::updateRegions(const VGfloat    y,
+                                     const VGFillRule fill_rule) {
+    auto same_x = [](const VGfloat a, const VGfloat b) {
+        return fabsf(a - b) <=
+               1e-5f * std::max(1.0f, std::max(fabsf(a), fabsf(b)));
+    };
+
+    _next_regions.clear();
+    size_t old = 0;
+
+    // walk the slab left to right tracking the winding number
+    int32_t winding = 0;
+    size_t  left    = 0;
+    for (size_t i = 0; i < _active.size(); i++) {
+        const bool was_inside =
+            fill_rule == VG_EVEN_ODD ? (winding & 1) != 0 : winding != 0;
+        winding += _edges[_active[i]].winding;
+        const bool is_inside =
+            fill_rule == VG_EVEN_ODD ? (winding & 1) != 0 : winding != 0;
+        if (!was_inside && is_inside) {
+            left = i;
+            continue;
+        }
+        if (!was_inside || is_inside) {
+            continue;
+        }
+
+        // an inside span [left, i]. regions entirely left of it are done.
+        const VGfloat lx = _x_bottom[left];
+        const VGfloat rx = _x_bottom[i];
+        while (old < _regions.size() && _regions[old].left_x < lx &&
+               !same_x(_regions[old].left_x, lx)) {
+            closeRegion(_regions[old++], y);
+        }
+
+        // the span continues a region if they share the same horizontal
+        // segment at y
+        if (old < _regions.size() && rx > lx &&
+            same_x(_regions[old].left_x, lx) &&
+            same_x(_regions[old].right_x, rx)) {
+            region_t region = _regions[old++];
+            if (region.left != _active[left]) {
+                addChainVertex(region, {lx, y, true});
+                region.left = _active[left];
+            }
+            if (region.right != _active[i]) {
+                addChainVertex(region, {rx, y, false});
+                region.right = _active[i];
+            }
+            region.left_x  = _x_top[left];
+            region.right_x = _x_top[i];
+            _next_regions.push_back(region);
+        } else {
+            region_t region =
+                openRegion(_active[left], _active[i], lx, rx, y);
+            region.left_x  = _x_top[left];
+            region.right_x = _x_top[i];
+            _next_regions.push_back(region);
+        }
+    }
+
+    while (old < _regions.size()) {
+        closeRegion(_regions[old++], y);
+    }
+    std::swap(_regions, _next_regions);
+}
+
+SweepTessellator::region_t
+SweepTessellator::openRegion(const uint32_t left, const uint32_t right,
+                             const VGfloat lx, const VGfloat rx,
+                             const VGfloat y) {
+    region_t region;
+    region.left  = left;
+    region.right = right;
+    if (_free_stacks.empty()) {
+        region.stack = (uint32_t)_stacks.size();
+        _stacks.emplace_back();
+    } else {
+        region.stack = _free_stacks.back();
+        _free_stacks.pop_back();
+    }
+
+    std::vector<chain_vertex_t> &stack = _stacks[region.stack];
+    stack.clear();
+    stack.push_back({lx, y, true});
+    if (rx > lx) {
+        stack.push_back({rx, y, false});
+    }
+    return region;
+}
+
+void SweepTessellator::closeRegion(const region_t &region, const VGfloat y) {
+    if (region.right_x > region.left_x) {
+        addChainVertex(region, {region.left_x, y, true});
+        addFinalVertex(region, {region.right_x, y, false});
+    } else {
+        addFinalVertex(region, {region.left_x, y, true});
+    }
+    _free_stacks.push_back(region.stack);
+}
+
+void SweepTessellator::addChainVertex(const region_t       &region,
+                                      const chain_vertex_t &v) {
+    std::vector<chain_vertex_t> &stack = _stacks[region.stack];
+
+    if (stack.back().left != v.left) {
+        // v is on the opposite chain so it sees every stacked vertex
+        addFinalVertex(region, v);
+        const chain_vertex_t top = stack.back();
+        stack.clear();
+        stack.push_back(top);
+        stack.push_back(v);
+        return;
+    }
+
+    // same chain. cut off triangles while the diagonal to v stays inside.
+    chain_vertex_t last = stack.back();
+    stack.pop_back();
+    while (!stack.empty()) {
+        const chain_vertex_t &a     = stack.back();
+        const VGfloat         cross = (v.x - a.x) * (last.y - a.y) -
+                              (v.y - a.y) * (last.x - a.x);
+        if (v.left ? cross <= 0 : cross >= 0) {
+            break;
+        }
+        addVertex(a.x, a.y);
+        addVertex(last.x, last.y);
+        addVertex(v.x, v.y);
+        last = a;
+        stack.pop_back();
+    }
+    stack.push_back(last);
+    stack.push_back(v);
+}
+
+void SweepTessellator::addFinalVertex(const region_t       &region,
+                                      const chain_vertex_t &v) {
+    const std::vector<chain_vertex_t> &stack = _stacks[region.stack];
+    for (size_t i = 0; i + 1 < stack.size(); i++) {
+        addVertex(stack[i].x, stack[i].y);
+        addVertex(stack[i + 1].x, stack[i + 1].y);
+        addVertex(v.x, v.y);
+    }
+}
+
+} // namespace MonkVG
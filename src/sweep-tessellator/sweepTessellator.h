@@ -0,0 +1,127 @@
+/**
+ * @file sweepTessellator.h
+ * @author Micah Pearlman (micahpearlman@gmail.com)
+ * @brief Native single precision sweep-line tessellator
+ * @version 0.1
+ * @date 2024-10-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __SWEEP_TESSELLATOR_H__
+#define __SWEEP_TESSELLATOR_H__
+#include "mkTessellator.h"
+#include <vector>
+#include <cstdint>
+namespace MonkVG {
+
+/**
+ * @brief Float only fill tessellator. The flattened path is swept bottom to
+ * top. Every vertex and every edge intersection starts a new horizontal slab.
+ * Inside a slab no edges cross, so the active edges sorted by x split the slab
+ * into spans, and the spans inside the path according to the fill rule are
+ * stacked across slabs into y-monotone regions. Each region is triangulated
+ * on the fly as its chain vertices arrive.
+ */
+class SweepTessellator : public ITessellator {
+  public:
+    SweepTessellator();
+    virtual ~SweepTessellator() = default;
+
+    using ITessellator::tessellate;
+
+    void tessellate(const flattened_path_t &path, const VGFillRule fill_rule,
+                    std::vector<VGfloat> &vertices,
+                    bounding_box_t       &bounding_box) override;
+
+    void tessellate(IPath *path, const uint32_t tess_iterations,
+                    std::vector<VGfloat> &vertices,
+                    bounding_box_t       &bounding_box) override;
+
+  protected:
+    size_t maxEarClipVertices() const override;
+
+  private:
+    /**
+     * @brief A non horizontal polygon edge oriented bottom (y0) to top (y1).
+     *
+     */
+    struct edge_t {
+        VGfloat x0, y0, x1, y1;
+        VGfloat dxdy;    // inverse slope
+        int32_t winding; // +1 if the contour goes up, -1 if it goes down
+
+        inline VGfloat xAt(const VGfloat y) const {
+            return y >= y1 ? x1 : x0 + (y - y0) * dxdy;
+        }
+    };
+
+    /**
+     * @brief A vertex on the left or right chain of a monotone region.
+     *
+     */
+    struct chain_vertex_t {
+        VGfloat x, y;
+        bool    left;
+    };
+
+    /**
+     * @brief A y-monotone region between two active edges that is still
+     * growing upwards.
+     *
+     */
+    struct region_t {
+        uint32_t left, right;     // boundary edges
+        VGfloat  left_x, right_x; // boundary x at the top of the last slab
+        uint32_t stack;           // triangulation stack. index into _stacks
+    };
+
+    /// @brief build the edge list from the flattened path
+    void buildEdges(const flattened_path_t &path);
+
+    /// @brief sweep the edges and emit the inside regions
+    void sweep(const VGFillRule fill_rule);
+
+    /// @brief match the inside spans of a slab against the growing regions
+    void updateRegions(const VGfloat y, const VGFillRule fill_rule);
+
+    /// @brief start a new region at the bottom of a slab
+    region_t openRegion(const uint32_t left, const uint32_t right,
+                        const VGfloat lx, const VGfloat rx, const VGfloat y);
+
+    /// @brief finish a region at y and emit its remaining triangles
+    void closeRegion(const region_t &region, const VGfloat y);
+
+    /// @brief add a chain vertex to a region emitting the triangles that
+    /// became visible. See: monotone polygon triangulation in "Computational
+    /// Geometry" de Berg et al.
+    void addChainVertex(const region_t &region, const chain_vertex_t &v);
+
+    /// @brief add the topmost vertex of a region. It sees the whole stack.
+    void addFinalVertex(const region_t &region, const chain_vertex_t &v);
+
+    inline void addVertex(const VGfloat x, const VGfloat y) {
+        _out_bounding_box->update(x, y);
+        _out_vertices->push_back(x);
+        _out_vertices->push_back(y);
+    }
+
+  private:
+    // scratch storage. kept around so re-tessellating does not allocate.
+    std::vector<edge_t>   _edges     = {};
+    std::vector<VGfloat>  _stops     = {}; // sorted unique edge end point ys
+    std::vector<uint32_t> _active    = {}; // active edges sorted by x
+    std::vector<VGfloat>  _x_bottom  = {}; // active edge x at slab bottom
+    std::vector<VGfloat>  _x_top     = {}; // active edge x at slab top
+    std::vector<region_t> _regions      = {}; // growing regions sorted by x
+    std::vector<region_t> _next_regions = {};
+    std::vector<std::vector<chain_vertex_t>> _stacks      = {};
+    std::vector<uint32_t>                    _free_stacks = {};
+
+    // output vertices and bounding box
+    std::vector<VGfloat> *_out_vertices     = nullptr;
+    bounding_box_t       *_out_bounding_box = nullptr;
+
+}; // SweepTessellator
+} // namespace MonkVG
+#endif // __SWEEP_TESSELLATOR_H__
@@ -31,6 +31,9 @@ bool VulkanContext::Initialize() {
 }
 
 bool VulkanContext::Terminate() {
+    // cached path buffers need the allocator
+    _tessellation_cache.clear();
+
     // destroy the pipelines
     _color_triangle_pipeline.reset();
     _color_tristrip_pipeline.reset();
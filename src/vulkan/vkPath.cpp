@@ -25,14 +25,24 @@ VulkanPath::VulkanPath(VGint pathFormat, VGPathDatatype datatype, VGfloat scale,
             coordCapacityHint, capabilities, context) {}
 
 VulkanPath::~VulkanPath() {
-    if (_fill_vertex_buffer != VK_NULL_HANDLE) {
-        vmaDestroyBuffer(getVulkanContext().getVulkanAllocator(),
-                         _fill_vertex_buffer, _fill_vertex_buffer_allocation);
+    // the buffers go with the last path drawing them
+}
+
+vk_fill_buffers_t::~vk_fill_buffers_t() {
+    if (vertex_buffer != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(allocator, vertex_buffer, vertex_allocation);
+    }
+    if (index_buffer != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(allocator, index_buffer, index_allocation);
+    }
+}
+
+vk_stroke_buffers_t::~vk_stroke_buffers_t() {
+    if (vertex_buffer != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(allocator, vertex_buffer, vertex_allocation);
     }
-    if (_stroke_vertex_buffer != VK_NULL_HANDLE) {
-        vmaDestroyBuffer(getVulkanContext().getVulkanAllocator(),
-                         _stroke_vertex_buffer,
-                         _stroke_vertex_buffer_allocation);
+    if (index_buffer != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(allocator, index_buffer, index_allocation);
     }
 }
 
@@ -46,8 +56,9 @@ bool VulkanPath::draw(VGbitfield paint_modes) {
         return false;
     }
 
-    if (paint_modes & VG_FILL_PATH) {
-        buildFillIfDirty();
+    buildForDraw(paint_modes);
+
+    if ((paint_modes & VG_FILL_PATH) && _fill_buffers) {
         // figure out the appropriate pipeline and bind it
         if (_fill_paint) {
             if (_fill_paint->getPaintType() == VG_PAINT_TYPE_COLOR) {
@@ -78,167 +89,278 @@ bool VulkanPath::draw(VGbitfield paint_modes) {
         }
 
         // bind the vertex buffer
-        VkBuffer     vertex_buffers[] = {_fill_vertex_buffer};
+        VkBuffer     vertex_buffers[] = {_fill_buffers->vertex_buffer};
         VkDeviceSize offsets[]        = {0};
         vkCmdBindVertexBuffers(getVulkanContext().getVulkanCommandBuffer(), 0,
                                1, vertex_buffers, offsets);
+        vkCmdBindIndexBuffer(getVulkanContext().getVulkanCommandBuffer(),
+                             _fill_buffers->index_buffer, 0,
+                             _fill_buffers->index_type);
 
         // draw the fill
-        vkCmdDraw(getVulkanContext().getVulkanCommandBuffer(),
-                  _fill_vertices.size() / 2, 1, 0, 0);
+        vkCmdDrawIndexed(getVulkanContext().getVulkanCommandBuffer(),
+                         _fill_buffers->index_count, 1, 0, 0, 0);
     }
 
-    if (paint_modes & VG_STROKE_PATH) {
-        buildStrokeIfDirty();
+    if ((paint_modes & VG_STROKE_PATH) && _stroke_buffers) {
         if (_stroke_paint) {
             if (_stroke_paint->getPaintType() == VG_PAINT_TYPE_COLOR) {
                 // get the color pipeline
-                getVulkanContext().getColorTriangleStripPipeline().setColor(
+                getVulkanContext().getColorTrianglePipeline().setColor(
                     _stroke_paint->getPaintColor());
-                getVulkanContext().getColorTriangleStripPipeline().bind();
+                getVulkanContext().getColorTrianglePipeline().bind();
             } else if (_stroke_paint->getPaintType() ==
                        VG_PAINT_TYPE_LINEAR_GRADIENT) {
                 // get the linear gradient pipeline
-                getVulkanContext().getTextureTriangleStripPipeline().bind();
+                getVulkanContext().getTextureTrianglePipeline().bind();
             } else if (_stroke_paint->getPaintType() ==
                        VG_PAINT_TYPE_RADIAL_GRADIENT) {
                 // get the radial gradient pipeline
-                getVulkanContext().getTextureTriangleStripPipeline().bind();
+                getVulkanContext().getTextureTrianglePipeline().bind();
             } else if (_stroke_paint->getPaintType() == VG_PAINT_TYPE_PATTERN) {
                 // get the pattern pipeline
-                getVulkanContext().getTextureTriangleStripPipeline().bind();
+                getVulkanContext().getTextureTrianglePipeline().bind();
             } else {
                 // error
                 // HACK: we are just going to bind the color pipeline
-                getVulkanContext().getColorTriangleStripPipeline().bind();
+                getVulkanContext().getColorTrianglePipeline().bind();
             }
         } else {
             // DELETE THIS
             // HACK: we are just going to bind the color pipeline
-            getVulkanContext().getColorTriangleStripPipeline().bind();
+            getVulkanContext().getColorTrianglePipeline().bind();
         }
 
         // bind the vertex buffer
-        VkBuffer     vertex_buffers[] = {_stroke_vertex_buffer};
+        VkBuffer     vertex_buffers[] = {_stroke_buffers->vertex_buffer};
         VkDeviceSize offsets[]        = {0};
         vkCmdBindVertexBuffers(getVulkanContext().getVulkanCommandBuffer(), 0,
                                1, vertex_buffers, offsets);
+        vkCmdBindIndexBuffer(getVulkanContext().getVulkanCommandBuffer(),
+                             _stroke_buffers->index_buffer, 0,
+                             _stroke_buffers->index_type);
 
         // draw the stroke
-        vkCmdDraw(getVulkanContext().getVulkanCommandBuffer(),
-                  _stroke_vertices.size(), 1, 0, 0);
+        vkCmdDrawIndexed(getVulkanContext().getVulkanCommandBuffer(),
+                         _stroke_buffers->index_count, 1, 0, 0, 0);
     }
 
     return true;
 }
 
-void VulkanPath::clear(VGbitfield caps) {}
+void VulkanPath::clear(VGbitfield caps) {
+    IPath::clear(caps);
 
-void VulkanPath::buildFillIfDirty() {
-    IPaint *current_fill_paint = getContext().getFillPaint();
+    // async paths keep drawing the old buffers until the rebuild arrives
+    if (!getContext().getTessellationAsync()) {
+        _fill_buffers   = nullptr;
+        _stroke_buffers = nullptr;
+    }
+}
 
+bool VulkanPath::updateFillPaint() {
     // TODO: do not necessarily need to rebuild the fill if the paint only
     // changed color
-    if (current_fill_paint != _fill_paint) {
-        _fill_paint = (VulkanPaint *)current_fill_paint;
-        setFillDirty(true);
-    }
-    // only build the fill if dirty or we are in batch build mode
-    if (getIsFillDirty() || getContext().currentBatch()) {
-        _fill_vertices.clear();
-        // tessellate the path
-        getContext().getTessellator().tessellate(
-            _segments, _fcoords, getContext().getFillRule(),
-            getContext().getTessellationIterations(), _fill_vertices, _bounds);            
-
-        // DEBUG: uncomment to draw a triangle
-        // also may want to comment out the MVP matrix multiplication in the
-        // vertex shader
-        // _fill_vertices.clear(); _fill_vertices = {0.0, -0.5,
-        // 0.5, 0.5, -0.5, 0.5};
-        if (_fill_vertex_buffer != VK_NULL_HANDLE) {
-            vmaDestroyBuffer(getVulkanContext().getVulkanAllocator(),
-                             _fill_vertex_buffer,
-                             _fill_vertex_buffer_allocation);
-            _fill_vertex_buffer              = VK_NULL_HANDLE;
-            _fill_vertex_buffer_allocation   = VK_NULL_HANDLE;
+    IPaint *current_fill_paint = getContext().getFillPaint();
+    if (current_fill_paint == _fill_paint) {
+        return false;
+    }
+    _fill_paint = (VulkanPaint *)current_fill_paint;
+    return true;
+}
+
+bool VulkanPath::updateStrokePaint() {
+    IPaint *current_stroke_paint = getContext().getStrokePaint();
+    if (current_stroke_paint == _stroke_paint) {
+        return false;
+    }
+    _stroke_paint = (VulkanPaint *)current_stroke_paint;
+    return true;
+}
+
+void VulkanPath::buildBuffers(VGbitfield paint_modes) {
+    if (_upload_modes & VG_FILL_PATH) {
+        // cached geometry may already be uploaded by another path
+        std::shared_ptr<vk_fill_buffers_t> buffers = nullptr;
+        if (_fill_entry) {
+            buffers = std::static_pointer_cast<vk_fill_buffers_t>(
+                _fill_entry->gpu_buffers);
         }
 
-        // create the vertex buffer
-        VkBufferCreateInfo buffer_info = {};
-        buffer_info.sType              = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        buffer_info.size               = _fill_vertices.size() * sizeof(float);
-        buffer_info.usage              = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+        // growing fills only upload what was appended
+        const indexed_mesh_t &mesh = getFillMesh();
+        if (!buffers && _fill_growing && _fill_buffers &&
+            appendFillBuffers(*_fill_buffers, mesh)) {
+            buffers = _fill_buffers;
+        }
+        if (!buffers && !mesh.indices.empty()) {
+            buffers = createFillBuffers(mesh);
+            if (_fill_entry) {
+                _fill_entry->gpu_buffers = buffers;
+            }
+        }
+        _fill_buffers = std::move(buffers); // releases the old buffers
+        // editing fills are kept to modify but uploaded whole, as frames in
+        // flight may still read their buffers
+        if (_fill_growing) {
+            // kept to append to
+            _fill_uploaded_vertices = mesh.vertexCount();
+            _fill_uploaded_indices  = (uint32_t)mesh.indices.size();
+        } else if (!_fill_editing) {
+            _fill_mesh.clear();
+        }
+        _fill_entry = nullptr;
+    }
 
-        VmaAllocationCreateInfo alloc_info = {};
-        alloc_info.usage                   = VMA_MEMORY_USAGE_CPU_TO_GPU;
+    if (_upload_modes & VG_STROKE_PATH) {
+        std::shared_ptr<vk_stroke_buffers_t> buffers = nullptr;
+        if (_stroke_entry) {
+            buffers = std::static_pointer_cast<vk_stroke_buffers_t>(
+                _stroke_entry->gpu_buffers);
+        }
 
-        if (vmaCreateBuffer(getVulkanContext().getVulkanAllocator(),
-                            &buffer_info, &alloc_info, &_fill_vertex_buffer,
-                            &_fill_vertex_buffer_allocation,
-                            nullptr) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create vertex buffer");
+        const indexed_mesh_t &mesh = getStrokeMesh();
+        if (!buffers && !mesh.indices.empty()) {
+            buffers = createStrokeBuffers(mesh);
+            if (_stroke_entry) {
+                _stroke_entry->gpu_buffers = buffers;
+            }
+        }
+        _stroke_buffers = std::move(buffers);
+        // strokes that change width are kept to rescale. See:
+        // IPath::rescaleStroke()
+        if (!_stroke_scaling) {
+            _stroke_mesh.clear();
         }
+        _stroke_entry = nullptr;
+    }
+    _upload_modes = 0;
+}
+
+std::shared_ptr<vk_fill_buffers_t>
+VulkanPath::createFillBuffers(const indexed_mesh_t &mesh) {
+    auto buffers       = std::make_shared<vk_fill_buffers_t>();
+    buffers->allocator = getVulkanContext().getVulkanAllocator();
+
+    // growing fills get twice the room they need so appends are amortized
+    const VkDeviceSize room = _fill_growing ? 2 : 1;
 
-        // copy the vertex data to the buffer
-        void *data;
-        vmaMapMemory(getVulkanContext().getVulkanAllocator(),
-                     _fill_vertex_buffer_allocation, &data);
-        memcpy(data, _fill_vertices.data(),
-               _fill_vertices.size() * sizeof(float));
-        vmaUnmapMemory(getVulkanContext().getVulkanAllocator(),
-                       _fill_vertex_buffer_allocation);
+    const VkDeviceSize vertex_size = mesh.vertices.size() * sizeof(float);
+    buffers->vertex_capacity       = vertex_size * room;
+    createBuffer(mesh.vertices.data(), vertex_size, buffers->vertex_capacity,
+                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, buffers->vertex_buffer,
+                 buffers->vertex_allocation);
+    if (mesh.fitsIndex16()) {
+        mesh.packIndices16(_indices16);
+        const VkDeviceSize index_size =
+            _indices16.size() * sizeof(uint16_t);
+        buffers->index_capacity = index_size * room;
+        createBuffer(_indices16.data(), index_size,
+                     buffers->index_capacity, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                     buffers->index_buffer, buffers->index_allocation);
+        buffers->index_type = VK_INDEX_TYPE_UINT16;
+        _indices16.clear();
+    } else {
+        const VkDeviceSize index_size = mesh.indices.size() * sizeof(uint32_t);
+        buffers->index_capacity       = index_size * room;
+        createBuffer(mesh.indices.data(), index_size, buffers->index_capacity,
+                     VK_BUFFER_USAGE_INDEX_BUFFER_BIT, buffers->index_buffer,
+                     buffers->index_allocation);
+        buffers->index_type = VK_INDEX_TYPE_UINT32;
     }
-    setFillDirty(false);
+    buffers->index_count = (uint32_t)mesh.indices.size();
+    return buffers;
 }
 
-void VulkanPath::buildStrokeIfDirty() {
-    IPaint *current_stroke_paint = getContext().getStrokePaint();
-    if (current_stroke_paint != _stroke_paint) {
-        _stroke_paint = (VulkanPaint *)current_stroke_paint;
-        setStrokeDirty(true);
-    }
-    // only build the stroke if dirty or we are in batch build mode
-    if (getIsStrokeDirty() || getContext().currentBatch()) {
-        _stroke_vertices.clear();
-        getContext().getTessellator().buildStroke(
-            _segments, _fcoords, getContext().getStrokeLineWidth(),
-            getContext().getTessellationIterations(), _stroke_vertices);
-
-        if (_stroke_vertex_buffer != VK_NULL_HANDLE) {
-            vmaDestroyBuffer(getVulkanContext().getVulkanAllocator(),
-                             _stroke_vertex_buffer,
-                             _stroke_vertex_buffer_allocation);
-            _stroke_vertex_buffer            = VK_NULL_HANDLE;
-            _stroke_vertex_buffer_allocation = VK_NULL_HANDLE;
-        }
+bool VulkanPath::appendFillBuffers(vk_fill_buffers_t    &buffers,
+                                   const indexed_mesh_t &mesh) {
+    const bool   index16    = buffers.index_type == VK_INDEX_TYPE_UINT16;
+    const size_t index_size = index16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    if (_fill_uploaded_indices == 0 || (index16 && !mesh.fitsIndex16()) ||
+        mesh.vertices.size() * sizeof(float) > buffers.vertex_capacity ||
+        mesh.indices.size() * index_size > buffers.index_capacity) {
+        return false;
+    }
 
-        // create the vertex buffer
-        VkBufferCreateInfo buffer_info = {};
-        buffer_info.sType              = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        buffer_info.size               = _stroke_vertices.size() * sizeof(vertex_2d_t);
-        buffer_info.usage              = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    // only past the end of what frames in flight read
+    const size_t first_vertex = (size_t)_fill_uploaded_vertices * 2;
+    writeBuffer(buffers.vertex_allocation, first_vertex * sizeof(float),
+                mesh.vertices.data() + first_vertex,
+                (mesh.vertices.size() - first_vertex) * sizeof(float));
 
-        VmaAllocationCreateInfo alloc_info = {};
-        alloc_info.usage                   = VMA_MEMORY_USAGE_CPU_TO_GPU;
+    const size_t first_index = _fill_uploaded_indices;
+    const size_t count       = mesh.indices.size() - first_index;
+    if (index16) {
+        _indices16.assign(mesh.indices.begin() + first_index,
+                               mesh.indices.end());
+        writeBuffer(buffers.index_allocation, first_index * index_size,
+                    _indices16.data(), count * index_size);
+        _indices16.clear();
+    } else {
+        writeBuffer(buffers.index_allocation, first_index * index_size,
+                    mesh.indices.data() + first_index, count * index_size);
+    }
 
-        if (vmaCreateBuffer(getVulkanContext().getVulkanAllocator(),
-                            &buffer_info, &alloc_info, &_stroke_vertex_buffer,
-                            &_stroke_vertex_buffer_allocation,
-                            nullptr) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create vertex buffer");
-        }
+    buffers.index_count = (uint32_t)mesh.indices.size();
+    return true;
+}
+
+std::shared_ptr<vk_stroke_buffers_t>
+VulkanPath::createStrokeBuffers(const indexed_mesh_t &mesh) {
+    auto buffers       = std::make_shared<vk_stroke_buffers_t>();
+    buffers->allocator = getVulkanContext().getVulkanAllocator();
+
+    const VkDeviceSize vertex_size = mesh.vertices.size() * sizeof(float);
+    createBuffer(mesh.vertices.data(), vertex_size, vertex_size,
+                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, buffers->vertex_buffer,
+                 buffers->vertex_allocation);
+    if (mesh.fitsIndex16()) {
+        mesh.packIndices16(_indices16);
+        const VkDeviceSize index_size = _indices16.size() * sizeof(uint16_t);
+        createBuffer(_indices16.data(), index_size, index_size,
+                     VK_BUFFER_USAGE_INDEX_BUFFER_BIT, buffers->index_buffer,
+                     buffers->index_allocation);
+        buffers->index_type = VK_INDEX_TYPE_UINT16;
+        _indices16.clear();
+    } else {
+        const VkDeviceSize index_size = mesh.indices.size() * sizeof(uint32_t);
+        createBuffer(mesh.indices.data(), index_size, index_size,
+                     VK_BUFFER_USAGE_INDEX_BUFFER_BIT, buffers->index_buffer,
+                     buffers->index_allocation);
+        buffers->index_type = VK_INDEX_TYPE_UINT32;
+    }
+    buffers->index_count = (uint32_t)mesh.indices.size();
+    return buffers;
+}
+
+void VulkanPath::createBuffer(const void *data, VkDeviceSize size,
+                              VkDeviceSize       capacity,
+                              VkBufferUsageFlags usage, VkBuffer &buffer,
+                              VmaAllocation &allocation) {
+    VkBufferCreateInfo buffer_info = {};
+    buffer_info.sType              = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.size               = capacity;
+    buffer_info.usage              = usage;
+
+    VmaAllocationCreateInfo alloc_info = {};
+    alloc_info.usage                   = VMA_MEMORY_USAGE_CPU_TO_GPU;
 
-        // copy the vertex data to the buffer
-        void *data;
-        vmaMapMemory(getVulkanContext().getVulkanAllocator(),
-                     _stroke_vertex_buffer_allocation, &data);
-        memcpy(data, _stroke_vertices.data(),
-                _stroke_vertices.size() * sizeof(vertex_2d_t));
-        vmaUnmapMemory(getVulkanContext().getVulkanAllocator(),
-                       _stroke_vertex_buffer_allocation);
+    if (vmaCreateBuffer(getVulkanContext().getVulkanAllocator(), &buffer_info,
+                        &alloc_info, &buffer, &allocation,
+                        nullptr) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create buffer");
     }
-    setStrokeDirty(false);
+
+    // copy the data to the buffer
+    writeBuffer(allocation, 0, data, size);
+}
+
+void VulkanPath::writeBuffer(VmaAllocation allocation, VkDeviceSize offset,
+                             const void *data, VkDeviceSize size) {
+    void *mapped;
+    vmaMapMemory(getVulkanContext().getVulkanAllocator(), allocation, &mapped);
+    memcpy((uint8_t *)mapped + offset, data, size);
+    vmaUnmapMemory(getVulkanContext().getVulkanAllocator(), allocation);
 }
 
-} // namespace MonkVG
\ No newline at end of file
+} // namespace MonkVG
@@ -11,11 +11,48 @@
 #ifndef __VK_PATH_H__
 #define __VK_PATH_H__
 #include "mkPath.h"
+#include "mkTessellator.h"
 #include "vkPaint.h"
 #include <vk_mem_alloc.h>
 
 namespace MonkVG {
 class VulkanContext;
+
+/**
+ * @brief The vertex and index buffers of a fill. Shared through the
+ * tessellation cache by the paths with the same fill geometry.
+ */
+struct vk_fill_buffers_t : public gpu_buffers_t {
+    VmaAllocator  allocator         = VK_NULL_HANDLE;
+    VkBuffer      vertex_buffer     = VK_NULL_HANDLE;
+    VkBuffer      index_buffer      = VK_NULL_HANDLE;
+    VmaAllocation vertex_allocation = VK_NULL_HANDLE;
+    VmaAllocation index_allocation  = VK_NULL_HANDLE;
+    uint32_t      index_count       = 0;
+    VkIndexType   index_type        = VK_INDEX_TYPE_UINT16;
+
+    // allocated bytes. growing paths leave room to append to.
+    VkDeviceSize vertex_capacity = 0;
+    VkDeviceSize index_capacity  = 0;
+
+    ~vk_fill_buffers_t() override;
+};
+
+/**
+ * @brief The vertex and index buffers of a stroke. See: vk_fill_buffers_t
+ */
+struct vk_stroke_buffers_t : public gpu_buffers_t {
+    VmaAllocator  allocator         = VK_NULL_HANDLE;
+    VkBuffer      vertex_buffer     = VK_NULL_HANDLE;
+    VkBuffer      index_buffer      = VK_NULL_HANDLE;
+    VmaAllocation vertex_allocation = VK_NULL_HANDLE;
+    VmaAllocation index_allocation  = VK_NULL_HANDLE;
+    uint32_t      index_count       = 0;
+    VkIndexType   index_type        = VK_INDEX_TYPE_UINT16;
+
+    ~vk_stroke_buffers_t() override;
+};
+
 class VulkanPath : public IPath {
   public:
     VulkanPath(VGint pathFormat, VGPathDatatype datatype, VGfloat scale,
@@ -25,24 +62,45 @@ class VulkanPath : public IPath {
 
     bool draw(VGbitfield paintModes) override;
     void clear(VGbitfield caps) override;
-    void buildFillIfDirty() override;
-    void buildStrokeIfDirty() override;
+    void buildBuffers(VGbitfield paintModes) override;
+
+  protected:
+    bool updateFillPaint() override;
+    bool updateStrokePaint() override;
 
   private:
     VulkanContext &getVulkanContext();
 
   private:
-    std::vector<float>       _fill_vertices   = {};
-    std::vector<vertex_2d_t> _stroke_vertices = {};
+    std::vector<uint16_t> _indices16 = {}; // 16 bit upload scratch
 
     VulkanPaint *_fill_paint   = nullptr;
     VulkanPaint *_stroke_paint = nullptr;
 
   private:
-    VkBuffer      _fill_vertex_buffer              = VK_NULL_HANDLE;
-    VkBuffer      _stroke_vertex_buffer            = VK_NULL_HANDLE;
-    VmaAllocation _fill_vertex_buffer_allocation   = VK_NULL_HANDLE;
-    VmaAllocation _stroke_vertex_buffer_allocation = VK_NULL_HANDLE;
+    std::shared_ptr<vk_fill_buffers_t>   _fill_buffers   = nullptr;
+    std::shared_ptr<vk_stroke_buffers_t> _stroke_buffers = nullptr;
+
+    std::shared_ptr<vk_fill_buffers_t>
+    createFillBuffers(const indexed_mesh_t &mesh);
+
+    /// @brief copy the part of a growing fill past _fill_uploaded_vertices
+    /// and _fill_uploaded_indices into the free room of buffers. Returns
+    /// false if it does not fit.
+    bool appendFillBuffers(vk_fill_buffers_t    &buffers,
+                           const indexed_mesh_t &mesh);
+    std::shared_ptr<vk_stroke_buffers_t>
+    createStrokeBuffers(const indexed_mesh_t &mesh);
+
+    /// @brief create a host visible buffer of capacity bytes and copy size
+    /// bytes of data into it
+    void createBuffer(const void *data, VkDeviceSize size,
+                      VkDeviceSize capacity, VkBufferUsageFlags usage,
+                      VkBuffer &buffer, VmaAllocation &allocation);
+
+    /// @brief copy data into a host visible buffer at offset
+    void writeBuffer(VmaAllocation allocation, VkDeviceSize offset,
+                     const void *data, VkDeviceSize size);
 
 }; // VulkanPath
 
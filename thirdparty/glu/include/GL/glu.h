@@ -38,6 +38,7 @@
 #else
 #include <GL/gl.h>
 #endif 
+#include <stddef.h>
 
 #ifndef GLAPIENTRY
 #if defined(_MSC_VER) || defined(__MINGW32__)
@@ -345,6 +346,16 @@ GLAPI void GLAPIENTRY gluTessEndPolygon (GLUtesselator* tess);
 GLAPI void GLAPIENTRY gluTessNormal (GLUtesselator* tess, GLdouble valueX, GLdouble valueY, GLdouble valueZ);
 GLAPI void GLAPIENTRY gluTessProperty (GLUtesselator* tess, GLenum which, GLdouble data);
 GLAPI void GLAPIENTRY gluTessVertex (GLUtesselator* tess, GLdouble *location, GLvoid* data);
+
+/* MonkVG extension: route the tessellator's internal allocations on the
+ * calling thread through user supplied functions. Passing NULL functions
+ * restores malloc/realloc/free. Memory must be freed with the same
+ * allocator it was allocated with.
+ */
+typedef void* (GLAPIENTRYP _GLUtessAllocFunc) (void* user, size_t size);
+typedef void* (GLAPIENTRYP _GLUtessReallocFunc) (void* user, void* ptr, size_t size);
+typedef void (GLAPIENTRYP _GLUtessFreeFunc) (void* user, void* ptr);
+GLAPI void GLAPIENTRY gluTessAllocator (_GLUtessAllocFunc allocFunc, _GLUtessReallocFunc reallocFunc, _GLUtessFreeFunc freeFunc, void* user);
 GLAPI GLint GLAPIENTRY gluUnProject (GLdouble winX, GLdouble winY, GLdouble winZ, const GLdouble *model, const GLdouble *proj, const GLint *view, GLdouble* objX, GLdouble* objY, GLdouble* objZ);
 GLAPI GLint GLAPIENTRY gluUnProject4 (GLdouble winX, GLdouble winY, GLdouble winZ, GLdouble clipW, const GLdouble *model, const GLdouble *proj, const GLint *view, GLdouble nearVal, GLdouble farVal, GLdouble* objX, GLdouble* objY, GLdouble* objZ, GLdouble* objW);
 
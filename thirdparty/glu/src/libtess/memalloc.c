@@ -32,9 +32,40 @@
 **
 */
 
+#include "gluos.h"
+#include <GL/glu.h>
 #include "memalloc.h"
 #include "string.h"
 
+#if defined(_MSC_VER)
+#define TESS_THREAD_LOCAL __declspec(thread)
+#else
+#define TESS_THREAD_LOCAL __thread
+#endif
+
+/* allocator installed on this thread. NULL functions mean malloc/free. */
+static TESS_THREAD_LOCAL _GLUtessAllocFunc   allocFunc   = NULL;
+static TESS_THREAD_LOCAL _GLUtessReallocFunc reallocFunc = NULL;
+static TESS_THREAD_LOCAL _GLUtessFreeFunc    freeFunc    = NULL;
+static TESS_THREAD_LOCAL void               *allocUser   = NULL;
+
+void GLAPIENTRY
+gluTessAllocator( _GLUtessAllocFunc alloc, _GLUtessReallocFunc realloc_,
+                  _GLUtessFreeFunc free_, void *user )
+{
+  if (alloc == NULL || realloc_ == NULL || free_ == NULL) {
+    allocFunc = NULL;
+    reallocFunc = NULL;
+    freeFunc = NULL;
+    allocUser = NULL;
+    return;
+  }
+  allocFunc = alloc;
+  reallocFunc = realloc_;
+  freeFunc = free_;
+  allocUser = user;
+}
+
 int __gl_memInit( size_t maxFast )
 {
 #ifndef NO_MALLOPT
@@ -46,10 +77,27 @@ int __gl_memInit( size_t maxFast )
    return 1;
 }
 
-#ifdef MEMORY_DEBUG
 void *__gl_memAlloc( size_t n )
 {
-  return memset( malloc( n ), 0xa5, n );
-}
+  void *p = allocFunc != NULL ? (*allocFunc)( allocUser, n ) : malloc( n );
+#ifdef MEMORY_DEBUG
+  if (p != NULL) memset( p, 0xa5, n );
 #endif
+  return p;
+}
+
+void *__gl_memRealloc( void *p, size_t n )
+{
+  return reallocFunc != NULL ? (*reallocFunc)( allocUser, p, n )
+                             : realloc( p, n );
+}
+
+void __gl_memFree( void *p )
+{
+  if (freeFunc != NULL) {
+    (*freeFunc)( allocUser, p );
+  } else {
+    free( p );
+  }
+}
 
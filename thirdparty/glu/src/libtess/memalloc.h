@@ -37,18 +37,18 @@
 
 #include <stdlib.h>
 
-#define memRealloc	realloc
-#define memFree		free
+/* all allocations go through the allocator installed on the calling
+ * thread by gluTessAllocator(), malloc/realloc/free by default.
+ */
+#define memRealloc	__gl_memRealloc
+#define memFree		__gl_memFree
+#define memAlloc	__gl_memAlloc
+extern void *		__gl_memAlloc( size_t );
+extern void *		__gl_memRealloc( void *, size_t );
+extern void		__gl_memFree( void * );
 
 #define memInit		__gl_memInit
 /*extern void		__gl_memInit( size_t );*/
 extern int		__gl_memInit( size_t );
 
-#ifndef MEMORY_DEBUG
-#define memAlloc	malloc
-#else
-#define memAlloc	__gl_memAlloc
-extern void *		__gl_memAlloc( size_t );
-#endif
-
 #endif